@@ -0,0 +1,352 @@
+#include "LoadGenerator.h"
+#include "web/WsProtocol.h"
+#include <ixwebsocket/IXHttpClient.h>
+#include <ixwebsocket/IXNetSystem.h>
+#include <ixwebsocket/IXWebSocket.h>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <unordered_map>
+
+namespace photon {
+
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+LatencySummary summarize(std::vector<double> samples) {
+    LatencySummary s;
+    if (samples.empty()) return s;
+    std::sort(samples.begin(), samples.end());
+    s.count = samples.size();
+    s.meanMs = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+    s.p50Ms = percentile(samples, 0.50);
+    s.p90Ms = percentile(samples, 0.90);
+    s.p99Ms = percentile(samples, 0.99);
+    s.maxMs = samples.back();
+    return s;
+}
+
+double msSince(Clock::time_point t, Clock::time_point now) {
+    return std::chrono::duration<double, std::milli>(now - t).count();
+}
+
+void putU16(std::string& out, uint16_t v) {
+    out.push_back(static_cast<char>(v & 0xFF));
+    out.push_back(static_cast<char>(v >> 8));
+}
+
+} // namespace
+
+struct LoadGenerator::WsClient {
+    ix::WebSocket ws;
+    std::thread driver;
+    std::mt19937 rng;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool open{false};
+
+    // Written by the driver, read after it stops
+    uint64_t sent{0};
+    uint64_t sendFailures{0};
+
+    // Written by the ixwebsocket thread under `mutex`
+    uint64_t disconnects{0};
+    uint64_t frames{0};
+    std::unordered_map<uint32_t, Clock::time_point> inFlight;
+    std::vector<double> ackLatencies;
+};
+
+struct LoadGenerator::RestPoller {
+    ix::HttpClient http;
+    std::thread driver;
+    uint64_t requests{0};
+    uint64_t notModified{0};
+    uint64_t errors{0};
+    uint64_t bytes{0};
+    std::vector<double> latencies;
+};
+
+LoadGenerator::LoadGenerator(LoadOptions options)
+    : options_(std::move(options)),
+      baseUrl_("http://" + options_.host + ":" + std::to_string(options_.port)) {}
+
+LoadGenerator::~LoadGenerator() {
+    stop();
+}
+
+bool LoadGenerator::fetchConfig() {
+    ix::HttpClient http;
+    auto args = http.createRequest();
+    args->connectTimeout = 2;
+    auto res = http.get(baseUrl_ + "/api/config", args);
+    if (res->statusCode != 200) {
+        spdlog::error("Load: no photon at {} ({})", baseUrl_,
+                      res->errorMsg.empty() ? std::to_string(res->statusCode) : res->errorMsg);
+        return false;
+    }
+    if (options_.universeCount == 0) {
+        try {
+            options_.universeCount = json::parse(res->body).at("universeCount").get<uint16_t>();
+        } catch (const std::exception& e) {
+            spdlog::error("Load: unexpected /api/config answer: {}", e.what());
+            return false;
+        }
+    }
+    return options_.universeCount > 0;
+}
+
+bool LoadGenerator::start() {
+    ix::initNetSystem();
+    if (!fetchConfig()) return false;
+
+    auto deadline = Clock::now() + std::chrono::seconds(5);
+    for (int i = 0; i < options_.wsClients; ++i) {
+        auto client = std::make_unique<WsClient>();
+        auto* c = client.get();
+        c->rng.seed(static_cast<uint32_t>(i + 1));
+        c->ws.setUrl("ws://" + options_.host + ":" + std::to_string(options_.port) + "/ws");
+        c->ws.disableAutomaticReconnection();
+        c->ws.setOnMessageCallback([this, c](const ix::WebSocketMessagePtr& msg) {
+            auto now = Clock::now();
+            if (msg->type == ix::WebSocketMessageType::Open) {
+                std::lock_guard lock(c->mutex);
+                c->open = true;
+                c->cv.notify_all();
+                return;
+            }
+            if (msg->type == ix::WebSocketMessageType::Close ||
+                msg->type == ix::WebSocketMessageType::Error) {
+                std::lock_guard lock(c->mutex);
+                if (c->open && running_.load()) ++c->disconnects;
+                c->open = false;
+                return;
+            }
+            if (msg->type != ix::WebSocketMessageType::Message) return;
+            if (msg->binary) {
+                std::lock_guard lock(c->mutex);
+                ++c->frames;
+                return;
+            }
+            // Control messages are short; DMX state frames are not worth parsing
+            if (msg->str.size() > 80) {
+                std::lock_guard lock(c->mutex);
+                ++c->frames;
+                return;
+            }
+            auto m = json::parse(msg->str, nullptr, false);
+            if (m.is_discarded()) return;
+            auto type = m.value("type", "");
+            if (type == "ping") {
+                // Unanswered pings make the server throttle this client
+                c->ws.send(R"({"type":"pong","id":)" + std::to_string(m.value("id", 0u)) + "}");
+            } else if (type == "ack") {
+                // Acks are cumulative: everything up to seq was applied
+                auto seq = m.value("seq", 0u);
+                std::lock_guard lock(c->mutex);
+                for (auto it = c->inFlight.begin(); it != c->inFlight.end();) {
+                    if (it->first <= seq) {
+                        c->ackLatencies.push_back(msSince(it->second, now));
+                        it = c->inFlight.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            } else if (type == "dmx_state") {
+                std::lock_guard lock(c->mutex);
+                ++c->frames;
+            }
+        });
+        c->ws.start();
+        clients_.push_back(std::move(client));
+    }
+
+    for (auto& client : clients_) {
+        std::unique_lock lock(client->mutex);
+        if (!client->cv.wait_until(lock, deadline, [&] { return client->open; })) {
+            spdlog::error("Load: WebSocket client could not connect to {}", baseUrl_);
+            lock.unlock();
+            stop();
+            return false;
+        }
+    }
+    for (auto& client : clients_) {
+        if (options_.wsMode == WsLoadMode::Batch) client->ws.send(R"({"type":"hello","protocol":"binary"})");
+        if (options_.subscribe) client->ws.send(R"({"type":"subscribe","universes":"all"})");
+    }
+    for (int i = 0; i < options_.restPollers; ++i) pollers_.push_back(std::make_unique<RestPoller>());
+    return true;
+}
+
+void LoadGenerator::driveWs(WsClient& client) {
+    if (options_.wsRate <= 0) return;
+    auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / options_.wsRate));
+    // Spread the clients' sends over one period instead of bursting together
+    auto next = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+        period * std::uniform_real_distribution<double>(0.0, 1.0)(client.rng));
+    std::uniform_int_distribution<int> universeDist(0, options_.universeCount - 1);
+    std::uniform_int_distribution<int> channelDist(0, 511);
+    int count = std::clamp(options_.channelsPerMessage, 1, 512);
+    uint32_t seq = 0;
+    uint8_t value = 0;
+
+    while (running_.load() && next < endAt_) {
+        std::this_thread::sleep_until(next);
+        next += period;
+        auto universe = static_cast<uint16_t>(universeDist(client.rng));
+        ++value;
+
+        ix::WebSocketSendInfo info;
+        if (options_.wsMode == WsLoadMode::Channel) {
+            info = client.ws.send(R"({"type":"set_channel","universe":)" + std::to_string(universe) +
+                                  R"(,"channel":)" + std::to_string(channelDist(client.rng)) +
+                                  R"(,"value":)" + std::to_string(value) + "}");
+        } else if (options_.wsMode == WsLoadMode::Channels) {
+            std::string msg = R"({"type":"set_channels","universe":)" + std::to_string(universe) + R"(,"channels":[)";
+            for (int i = 0; i < count; ++i) {
+                if (i) msg += ',';
+                msg += '[' + std::to_string(channelDist(client.rng)) + ',' + std::to_string(value) + ']';
+            }
+            msg += "]}";
+            info = client.ws.send(msg);
+        } else {
+            std::string msg(wsproto::HEADER_SIZE, '\0');
+            wsproto::writeHeader(reinterpret_cast<uint8_t*>(msg.data()),
+                                 {wsproto::MessageType::CommandBatch, 0, 0, ++seq});
+            msg.push_back(static_cast<char>(wsproto::BatchOp::Sparse));
+            putU16(msg, universe);
+            putU16(msg, static_cast<uint16_t>(count));
+            for (int i = 0; i < count; ++i) {
+                putU16(msg, static_cast<uint16_t>(channelDist(client.rng)));
+                msg.push_back(static_cast<char>(value));
+            }
+            {
+                std::lock_guard lock(client.mutex);
+                client.inFlight[seq] = Clock::now();
+            }
+            info = client.ws.sendBinary(msg);
+        }
+        if (info.success) {
+            ++client.sent;
+        } else {
+            ++client.sendFailures;
+            if (options_.wsMode == WsLoadMode::Batch) {
+                std::lock_guard lock(client.mutex);
+                client.inFlight.erase(seq);
+            }
+        }
+    }
+}
+
+void LoadGenerator::drivePoller(RestPoller& poller) {
+    if (options_.restRate <= 0) return;
+    auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / options_.restRate));
+    auto next = Clock::now();
+    std::string since;
+    auto args = poller.http.createRequest();
+    args->connectTimeout = 2;
+    args->transferTimeout = 5;
+
+    while (running_.load() && next < endAt_) {
+        std::this_thread::sleep_until(next);
+        next += period;
+
+        auto t0 = Clock::now();
+        auto res = poller.http.get(baseUrl_ + "/api/universes" + (since.empty() ? "" : "?since=" + since), args);
+        poller.latencies.push_back(msSince(t0, Clock::now()));
+        ++poller.requests;
+
+        if (res->statusCode == 304) {
+            ++poller.notModified;
+        } else if (res->statusCode >= 200 && res->statusCode < 300) {
+            poller.bytes += res->body.size();
+            if (options_.restSince) {
+                auto it = res->headers.find("X-Photon-Version");
+                if (it != res->headers.end()) since = it->second;
+            }
+        } else {
+            ++poller.errors;
+        }
+    }
+}
+
+LoadReport LoadGenerator::run() {
+    LoadReport report;
+    report.universeCount = options_.universeCount;
+    if (clients_.empty() && pollers_.empty()) return report;
+
+    running_ = true;
+    auto t0 = Clock::now();
+    endAt_ = t0 + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options_.durationSec));
+    for (auto& client : clients_) client->driver = std::thread([this, c = client.get()] { driveWs(*c); });
+    for (auto& poller : pollers_) poller->driver = std::thread([this, p = poller.get()] { drivePoller(*p); });
+
+    for (auto& client : clients_) client->driver.join();
+    for (auto& poller : pollers_) poller->driver.join();
+    report.elapsedSec = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    // Acks still on the way get a moment before they count as dropped
+    if (options_.wsMode == WsLoadMode::Batch) std::this_thread::sleep_for(std::chrono::seconds(1));
+    running_ = false;
+
+    std::vector<double> ackLatencies;
+    for (auto& client : clients_) {
+        std::lock_guard lock(client->mutex);
+        report.ws.sent += client->sent;
+        report.ws.sendFailures += client->sendFailures;
+        report.ws.disconnects += client->disconnects;
+        report.ws.framesReceived += client->frames;
+        report.ws.unacked += client->inFlight.size();
+        ackLatencies.insert(ackLatencies.end(), client->ackLatencies.begin(), client->ackLatencies.end());
+    }
+    report.ws.targetRate = options_.wsRate * static_cast<double>(clients_.size());
+    report.ws.achievedRate = static_cast<double>(report.ws.sent) / options_.durationSec;
+    report.ws.acked = ackLatencies.size();
+    report.ws.ackLatency = summarize(std::move(ackLatencies));
+    if (!clients_.empty()) {
+        report.ws.framesPerClientPerSec = static_cast<double>(report.ws.framesReceived) /
+                                          static_cast<double>(clients_.size()) / options_.durationSec;
+    }
+
+    std::vector<double> restLatencies;
+    for (auto& poller : pollers_) {
+        report.rest.requests += poller->requests;
+        report.rest.notModified += poller->notModified;
+        report.rest.errors += poller->errors;
+        report.rest.bytes += poller->bytes;
+        restLatencies.insert(restLatencies.end(), poller->latencies.begin(), poller->latencies.end());
+    }
+    report.rest.targetRate = options_.restRate * static_cast<double>(pollers_.size());
+    report.rest.achievedRate = static_cast<double>(report.rest.requests) / options_.durationSec;
+    report.rest.latency = summarize(std::move(restLatencies));
+    return report;
+}
+
+void LoadGenerator::stop() {
+    running_ = false;
+    for (auto& client : clients_) {
+        if (client->driver.joinable()) client->driver.join();
+        client->ws.stop();
+    }
+    for (auto& poller : pollers_) {
+        if (poller->driver.joinable()) poller->driver.join();
+    }
+    clients_.clear();
+    pollers_.clear();
+}
+
+} // namespace photon
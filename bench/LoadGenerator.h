@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace photon {
+
+enum class WsLoadMode : uint8_t {
+    Channel,   // {"type":"set_channel"} per write
+    Channels,  // {"type":"set_channels"} with --channels writes
+    Batch,     // binary CommandBatch with --channels writes, acknowledged by the server
+};
+
+struct LoadOptions {
+    std::string host = "127.0.0.1";
+    uint16_t port = 9090;
+    uint16_t universeCount = 0;  // 0: ask the server
+    double durationSec = 10.0;
+
+    int wsClients = 4;
+    double wsRate = 30.0;        // messages per second per client
+    WsLoadMode wsMode = WsLoadMode::Channel;
+    int channelsPerMessage = 8;
+    bool subscribe = true;       // clients subscribe to every universe, like the UI
+
+    int restPollers = 1;
+    double restRate = 10.0;      // requests per second per poller
+    bool restSince = true;       // poll with ?since=<last version>
+};
+
+struct LatencySummary {
+    uint64_t count{0};
+    double meanMs{0};
+    double p50Ms{0};
+    double p90Ms{0};
+    double p99Ms{0};
+    double maxMs{0};
+};
+
+struct LoadReport {
+    double elapsedSec{0};
+    uint16_t universeCount{0};
+
+    struct Ws {
+        uint64_t sent{0};
+        double targetRate{0};      // messages/s across all clients
+        double achievedRate{0};
+        uint64_t sendFailures{0};
+        uint64_t disconnects{0};
+        uint64_t acked{0};         // batch mode
+        uint64_t unacked{0};       // batch mode: never acknowledged (dropped)
+        LatencySummary ackLatency; // batch mode: send to ack
+        uint64_t framesReceived{0};
+        double framesPerClientPerSec{0};
+    } ws;
+
+    struct Rest {
+        uint64_t requests{0};
+        double targetRate{0};
+        double achievedRate{0};
+        uint64_t notModified{0};
+        uint64_t errors{0};        // transport failures and non-2xx/304 answers
+        uint64_t bytes{0};
+        LatencySummary latency;
+    } rest;
+};
+
+// Drives a running photon instance with synthetic operators: WebSocket
+// clients sending channel writes at a fixed rate and REST pollers reading
+// /api/universes. Everything runs open-loop on its own schedule, so a server
+// that falls behind shows up as missed rates, rising latency or drops rather
+// than as a slower generator.
+class LoadGenerator {
+public:
+    explicit LoadGenerator(LoadOptions options);
+    ~LoadGenerator();
+
+    // Connects every client; false if the server cannot be reached
+    bool start();
+    LoadReport run();
+    void stop();
+
+private:
+    struct WsClient;
+    struct RestPoller;
+
+    bool fetchConfig();
+    void driveWs(WsClient& client);
+    void drivePoller(RestPoller& poller);
+
+    LoadOptions options_;
+    std::string baseUrl_;
+    std::vector<std::unique_ptr<WsClient>> clients_;
+    std::vector<std::unique_ptr<RestPoller>> pollers_;
+    std::atomic<bool> running_{false};
+    std::chrono::steady_clock::time_point endAt_;
+};
+
+} // namespace photon
@@ -0,0 +1,318 @@
+#include "LoopbackHarness.h"
+#include <ixwebsocket/IXHttpClient.h>
+#include <ixwebsocket/IXNetSystem.h>
+#include <ixwebsocket/IXWebSocket.h>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <numeric>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace photon {
+
+using json = nlohmann::json;
+
+namespace {
+
+constexpr size_t ARTNET_HEADER = 18;
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+void closeSocket(int fd) {
+#ifdef _WIN32
+    closesocket(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+} // namespace
+
+struct LoopbackHarness::InputClient {
+    ix::WebSocket ws;
+    ix::HttpClient http;
+    std::string baseUrl;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool open{false};
+};
+
+LoopbackHarness::LoopbackHarness(HarnessOptions options)
+    : options_(std::move(options)) {}
+
+LoopbackHarness::~LoopbackHarness() {
+    stop();
+}
+
+bool LoopbackHarness::start() {
+    if (running_.load()) return true;
+    ix::initNetSystem();
+
+    if (!openCapture()) return false;
+
+    pending_.assign(options_.universeCount, {});
+    lastValue_.assign(options_.universeCount, 0);
+    lastFrame_.assign(options_.universeCount, {});
+    universeStats_.assign(options_.universeCount, {});
+
+    running_ = true;
+    captureThread_ = std::thread([this] { captureLoop(); });
+
+    Config config;
+    config.webPort = options_.webPort;
+    config.universeCount = options_.universeCount;
+    config.artnetTargetIp = "127.0.0.1";
+    config.artnetPort = capturePort_;
+    config.udpBackend = options_.udpBackend;
+    config.outputHz = options_.outputHz;
+    app_.start(config);
+
+    if (!connectInput()) {
+        spdlog::error("Harness: web server on port {} did not come up", options_.webPort);
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void LoopbackHarness::stop() {
+    if (input_) {
+        input_->ws.stop();
+        input_.reset();
+    }
+    app_.stop();
+
+    if (running_.exchange(false) && captureThread_.joinable()) captureThread_.join();
+    if (captureSocket_ >= 0) {
+        closeSocket(captureSocket_);
+        captureSocket_ = -1;
+    }
+}
+
+bool LoopbackHarness::openCapture() {
+    captureSocket_ = static_cast<int>(::socket(AF_INET, SOCK_DGRAM, 0));
+    if (captureSocket_ < 0) {
+        spdlog::error("Harness: failed to create capture socket");
+        return false;
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    if (::bind(captureSocket_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        spdlog::error("Harness: failed to bind capture socket");
+        return false;
+    }
+    socklen_t len = sizeof(addr);
+    ::getsockname(captureSocket_, reinterpret_cast<sockaddr*>(&addr), &len);
+    capturePort_ = ntohs(addr.sin_port);
+
+    // Short timeout so the capture thread notices stop()
+#ifdef _WIN32
+    DWORD timeout = 100;
+#else
+    timeval timeout{0, 100'000};
+#endif
+    setsockopt(captureSocket_, SOL_SOCKET, SO_RCVTIMEO,
+               reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+    int rcvbuf = 4 * 1024 * 1024;
+    setsockopt(captureSocket_, SOL_SOCKET, SO_RCVBUF,
+               reinterpret_cast<const char*>(&rcvbuf), sizeof(rcvbuf));
+    return true;
+}
+
+bool LoopbackHarness::connectInput() {
+    input_ = std::make_unique<InputClient>();
+    input_->baseUrl = "http://127.0.0.1:" + std::to_string(options_.webPort);
+    auto deadline = Clock::now() + std::chrono::seconds(5);
+
+    if (options_.input == HarnessInput::Rest) {
+        auto args = input_->http.createRequest();
+        args->connectTimeout = 1;
+        while (Clock::now() < deadline) {
+            auto res = input_->http.get(input_->baseUrl + "/api/config", args);
+            if (res->statusCode == 200) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        return false;
+    }
+
+    auto* client = input_.get();
+    client->ws.setUrl("ws://127.0.0.1:" + std::to_string(options_.webPort) + "/ws");
+    client->ws.setMinWaitBetweenReconnectionRetries(50);
+    client->ws.setMaxWaitBetweenReconnectionRetries(200);
+    client->ws.setOnMessageCallback([client](const ix::WebSocketMessagePtr& msg) {
+        // Broadcast frames from the server are ignored; only track the connection
+        if (msg->type == ix::WebSocketMessageType::Open) {
+            std::lock_guard lock(client->mutex);
+            client->open = true;
+            client->cv.notify_all();
+        } else if (msg->type == ix::WebSocketMessageType::Close) {
+            std::lock_guard lock(client->mutex);
+            client->open = false;
+        }
+    });
+    client->ws.start();
+
+    std::unique_lock lock(client->mutex);
+    return client->cv.wait_until(lock, deadline, [client] { return client->open; });
+}
+
+bool LoopbackHarness::sendProbe(uint16_t universe, uint8_t value) {
+    if (options_.input == HarnessInput::Rest) {
+        auto args = input_->http.createRequest();
+        args->extraHeaders["Content-Type"] = "application/json";
+        auto url = input_->baseUrl + "/api/universes/" + std::to_string(universe) +
+                   "/channels/" + std::to_string(options_.probeChannel);
+        auto res = input_->http.put(url, json{{"value", value}}.dump(), args);
+        return res->statusCode == 200;
+    }
+
+    json msg;
+    msg["type"] = "set_channel";
+    msg["universe"] = universe;
+    msg["channel"] = options_.probeChannel;
+    msg["value"] = value;
+    return input_->ws.send(msg.dump()).success;
+}
+
+HarnessReport LoopbackHarness::run() {
+    HarnessReport report;
+    if (!running_.load() || options_.inputRate <= 0) return report;
+
+    // Let the output scheduler settle before scoring
+    std::this_thread::sleep_for(std::chrono::duration<double>(options_.warmupSec));
+    {
+        std::lock_guard lock(mutex_);
+        for (auto& q : pending_) q.clear();
+        std::fill(universeStats_.begin(), universeStats_.end(), UniverseReport{});
+        std::fill(lastFrame_.begin(), lastFrame_.end(), Clock::time_point{});
+        latenciesMs_.clear();
+        matched_ = 0;
+        coalesced_ = 0;
+    }
+    scoring_ = true;
+
+    auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / options_.inputRate));
+    auto t0 = Clock::now();
+    auto end = t0 + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(options_.durationSec));
+    auto next = t0;
+
+    for (uint64_t seq = 0; Clock::now() < end; ++seq) {
+        auto universe = static_cast<uint16_t>(seq % options_.universeCount);
+        // Values cycle 1..255 per universe so consecutive probes always differ
+        auto value = static_cast<uint8_t>(1 + (seq / options_.universeCount) % 255);
+        {
+            std::lock_guard lock(mutex_);
+            pending_[universe].push_back({value, Clock::now()});
+        }
+        if (sendProbe(universe, value)) {
+            ++report.sent;
+        } else {
+            // Keep the input rate even when the input is unreachable
+            std::lock_guard lock(mutex_);
+            pending_[universe].pop_back();
+        }
+
+        next += period;
+        std::this_thread::sleep_until(next);
+    }
+
+    // Give the last probes a few output ticks to reach the wire
+    auto drain = std::max(std::chrono::duration<double>(0.25),
+                          std::chrono::duration<double>(4.0 / options_.outputHz));
+    std::this_thread::sleep_for(drain);
+    scoring_ = false;
+    double windowSec = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    std::lock_guard lock(mutex_);
+    report.matched = matched_;
+    report.coalesced = coalesced_;
+    for (const auto& q : pending_) report.lost += q.size();
+
+    std::vector<double> sorted = latenciesMs_;
+    std::sort(sorted.begin(), sorted.end());
+    if (!sorted.empty()) {
+        report.meanMs = std::accumulate(sorted.begin(), sorted.end(), 0.0) /
+                        static_cast<double>(sorted.size());
+        report.maxMs = sorted.back();
+    }
+    report.p50Ms = percentile(sorted, 0.50);
+    report.p90Ms = percentile(sorted, 0.90);
+    report.p99Ms = percentile(sorted, 0.99);
+
+    for (uint16_t u = 0; u < options_.universeCount; ++u) {
+        UniverseReport uni = universeStats_[u];
+        uni.universe = u;
+        uni.fps = static_cast<double>(uni.frames) / windowSec;
+        report.universes.push_back(uni);
+    }
+    return report;
+}
+
+void LoopbackHarness::captureLoop() {
+    uint8_t buf[1500];
+    while (running_.load()) {
+        auto n = ::recv(captureSocket_, reinterpret_cast<char*>(buf), sizeof(buf), 0);
+        if (n <= 0) continue;
+        onPacket(buf, static_cast<size_t>(n), Clock::now());
+    }
+}
+
+void LoopbackHarness::onPacket(const uint8_t* packet, size_t size, Clock::time_point at) {
+    // ArtDmx only: "Art-Net\0", OpCode 0x5000 little-endian
+    if (size < ARTNET_HEADER + options_.probeChannel + 1) return;
+    if (std::memcmp(packet, "Art-Net\0", 8) != 0 || packet[8] != 0x00 || packet[9] != 0x50) return;
+
+    auto universe = static_cast<uint16_t>(packet[14] | (packet[15] << 8));
+    if (universe >= options_.universeCount) return;
+    uint8_t value = packet[ARTNET_HEADER + options_.probeChannel];
+
+    std::lock_guard lock(mutex_);
+    if (scoring_.load()) {
+        auto& stats = universeStats_[universe];
+        ++stats.frames;
+        if (lastFrame_[universe] != Clock::time_point{}) {
+            double gapMs = std::chrono::duration<double, std::milli>(at - lastFrame_[universe]).count();
+            stats.maxGapMs = std::max(stats.maxGapMs, gapMs);
+        }
+        lastFrame_[universe] = at;
+    }
+
+    if (value == lastValue_[universe]) return;
+    lastValue_[universe] = value;
+
+    // Probes queued ahead of the one on the wire were overwritten in the
+    // merge buffer before an output tick picked them up
+    auto& queue = pending_[universe];
+    auto it = std::find_if(queue.begin(), queue.end(),
+                           [value](const Probe& p) { return p.value == value; });
+    if (it == queue.end()) return;
+
+    coalesced_ += static_cast<uint64_t>(it - queue.begin());
+    latenciesMs_.push_back(std::chrono::duration<double, std::milli>(at - it->sentAt).count());
+    ++matched_;
+    queue.erase(queue.begin(), it + 1);
+}
+
+} // namespace photon
@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "application/Application.h"
+
+namespace photon {
+
+enum class HarnessInput : uint8_t {
+    WebSocket,  // set_channel messages over /ws
+    Rest,       // PUT /api/universes/<u>/channels/<ch>
+};
+
+struct HarnessOptions {
+    uint16_t webPort = 19090;
+    uint16_t universeCount = 4;
+    double outputHz = 44.0;
+    std::string udpBackend = "socket";
+    HarnessInput input = HarnessInput::WebSocket;
+    double inputRate = 100.0;    // probe messages per second, spread across universes
+    double durationSec = 5.0;
+    double warmupSec = 0.5;      // output is captured but not scored during warmup
+    uint16_t probeChannel = 0;   // channel that carries the probe sequence
+};
+
+struct UniverseReport {
+    uint16_t universe{0};
+    uint64_t frames{0};
+    double fps{0};
+    double maxGapMs{0};          // longest interval between two output frames
+};
+
+struct HarnessReport {
+    uint64_t sent{0};
+    uint64_t matched{0};         // probes seen on the wire
+    uint64_t coalesced{0};       // overwritten by a later probe before the next tick
+    uint64_t lost{0};
+    double meanMs{0};
+    double p50Ms{0};
+    double p90Ms{0};
+    double p99Ms{0};
+    double maxMs{0};
+    std::vector<UniverseReport> universes;
+};
+
+// Runs a full Application in-process on loopback: input is driven through the
+// real web server, Art-Net output is captured on a local UDP socket, and every
+// probe value is matched against the first output frame that carries it. The
+// measured latency covers the complete input → InputCoalescer → engineLoop →
+// MergeBuffer → OutputScheduler → UDP path.
+class LoopbackHarness {
+public:
+    explicit LoopbackHarness(HarnessOptions options);
+    ~LoopbackHarness();
+
+    bool start();
+    HarnessReport run();
+    void stop();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Probe {
+        uint8_t value;
+        Clock::time_point sentAt;
+    };
+
+    bool openCapture();
+    bool connectInput();
+    bool sendProbe(uint16_t universe, uint8_t value);
+    void captureLoop();
+    void onPacket(const uint8_t* packet, size_t size, Clock::time_point at);
+
+    HarnessOptions options_;
+    Application app_;
+
+    int captureSocket_{-1};
+    uint16_t capturePort_{0};
+    std::thread captureThread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> scoring_{false};
+
+    struct InputClient;
+    std::unique_ptr<InputClient> input_;
+
+    // Shared between the input driver and the capture thread
+    std::mutex mutex_;
+    std::vector<std::deque<Probe>> pending_;
+    std::vector<uint8_t> lastValue_;
+    std::vector<Clock::time_point> lastFrame_;
+    std::vector<UniverseReport> universeStats_;
+    std::vector<double> latenciesMs_;
+    uint64_t matched_{0};
+    uint64_t coalesced_{0};
+};
+
+} // namespace photon
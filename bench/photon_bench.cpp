@@ -0,0 +1,216 @@
+// Micro-benchmarks for the per-tick hot paths, each at 4, 64 and 1024
+// universes. Results come out through Catch2's reporters, so a run can be
+// saved and diffed against another build:
+//
+//   ./bench/photon_bench --reporter JSON::out=bench.json
+//   ./bench/photon_bench "[engine]" --benchmark-samples 200
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include "engine/Action.h"
+#include "engine/InputCoalescer.h"
+#include "engine/MergeBuffer.h"
+#include "engine/Universe.h"
+#include "pixel/PixelMapper.h"
+#include "protocol/ArtNetSender.h"
+#include "protocol/DeviceManager.h"
+#include "web/WsProtocol.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace photon;
+
+namespace {
+
+std::string label(const char* what, uint16_t universes) {
+    return std::string(what) + " [" + std::to_string(universes) + " universes]";
+}
+
+std::array<uint8_t, 512> pattern(uint16_t seed) {
+    std::array<uint8_t, 512> data{};
+    for (size_t c = 0; c < data.size(); ++c) data[c] = static_cast<uint8_t>(c * 7 + seed);
+    return data;
+}
+
+// A show-like universe: a full background look with a few programmer overrides
+void fillRig(MergeBuffer& buffer) {
+    for (uint16_t u = 0; u < buffer.getUniverseCount(); ++u) {
+        auto data = pattern(u);
+        buffer.setValues(u, 0, data.data(), 512, SourcePriority::Background);
+        buffer.setValues(u, 0, data.data(), 48, SourcePriority::Programmer);
+    }
+}
+
+class NullDevice : public OutputDevice {
+public:
+    bool open() override { return true; }
+    void close() override {}
+    bool isOpen() const override { return true; }
+    void send(uint16_t, const std::array<uint8_t, 512>&) override {}
+    std::string getTypeName() const override { return "Null"; }
+    std::string getDescription() const override { return "Null"; }
+};
+
+// 1024 writes spread over the rig, as a fader-heavy input burst would be
+std::vector<Action> inputBurst(uint16_t universes) {
+    std::vector<Action> actions;
+    for (uint16_t i = 0; i < 1024; ++i) {
+        actions.push_back(action::SetChannel{static_cast<uint16_t>(i % universes),
+                                             static_cast<uint16_t>((i * 7) % 512),
+                                             static_cast<uint8_t>(i), SourcePriority::Programmer});
+    }
+    return actions;
+}
+
+} // namespace
+
+TEST_CASE("Universe output merge", "[bench][engine]") {
+    auto universes = GENERATE(as<uint16_t>{}, 4, 64, 1024);
+    std::vector<Universe> rig(universes);
+    for (uint16_t u = 0; u < universes; ++u) {
+        auto data = pattern(u);
+        rig[u].setValues(0, data.data(), 512, SourcePriority::Background);
+        rig[u].setValues(0, data.data(), 48, SourcePriority::Programmer);
+    }
+
+    BENCHMARK(label("Universe::getOutput", universes)) {
+        unsigned sum = 0;
+        for (const auto& u : rig) sum += u.getOutput()[511];
+        return sum;
+    };
+}
+
+TEST_CASE("MergeBuffer reader/writer contention", "[bench][engine]") {
+    auto universes = GENERATE(as<uint16_t>{}, 4, 64, 1024);
+    MergeBuffer buffer(universes);
+    fillRig(buffer);
+    std::vector<std::array<uint8_t, 512>> frames;
+    auto data = pattern(1);
+
+    BENCHMARK(label("MergeBuffer::tryGetOutputs", universes)) {
+        return buffer.tryGetOutputs(frames);
+    };
+
+    std::atomic<bool> stop{false};
+    {
+        // The engine thread applying input while the output thread snapshots
+        std::thread writer([&] {
+            uint16_t u = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                buffer.setValues(u, 0, data.data(), 64, SourcePriority::Programmer);
+                u = static_cast<uint16_t>((u + 1) % universes);
+            }
+        });
+        BENCHMARK(label("MergeBuffer::getOutput all universes vs writer", universes)) {
+            unsigned sum = 0;
+            std::array<uint8_t, 512> out{};
+            for (uint16_t u = 0; u < universes; ++u) sum += buffer.getOutput(u, out) & 1;
+            return sum;
+        };
+        stop.store(true);
+        writer.join();
+    }
+
+    stop.store(false);
+    {
+        std::thread reader([&] {
+            std::vector<std::array<uint8_t, 512>> snapshot;
+            while (!stop.load(std::memory_order_relaxed)) buffer.tryGetOutputs(snapshot);
+        });
+        BENCHMARK(label("MergeBuffer::setValues vs snapshot reader", universes)) {
+            buffer.setValues(static_cast<uint16_t>(universes - 1), 0, data.data(), 64,
+                             SourcePriority::Programmer);
+        };
+        stop.store(true);
+        reader.join();
+    }
+}
+
+TEST_CASE("Input queue throughput", "[bench][engine]") {
+    auto universes = GENERATE(as<uint16_t>{}, 4, 64, 1024);
+    auto actions = inputBurst(universes);
+
+    InputCoalescer coalescer(universes);
+    CoalescedBatch batch;
+    BENCHMARK(label("InputCoalescer push+drain 1024 writes", universes)) {
+        for (const auto& a : actions) coalescer.push(a);
+        coalescer.drain(batch);
+        return batch.values.size();
+    };
+
+    MergeBuffer buffer(universes);
+    for (const auto& a : actions) coalescer.push(a);
+    coalescer.drain(batch);
+    BENCHMARK(label("MergeBuffer::apply 1024-write batch", universes)) {
+        buffer.apply(batch);
+    };
+}
+
+TEST_CASE("Art-Net packet build", "[bench][protocol]") {
+    auto universes = GENERATE(as<uint16_t>{}, 4, 64, 1024);
+    ArtNetSender sender("127.0.0.1");
+    std::vector<std::array<uint8_t, 512>> frames(universes, pattern(3));
+    std::array<uint8_t, ArtNetSender::PACKET_SIZE> packet{};
+
+    BENCHMARK(label("ArtNetSender::buildPacket per tick", universes)) {
+        for (uint16_t u = 0; u < universes; ++u) sender.buildPacket(u, frames[u], packet.data());
+        return packet[12];
+    };
+}
+
+TEST_CASE("Device lookup", "[bench][protocol]") {
+    auto universes = GENERATE(as<uint16_t>{}, 4, 64, 1024);
+    DeviceManager devices;
+    for (uint16_t u = 0; u < universes; ++u) devices.addDevice(std::make_shared<NullDevice>(), u);
+
+    BENCHMARK(label("DeviceManager::getDevicesForUniverse per tick", universes)) {
+        size_t found = 0;
+        for (uint16_t u = 0; u < universes; ++u) found += devices.getDevicesForUniverse(u).size();
+        return found;
+    };
+}
+
+TEST_CASE("Pixel map render", "[bench][pixel]") {
+    auto universes = GENERATE(as<uint16_t>{}, 4, 64, 1024);
+    // A wall of one 170-pixel row per universe, the densest RGB cabling
+    std::vector<uint8_t> frame(size_t{170} * universes * 4);
+    for (size_t i = 0; i < frame.size(); ++i) frame[i] = static_cast<uint8_t>(i * 13);
+    MergeBuffer buffer(universes);
+
+    for (auto order : {ColorOrder::GRB, ColorOrder::GRBW}) {
+        auto perUniverse = static_cast<uint32_t>(512 / pixelmap::channelsPerPixel(order));
+        std::vector<PixelStrip> strips;
+        for (uint16_t u = 0; u < universes; ++u) strips.push_back({0, u, 1, 0, perUniverse, u, 0, order});
+        PixelMap map;
+        map.compile(170, universes, strips, universes);
+        PixelMapper mapper(buffer);
+        mapper.setMap(std::move(map));
+
+        BENCHMARK(label(order == ColorOrder::GRB ? "PixelMapper::render RGB->GRB" : "PixelMapper::render RGBA->GRBW",
+                        universes)) {
+            return mapper.render(frame.data(), 170, universes,
+                                 order == ColorOrder::GRB ? PixelFormat::RGB : PixelFormat::RGBA);
+        };
+    }
+}
+
+TEST_CASE("WebSocket frame serialization", "[bench][web]") {
+    auto universes = GENERATE(as<uint16_t>{}, 4, 64, 1024);
+    std::vector<std::array<uint8_t, 512>> frames(universes, pattern(5));
+
+    // What the broadcaster does each tick for universes with JSON subscribers
+    BENCHMARK(label("wsproto::encodeDmxStateJson per tick", universes)) {
+        size_t bytes = 0;
+        for (uint16_t u = 0; u < universes; ++u) bytes += wsproto::encodeDmxStateJson(u, frames[u].data()).size();
+        return bytes;
+    };
+
+    BENCHMARK(label("wsproto::encodeDmxState per tick", universes)) {
+        size_t bytes = 0;
+        for (uint16_t u = 0; u < universes; ++u) bytes += wsproto::encodeDmxState(u, 1, frames[u].data()).size();
+        return bytes;
+    };
+}
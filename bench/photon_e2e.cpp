@@ -0,0 +1,97 @@
+// Loopback end-to-end harness: runs the engine in-process, drives input over
+// WebSocket or REST and reports input-to-wire latency and per-universe frame
+// rate. Non-zero exit when a --max-p99-ms / --min-fps budget is missed, so it
+// can gate CI.
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <spdlog/spdlog.h>
+#include "LoopbackHarness.h"
+
+using namespace photon;
+
+static void usage() {
+    std::cout << "Usage: photon_e2e [options]\n\n"
+              << "Options:\n"
+              << "  --port N            Web port for the in-process engine (default: 19090)\n"
+              << "  --universes N       Number of universes (default: 4)\n"
+              << "  --output-hz HZ      Output refresh rate (default: 44)\n"
+              << "  --udp-backend NAME  socket or io_uring (default: socket)\n"
+              << "  --input ws|rest     Input path (default: ws)\n"
+              << "  --rate N            Probe messages per second (default: 100)\n"
+              << "  --duration SEC      Measurement duration (default: 5)\n"
+              << "  --max-p99-ms MS     Fail if p99 latency exceeds MS\n"
+              << "  --min-fps FPS       Fail if any universe falls below FPS\n"
+              << "  --verbose           Keep engine logging\n";
+}
+
+int main(int argc, char* argv[]) {
+    HarnessOptions options;
+    double maxP99Ms = 0;
+    double minFps = 0;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            usage();
+            return 0;
+        }
+        if (arg == "--verbose") {
+            verbose = true;
+            continue;
+        }
+        if (i + 1 >= argc) break;
+
+        if (arg == "--port") options.webPort = static_cast<uint16_t>(std::stoi(argv[++i]));
+        else if (arg == "--universes") options.universeCount = static_cast<uint16_t>(std::stoi(argv[++i]));
+        else if (arg == "--output-hz") options.outputHz = std::stod(argv[++i]);
+        else if (arg == "--udp-backend") options.udpBackend = argv[++i];
+        else if (arg == "--input") options.input = std::string(argv[++i]) == "rest" ? HarnessInput::Rest : HarnessInput::WebSocket;
+        else if (arg == "--rate") options.inputRate = std::stod(argv[++i]);
+        else if (arg == "--duration") options.durationSec = std::stod(argv[++i]);
+        else if (arg == "--max-p99-ms") maxP99Ms = std::stod(argv[++i]);
+        else if (arg == "--min-fps") minFps = std::stod(argv[++i]);
+    }
+
+    spdlog::set_level(verbose ? spdlog::level::info : spdlog::level::warn);
+
+    LoopbackHarness harness(options);
+    if (!harness.start()) return 2;
+    auto report = harness.run();
+    harness.stop();
+
+    std::printf("input=%s rate=%.0f/s duration=%.1fs universes=%u output=%.0f Hz backend=%s\n",
+                options.input == HarnessInput::Rest ? "rest" : "ws", options.inputRate,
+                options.durationSec, options.universeCount, options.outputHz,
+                options.udpBackend.c_str());
+    std::printf("probes: sent=%llu matched=%llu coalesced=%llu lost=%llu\n",
+                static_cast<unsigned long long>(report.sent),
+                static_cast<unsigned long long>(report.matched),
+                static_cast<unsigned long long>(report.coalesced),
+                static_cast<unsigned long long>(report.lost));
+    std::printf("latency ms: mean=%.2f p50=%.2f p90=%.2f p99=%.2f max=%.2f\n",
+                report.meanMs, report.p50Ms, report.p90Ms, report.p99Ms, report.maxMs);
+    for (const auto& u : report.universes) {
+        std::printf("universe %u: %llu frames, %.1f fps, max gap %.1f ms\n", u.universe,
+                    static_cast<unsigned long long>(u.frames), u.fps, u.maxGapMs);
+    }
+
+    int status = 0;
+    if (report.matched == 0) {
+        std::fprintf(stderr, "FAIL: no probe reached the wire\n");
+        status = 1;
+    }
+    if (maxP99Ms > 0 && report.p99Ms > maxP99Ms) {
+        std::fprintf(stderr, "FAIL: p99 %.2f ms exceeds budget %.2f ms\n", report.p99Ms, maxP99Ms);
+        status = 1;
+    }
+    for (const auto& u : report.universes) {
+        if (minFps > 0 && u.fps < minFps) {
+            std::fprintf(stderr, "FAIL: universe %u at %.1f fps, below %.1f\n", u.universe, u.fps, minFps);
+            status = 1;
+        }
+    }
+    return status;
+}
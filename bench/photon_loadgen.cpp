@@ -0,0 +1,152 @@
+// Synthetic load against a running photon: N WebSocket clients writing
+// channels at a fixed rate and M REST pollers reading /api/universes.
+// Reports achieved vs. target rates, server response latencies and dropped
+// messages. Start photon separately, e.g. `photon --port 9090 --universes 64`.
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include "LoadGenerator.h"
+
+using namespace photon;
+
+static void usage() {
+    std::cout << "Usage: photon_loadgen [options]\n\n"
+              << "Options:\n"
+              << "  --host HOST         photon host (default: 127.0.0.1)\n"
+              << "  --port N            photon web port (default: 9090)\n"
+              << "  --duration SEC      Run time (default: 10)\n"
+              << "  --universes N       Universes to write into (default: all the server has)\n"
+              << "  --ws-clients N      WebSocket clients (default: 4)\n"
+              << "  --ws-rate HZ        Messages per second per client (default: 30)\n"
+              << "  --ws-mode MODE      channel, channels or batch (default: channel)\n"
+              << "  --channels N        Channels per channels/batch message (default: 8)\n"
+              << "  --no-subscribe      Clients don't subscribe to DMX state\n"
+              << "  --rest-pollers N    REST pollers on /api/universes (default: 1)\n"
+              << "  --rest-rate HZ      Requests per second per poller (default: 10)\n"
+              << "  --rest-full         Poll full state instead of ?since= deltas\n"
+              << "  --json              Print the report as JSON\n"
+              << "  --verbose           Keep client logging\n";
+}
+
+static nlohmann::json latencyJson(const LatencySummary& s) {
+    return {{"count", s.count}, {"mean_ms", s.meanMs}, {"p50_ms", s.p50Ms},
+            {"p90_ms", s.p90Ms}, {"p99_ms", s.p99Ms}, {"max_ms", s.maxMs}};
+}
+
+static void printLatency(const char* what, const LatencySummary& s) {
+    std::printf("%s latency ms: mean=%.2f p50=%.2f p90=%.2f p99=%.2f max=%.2f (n=%llu)\n", what,
+                s.meanMs, s.p50Ms, s.p90Ms, s.p99Ms, s.maxMs, static_cast<unsigned long long>(s.count));
+}
+
+int main(int argc, char* argv[]) {
+    LoadOptions options;
+    bool jsonOutput = false;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            usage();
+            return 0;
+        }
+        if (arg == "--no-subscribe") {
+            options.subscribe = false;
+            continue;
+        }
+        if (arg == "--rest-full") {
+            options.restSince = false;
+            continue;
+        }
+        if (arg == "--json") {
+            jsonOutput = true;
+            continue;
+        }
+        if (arg == "--verbose") {
+            verbose = true;
+            continue;
+        }
+        if (i + 1 >= argc) break;
+
+        if (arg == "--host") options.host = argv[++i];
+        else if (arg == "--port") options.port = static_cast<uint16_t>(std::stoi(argv[++i]));
+        else if (arg == "--duration") options.durationSec = std::stod(argv[++i]);
+        else if (arg == "--universes") options.universeCount = static_cast<uint16_t>(std::stoi(argv[++i]));
+        else if (arg == "--ws-clients") options.wsClients = std::stoi(argv[++i]);
+        else if (arg == "--ws-rate") options.wsRate = std::stod(argv[++i]);
+        else if (arg == "--channels") options.channelsPerMessage = std::stoi(argv[++i]);
+        else if (arg == "--rest-pollers") options.restPollers = std::stoi(argv[++i]);
+        else if (arg == "--rest-rate") options.restRate = std::stod(argv[++i]);
+        else if (arg == "--ws-mode") {
+            std::string mode = argv[++i];
+            if (mode == "channel") options.wsMode = WsLoadMode::Channel;
+            else if (mode == "channels") options.wsMode = WsLoadMode::Channels;
+            else if (mode == "batch") options.wsMode = WsLoadMode::Batch;
+            else {
+                std::cerr << "Unknown --ws-mode " << mode << "\n";
+                return 2;
+            }
+        }
+    }
+
+    spdlog::set_level(verbose ? spdlog::level::info : spdlog::level::warn);
+
+    LoadGenerator generator(options);
+    if (!generator.start()) return 2;
+    auto report = generator.run();
+    generator.stop();
+
+    const char* mode = options.wsMode == WsLoadMode::Batch      ? "batch"
+                       : options.wsMode == WsLoadMode::Channels ? "channels"
+                                                                : "channel";
+    uint64_t dropped = report.ws.sendFailures + report.ws.unacked;
+
+    if (jsonOutput) {
+        nlohmann::json out = {
+            {"duration_s", report.elapsedSec},
+            {"universes", report.universeCount},
+            {"ws", {{"clients", options.wsClients}, {"mode", mode},
+                    {"sent", report.ws.sent}, {"target_rate", report.ws.targetRate},
+                    {"achieved_rate", report.ws.achievedRate},
+                    {"send_failures", report.ws.sendFailures}, {"disconnects", report.ws.disconnects},
+                    {"acked", report.ws.acked}, {"unacked", report.ws.unacked},
+                    {"ack_latency", latencyJson(report.ws.ackLatency)},
+                    {"frames_received", report.ws.framesReceived},
+                    {"frames_per_client_per_s", report.ws.framesPerClientPerSec}}},
+            {"rest", {{"pollers", options.restPollers}, {"requests", report.rest.requests},
+                      {"target_rate", report.rest.targetRate},
+                      {"achieved_rate", report.rest.achievedRate},
+                      {"not_modified", report.rest.notModified}, {"errors", report.rest.errors},
+                      {"bytes", report.rest.bytes}, {"latency", latencyJson(report.rest.latency)}}},
+        };
+        std::printf("%s\n", out.dump(2).c_str());
+    } else {
+        std::printf("target=%s:%u duration=%.1fs universes=%u\n", options.host.c_str(), options.port,
+                    report.elapsedSec, report.universeCount);
+        std::printf("ws: clients=%d mode=%s sent=%llu rate=%.1f/s (target %.1f/s) "
+                    "send-failures=%llu disconnects=%llu\n",
+                    options.wsClients, mode, static_cast<unsigned long long>(report.ws.sent),
+                    report.ws.achievedRate, report.ws.targetRate,
+                    static_cast<unsigned long long>(report.ws.sendFailures),
+                    static_cast<unsigned long long>(report.ws.disconnects));
+        if (options.wsMode == WsLoadMode::Batch) {
+            std::printf("ws: acked=%llu unacked=%llu\n", static_cast<unsigned long long>(report.ws.acked),
+                        static_cast<unsigned long long>(report.ws.unacked));
+            printLatency("ws ack", report.ws.ackLatency);
+        }
+        std::printf("ws: frames received=%llu (%.1f per client per second)\n",
+                    static_cast<unsigned long long>(report.ws.framesReceived), report.ws.framesPerClientPerSec);
+        std::printf("rest: pollers=%d requests=%llu rate=%.1f/s (target %.1f/s) "
+                    "not-modified=%llu errors=%llu bytes=%llu\n",
+                    options.restPollers, static_cast<unsigned long long>(report.rest.requests),
+                    report.rest.achievedRate, report.rest.targetRate,
+                    static_cast<unsigned long long>(report.rest.notModified),
+                    static_cast<unsigned long long>(report.rest.errors),
+                    static_cast<unsigned long long>(report.rest.bytes));
+        printLatency("rest", report.rest.latency);
+        std::printf("dropped: %llu\n", static_cast<unsigned long long>(dropped));
+    }
+
+    return dropped + report.ws.disconnects + report.rest.errors > 0 ? 1 : 0;
+}
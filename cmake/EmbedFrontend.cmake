@@ -1,20 +1,62 @@
+# Builds the frontend with npm and, when PHOTON_EMBED_FRONTEND is on, compiles
+# frontend/dist into photon_lib as a generated translation unit so the binary
+# serves the UI from read-only memory with no filesystem access.
+option(PHOTON_EMBED_FRONTEND "Compile the frontend bundle into the photon binary" ON)
+
+set(PHOTON_FRONTEND_SOURCE ${CMAKE_SOURCE_DIR}/frontend)
+set(PHOTON_FRONTEND_DIST ${PHOTON_FRONTEND_SOURCE}/dist)
+set(PHOTON_FRONTEND_STAMP ${CMAKE_BINARY_DIR}/frontend.stamp)
+
 find_program(NPM_EXECUTABLE npm)
 
 if(NPM_EXECUTABLE)
-    add_custom_target(frontend
+    file(GLOB_RECURSE PHOTON_FRONTEND_INPUTS CONFIGURE_DEPENDS
+        ${PHOTON_FRONTEND_SOURCE}/src/*
+        ${PHOTON_FRONTEND_SOURCE}/public/*
+        ${PHOTON_FRONTEND_SOURCE}/package.json
+        ${PHOTON_FRONTEND_SOURCE}/next.config.ts
+    )
+    add_custom_command(
+        OUTPUT ${PHOTON_FRONTEND_STAMP}
         COMMAND ${NPM_EXECUTABLE} install
         COMMAND ${NPM_EXECUTABLE} run build
-        WORKING_DIRECTORY ${CMAKE_SOURCE_DIR}/frontend
+        COMMAND ${CMAKE_COMMAND} -E touch ${PHOTON_FRONTEND_STAMP}
+        DEPENDS ${PHOTON_FRONTEND_INPUTS}
+        WORKING_DIRECTORY ${PHOTON_FRONTEND_SOURCE}
         COMMENT "Building frontend..."
     )
+    add_custom_target(frontend DEPENDS ${PHOTON_FRONTEND_STAMP})
     add_dependencies(photon frontend)
-
-    target_compile_definitions(photon_lib PUBLIC
-        PHOTON_FRONTEND_DIR="${CMAKE_SOURCE_DIR}/frontend/dist"
-    )
+    set(PHOTON_EMBED_DEPENDS ${PHOTON_FRONTEND_STAMP})
+elseif(EXISTS ${PHOTON_FRONTEND_DIST})
+    message(STATUS "npm not found — using prebuilt ${PHOTON_FRONTEND_DIST}")
+    file(GLOB_RECURSE PHOTON_EMBED_DEPENDS CONFIGURE_DEPENDS ${PHOTON_FRONTEND_DIST}/*)
 else()
     message(WARNING "npm not found — frontend will not be built")
-    target_compile_definitions(photon_lib PUBLIC
-        PHOTON_FRONTEND_DIR=""
+    set(PHOTON_EMBED_FRONTEND OFF)
+endif()
+
+if(PHOTON_EMBED_FRONTEND)
+    add_executable(photon_embed tools/photon_embed.cpp)
+    target_link_libraries(photon_embed PRIVATE photon_assets)
+
+    set(PHOTON_EMBEDDED_SOURCE ${CMAKE_BINARY_DIR}/generated/EmbeddedFrontend.cpp)
+    add_custom_command(
+        OUTPUT ${PHOTON_EMBEDDED_SOURCE}
+        COMMAND photon_embed ${PHOTON_FRONTEND_DIST} ${PHOTON_EMBEDDED_SOURCE}
+        DEPENDS photon_embed ${PHOTON_EMBED_DEPENDS}
+        COMMENT "Embedding frontend assets..."
     )
+    target_sources(photon_lib PRIVATE ${PHOTON_EMBEDDED_SOURCE})
+
+    # No compiled-in path: the binary serves its embedded copy unless
+    # --frontend-dir points somewhere else
+    target_compile_definitions(photon_lib PUBLIC PHOTON_FRONTEND_DIR="")
+else()
+    target_sources(photon_lib PRIVATE src/web/EmbeddedAssetsNone.cpp)
+    if(NPM_EXECUTABLE)
+        target_compile_definitions(photon_lib PUBLIC PHOTON_FRONTEND_DIR="${PHOTON_FRONTEND_DIST}")
+    else()
+        target_compile_definitions(photon_lib PUBLIC PHOTON_FRONTEND_DIR="")
+    endif()
 endif()
@@ -18,6 +18,182 @@ let currentConfig: ConnectionConfig | null = null
 
 const pendingMessages: WsMessage[] = []
 
+// Universes the open views display. Until the first setSubscription() the
+// engine sends every universe; after it, only these. Re-sent on every
+// (re)connect, since a new connection starts out subscribed to everything.
+let subscription: number[] | null = null
+
+// Binary DMX frames (engine src/web/WsProtocol.h): 8-byte little-endian
+// header (u8 type, u8 flags, u16 universe, u32 seq), then either 512 channel
+// bytes (DmxState) or, from the relay, runs of changed channels (DmxDelta)
+const BINARY_HEADER_SIZE = 8
+const MSG_DMX_STATE = 0x01
+const MSG_DMX_DELTA = 0x03
+const DELTA_RUN_HEADER_SIZE = 4
+
+// Seq of the last frame applied per universe; a delta only applies on top of
+// seq - 1, otherwise the universe waits for the next keyframe
+const lastSeq = new Map<number, number>()
+
+function applyDelta(view: DataView, universe: number, seq: number): void {
+  const store = useDmxStore.getState()
+  const channels = [...(store.channels[universe] ?? new Array<number>(512).fill(0))]
+  let pos = BINARY_HEADER_SIZE
+  while (pos < view.byteLength) {
+    const valid = pos + DELTA_RUN_HEADER_SIZE <= view.byteLength
+    const start = valid ? view.getUint16(pos, true) : 0
+    const count = valid ? view.getUint16(pos + 2, true) : 0
+    pos += DELTA_RUN_HEADER_SIZE
+    if (!valid || start + count > 512 || pos + count > view.byteLength) {
+      // Malformed: drop it and wait for the next keyframe
+      lastSeq.delete(universe)
+      return
+    }
+    for (let i = 0; i < count; i++) channels[start + i] = view.getUint8(pos + i)
+    pos += count
+  }
+  lastSeq.set(universe, seq)
+  store.setChannels(universe, channels)
+}
+
+function handleBinaryMessage(buffer: ArrayBuffer): void {
+  if (buffer.byteLength < BINARY_HEADER_SIZE) return
+  const view = new DataView(buffer)
+  const type = view.getUint8(0)
+  const universe = view.getUint16(2, true)
+  const seq = view.getUint32(4, true)
+
+  if (type === MSG_DMX_STATE) {
+    if (buffer.byteLength < BINARY_HEADER_SIZE + 512) return
+    lastSeq.set(universe, seq)
+    const channels = Array.from(new Uint8Array(buffer, BINARY_HEADER_SIZE, 512))
+    useDmxStore.getState().setChannels(universe, channels)
+  } else if (type === MSG_DMX_DELTA) {
+    if (lastSeq.get(universe) !== ((seq - 1) >>> 0)) return
+    applyDelta(view, universe, seq)
+  }
+}
+
+// Over the relay every message is an internet round trip, so channel writes
+// are coalesced per channel and sent as binary CommandBatch frames. Up to
+// MAX_IN_FLIGHT batches may await the engine's ack; while the window is full,
+// newer values simply replace pending ones.
+const MSG_COMMAND_BATCH = 0x04
+const OP_RANGE = 0x01
+const OP_SPARSE = 0x02
+const OP_BLACKOUT = 0x03
+const MAX_IN_FLIGHT = 4
+// Engine limit on decoded runs per batch (wsproto::MAX_BATCH_RUNS)
+const MAX_BATCH_RUNS = 1024
+const BATCH_INTERVAL_MS = 20
+// Without an ack for this long, assume the batches were lost and reopen the window
+const ACK_TIMEOUT_MS = 2000
+
+const pendingWrites = new Map<number, Map<number, number>>() // universe -> channel -> value
+let pendingBlackout = false
+let batchSeq = 0
+let ackedSeq = 0
+let lastBatchSent = 0
+let batchTimer: ReturnType<typeof setTimeout> | null = null
+
+function queueCommand(msg: WsMessage): boolean {
+  const type = msg['type']
+  if (type === 'set_channel') {
+    queueWrite(msg['universe'] as number, msg['channel'] as number, msg['value'] as number)
+  } else if (type === 'set_channels') {
+    for (const [channel, value] of msg['channels'] as [number, number][]) {
+      queueWrite(msg['universe'] as number, channel, value)
+    }
+  } else if (type === 'blackout') {
+    pendingWrites.clear()
+    pendingBlackout = true
+  } else {
+    return false
+  }
+  scheduleBatch()
+  return true
+}
+
+function queueWrite(universe: number, channel: number, value: number): void {
+  if (channel < 0 || channel >= 512) return
+  let channels = pendingWrites.get(universe)
+  if (!channels) {
+    channels = new Map()
+    pendingWrites.set(universe, channels)
+  }
+  channels.set(channel, value)
+}
+
+function scheduleBatch(): void {
+  if (batchTimer === null) batchTimer = setTimeout(flushBatch, BATCH_INTERVAL_MS)
+}
+
+function flushBatch(): void {
+  batchTimer = null
+  if (!pendingBlackout && pendingWrites.size === 0) return
+  if (!socket || socket.readyState !== WebSocket.OPEN) return
+  if (batchSeq - ackedSeq >= MAX_IN_FLIGHT) {
+    if (Date.now() - lastBatchSent < ACK_TIMEOUT_MS) {
+      scheduleBatch()
+      return
+    }
+    ackedSeq = batchSeq
+  }
+
+  socket.send(encodeBatch(++batchSeq))
+  lastBatchSent = Date.now()
+  pendingBlackout = false
+  if (pendingWrites.size > 0) scheduleBatch()
+}
+
+// Consecutive channels become Range ops, the rest one Sparse op per
+// universe. Encoded universes leave pendingWrites; any that would push the
+// batch past the engine's run limit wait for the next one.
+function encodeBatch(seq: number): ArrayBuffer {
+  const ops: number[] = []
+  const u16 = (v: number) => { ops.push(v & 0xff, v >> 8) }
+  if (pendingBlackout) ops.push(OP_BLACKOUT)
+
+  let runs = 0
+  for (const [universe, writes] of pendingWrites) {
+    if (runs > 0 && runs + writes.size > MAX_BATCH_RUNS) break
+    runs += writes.size
+    pendingWrites.delete(universe)
+    const channels = [...writes.keys()].sort((a, b) => a - b)
+    const singles: number[] = []
+    for (let i = 0; i < channels.length;) {
+      let end = i + 1
+      while (end < channels.length && channels[end] === channels[end - 1] + 1) end++
+      if (end - i === 1) {
+        singles.push(channels[i])
+      } else {
+        ops.push(OP_RANGE)
+        u16(universe)
+        u16(channels[i])
+        u16(end - i)
+        for (let j = i; j < end; j++) ops.push(writes.get(channels[j]) ?? 0)
+      }
+      i = end
+    }
+    if (singles.length > 0) {
+      ops.push(OP_SPARSE)
+      u16(universe)
+      u16(singles.length)
+      for (const channel of singles) {
+        u16(channel)
+        ops.push(writes.get(channel) ?? 0)
+      }
+    }
+  }
+
+  const buffer = new ArrayBuffer(BINARY_HEADER_SIZE + ops.length)
+  const view = new DataView(buffer)
+  view.setUint8(0, MSG_COMMAND_BATCH)
+  view.setUint32(4, seq >>> 0, true) // universe field is the origin, set by the relay
+  new Uint8Array(buffer, BINARY_HEADER_SIZE).set(ops)
+  return buffer
+}
+
 function scheduleReconnect(): void {
   if (reconnectTimeout !== null) return
   reconnectTimeout = setTimeout(() => {
@@ -30,6 +206,11 @@ function scheduleReconnect(): void {
 }
 
 function handleMessage(event: MessageEvent): void {
+  if (event.data instanceof ArrayBuffer) {
+    handleBinaryMessage(event.data)
+    return
+  }
+
   let data: WsMessage
   try {
     data = JSON.parse(event.data as string) as WsMessage
@@ -51,10 +232,21 @@ function handleMessage(event: MessageEvent): void {
     if (typeof count === 'number') {
       store.setUniverseCount(count)
     }
+  } else if (type === 'ping') {
+    // The engine times the answer to pick this client's update rate
+    if (socket && socket.readyState === WebSocket.OPEN) {
+      socket.send(JSON.stringify({ type: 'pong', id: data['id'] }))
+    }
+  } else if (type === 'ack') {
+    const seq = data['seq']
+    if (typeof seq === 'number' && seq > ackedSeq) ackedSeq = seq
+    flushBatch()
   } else if (type === 'auth_ack') {
     // Relay auth acknowledged
   } else if (type === 'engine_offline') {
-    // Engine disconnected from relay — keep WS open for reconnect
+    // Engine disconnected from relay — keep WS open for reconnect; batches in
+    // flight will never be acknowledged
+    ackedSeq = batchSeq
   }
 }
 
@@ -64,6 +256,19 @@ function attachSocketEvents(): void {
   socket.addEventListener('open', () => {
     reconnectDelay = 1000
     useDmxStore.getState().setConnected(true)
+    lastSeq.clear()
+    batchSeq = 0
+    ackedSeq = 0
+
+    // The engine speaks binary DMX frames once asked; the relay forwards the
+    // engine's keyframes and deltas as they come
+    if (socket) socket.binaryType = 'arraybuffer'
+    if (currentConfig?.mode === 'direct' && socket) {
+      socket.send(JSON.stringify({ type: 'hello', protocol: 'binary' }))
+      if (subscription !== null) {
+        socket.send(JSON.stringify({ type: 'subscribe', universes: subscription }))
+      }
+    }
 
     // If relay mode, send auth message with token
     if (currentConfig?.mode === 'relay' && currentConfig.relayInstanceId) {
@@ -76,6 +281,7 @@ function attachSocketEvents(): void {
         socket.send(JSON.stringify(msg))
       }
     }
+    flushBatch()
   })
 
   socket.addEventListener('message', handleMessage)
@@ -162,7 +368,23 @@ export function disconnect(): void {
   useDmxStore.getState().setConnected(false)
 }
 
+// Narrows the engine's DMX stream to `universes`. Only direct connections
+// subscribe: over the relay the engine's stream is shared by every client.
+export function setSubscription(universes: number[]): void {
+  const next = [...new Set(universes)].sort((a, b) => a - b)
+  const previous = subscription ?? []
+  subscription = next
+  if (currentConfig?.mode !== 'direct' || !socket || socket.readyState !== WebSocket.OPEN) return
+
+  // Subscribe first: the first subscribe replaces the implicit "everything"
+  const added = next.filter((u) => !previous.includes(u))
+  const dropped = previous.filter((u) => !next.includes(u))
+  if (added.length > 0) socket.send(JSON.stringify({ type: 'subscribe', universes: added }))
+  if (dropped.length > 0) socket.send(JSON.stringify({ type: 'unsubscribe', universes: dropped }))
+}
+
 export function sendMessage(msg: WsMessage): void {
+  if (currentConfig?.mode === 'relay' && queueCommand(msg)) return
   if (socket && socket.readyState === WebSocket.OPEN) {
     socket.send(JSON.stringify(msg))
   } else {
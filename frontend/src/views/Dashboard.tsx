@@ -1,4 +1,5 @@
-import { useMemo } from 'react'
+import { useEffect, useMemo } from 'react'
+import { setSubscription } from '@/api/connection'
 import { useDmxStore } from '@/store/dmxStore'
 import ChannelFader from '@/components/ChannelFader'
 
@@ -11,6 +12,11 @@ export default function Dashboard({ page, channelsPerPage }: DashboardProps) {
   const activeUniverse = useDmxStore((s) => s.activeUniverse)
   const channelData = useDmxStore((s) => s.channels[activeUniverse])
 
+  // Only the universe on screen needs streaming
+  useEffect(() => {
+    setSubscription([activeUniverse])
+  }, [activeUniverse])
+
   const channels = useMemo(
     () => channelData ?? new Array<number>(512).fill(0),
     [channelData]
@@ -4,10 +4,17 @@ export interface ClientSession {
   ws: WebSocket
   userId: string
   instanceId: string
+  id: number // origin stamped on this client's command batches (1-65535)
 }
 
 // instanceId -> Set<ClientSession>
 const clients = new Map<string, Set<ClientSession>>()
+let lastClientId = 0
+
+export function nextClientId(): number {
+  lastClientId = (lastClientId % 0xffff) + 1
+  return lastClientId
+}
 
 export function addClient(session: ClientSession): void {
   let set = clients.get(session.instanceId)
@@ -31,7 +38,16 @@ export function getClients(instanceId: string): Set<ClientSession> {
   return clients.get(instanceId) ?? new Set()
 }
 
-export function broadcastToClients(instanceId: string, payload: string): void {
+export function sendToClient(instanceId: string, id: number, payload: string): void {
+  for (const client of getClients(instanceId)) {
+    if (client.id !== id) continue
+    try {
+      if (client.ws.readyState === client.ws.OPEN) client.ws.send(payload)
+    } catch { /* ignore send errors */ }
+  }
+}
+
+export function broadcastToClients(instanceId: string, payload: string | Buffer): void {
   const set = clients.get(instanceId)
   if (!set || set.size === 0) return
 
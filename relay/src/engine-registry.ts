@@ -6,6 +6,7 @@ export interface EngineSession {
   instanceId: string
   heartbeatInterval: ReturnType<typeof setInterval> | null
   lastState: Map<number, string> // universe -> last JSON payload
+  frames: Map<number, Buffer[]> // universe -> last binary keyframe + deltas since
   universeCount: number
 }
 
@@ -28,6 +29,7 @@ export function registerEngine(instanceId: string, ws: WebSocket): EngineSession
     instanceId,
     heartbeatInterval: null,
     lastState: new Map(),
+    frames: new Map(),
     universeCount: 0,
   }
 
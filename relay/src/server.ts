@@ -2,8 +2,10 @@ import { createServer, type IncomingMessage } from 'http'
 import { WebSocketServer, WebSocket } from 'ws'
 import { URL } from 'url'
 import { verifyClientToken } from './jwt.js'
-import { registerEngine, removeEngine, getEngine } from './engine-registry.js'
-import { addClient, removeClient, broadcastToClients, type ClientSession } from './client-registry.js'
+import { registerEngine, removeEngine, getEngine, type EngineSession } from './engine-registry.js'
+import {
+  addClient, removeClient, broadcastToClients, sendToClient, nextClientId, type ClientSession,
+} from './client-registry.js'
 
 const PORT = parseInt(process.env.PORT || '8080', 10)
 
@@ -34,6 +36,36 @@ async function lookupRelayToken(relayToken: string): Promise<string | null> {
   }
 }
 
+// ─── Binary DMX frames ───────────────────────────────────────────
+
+// The engine uplink sends keyframes and deltas (engine src/web/WsProtocol.h).
+// They are passed to clients untouched; only the 8-byte header is read, to
+// cache each universe's keyframe and the deltas since it for late joiners.
+const FRAME_HEADER_SIZE = 8
+const MSG_DMX_STATE = 0x01
+const MSG_DMX_DELTA = 0x03
+const MSG_COMMAND_BATCH = 0x04
+// The engine sends a keyframe every few seconds; this only bounds a chain
+// from a misbehaving engine
+const MAX_CACHED_DELTAS = 512
+
+function forwardFrame(engine: EngineSession, frame: Buffer): void {
+  if (frame.length < FRAME_HEADER_SIZE) return
+  const type = frame.readUInt8(0)
+  const universe = frame.readUInt16LE(2)
+
+  if (type === MSG_DMX_STATE) {
+    engine.frames.set(universe, [frame])
+  } else if (type === MSG_DMX_DELTA) {
+    const chain = engine.frames.get(universe)
+    if (chain && chain.length <= MAX_CACHED_DELTAS) chain.push(frame)
+    else engine.frames.delete(universe)
+  } else {
+    return
+  }
+  broadcastToClients(engine.instanceId, frame)
+}
+
 // ─── HTTP Server ─────────────────────────────────────────────────
 
 const server = createServer((req, res) => {
@@ -48,7 +80,7 @@ const server = createServer((req, res) => {
 
 // ─── Engine WebSocket Server (/engine) ───────────────────────────
 
-const engineWss = new WebSocketServer({ noServer: true })
+const engineWss = new WebSocketServer({ noServer: true, perMessageDeflate: true })
 
 engineWss.on('connection', (ws: WebSocket) => {
   let instanceId: string | null = null
@@ -61,7 +93,13 @@ engineWss.on('connection', (ws: WebSocket) => {
     }
   }, 10000)
 
-  ws.on('message', (raw) => {
+  ws.on('message', (raw, isBinary) => {
+    if (isBinary) {
+      const engine = authenticated && instanceId ? getEngine(instanceId) : undefined
+      if (engine) forwardFrame(engine, raw as Buffer)
+      return
+    }
+
     let msg: Record<string, unknown>
     try {
       msg = JSON.parse(raw.toString())
@@ -102,6 +140,9 @@ engineWss.on('connection', (ws: WebSocket) => {
         }
         broadcastToClients(instanceId, payload)
       }
+    } else if (msg.type === 'ack' && typeof msg.client === 'number') {
+      // Command batch acknowledgement for one client
+      if (instanceId) sendToClient(instanceId, msg.client as number, raw.toString())
     } else if (msg.type === 'heartbeat') {
       ws.send(JSON.stringify({ type: 'heartbeat_ack' }))
     }
@@ -123,7 +164,8 @@ engineWss.on('connection', (ws: WebSocket) => {
 
 // ─── Client WebSocket Server (/client) ──────────────────────────
 
-const clientWss = new WebSocketServer({ noServer: true })
+// Small deltas are not worth compressing; keyframes and JSON are
+const clientWss = new WebSocketServer({ noServer: true, perMessageDeflate: { threshold: 256 } })
 
 clientWss.on('connection', (ws: WebSocket, request: IncomingMessage) => {
   const url = new URL(request.url || '/', `http://${request.headers.host}`)
@@ -145,6 +187,7 @@ clientWss.on('connection', (ws: WebSocket, request: IncomingMessage) => {
       ws,
       userId: payload.sub,
       instanceId: payload.instanceId,
+      id: nextClientId(),
     }
 
     addClient(session)
@@ -161,12 +204,26 @@ clientWss.on('connection', (ws: WebSocket, request: IncomingMessage) => {
       for (const [, statePayload] of engine.lastState) {
         ws.send(statePayload)
       }
+      for (const [, chain] of engine.frames) {
+        for (const frame of chain) ws.send(frame)
+      }
     } else {
       ws.send(JSON.stringify({ type: 'engine_offline' }))
     }
 
     // Forward client commands to engine
-    ws.on('message', (raw) => {
+    ws.on('message', (raw, isBinary) => {
+      if (isBinary) {
+        // Command batches pass through with the header's universe field set
+        // to this client's id, so the engine's acks can be routed back
+        const frame = Buffer.from(raw as Buffer)
+        if (frame.length < FRAME_HEADER_SIZE || frame.readUInt8(0) !== MSG_COMMAND_BATCH) return
+        frame.writeUInt16LE(session.id, 2)
+        const eng = getEngine(payload.instanceId)
+        if (eng && eng.ws.readyState === WebSocket.OPEN) eng.ws.send(frame)
+        return
+      }
+
       let msg: Record<string, unknown>
       try {
         msg = JSON.parse(raw.toString())
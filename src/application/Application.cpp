@@ -1,17 +1,33 @@
 #include "application/Application.h"
 #include "relay/RelayClient.h"
+#include "replication/ReplicationReceiver.h"
+#include "replication/ReplicationSender.h"
+#include "metrics/Metrics.h"
+#include "metrics/Trace.h"
+#include "engine/ThreadPlacement.h"
+#include "pixel/PixelMapper.h"
+#include "pixel/PixelSource.h"
 #include "protocol/ArtNetSender.h"
+#include "show/ShowPlayer.h"
+#include "show/ShowRecorder.h"
+#include "show/ShowSnapshot.h"
 #include <spdlog/spdlog.h>
 #include <chrono>
+#include <unordered_set>
 
 namespace photon {
 
-template <class... Ts>
-struct overloaded : Ts... { using Ts::operator()...; };
-template <class... Ts>
-overloaded(Ts...) -> overloaded<Ts...>;
+namespace {
 
-Application::Application() = default;
+metrics::Histogram inputApplySeconds{"photon_input_apply_latency_seconds",
+    "Time from the oldest coalesced input write to its merge into the output",
+    {0.0005, 0.001, 0.0025, 0.005, 0.01, 0.015, 0.025, 0.05, 0.1}};
+metrics::Counter inputBatches{"photon_input_batches_total",
+    "Coalesced input batches applied by the engine"};
+
+} // namespace
+
+Application::Application(Clock& clock) : clock_(clock) {}
 
 Application::~Application() {
     stop();
@@ -21,29 +37,102 @@ void Application::start(const Config& config) {
     if (running_.exchange(true)) return;
 
     config_ = config;
+    // Before anything allocates, so buffers below are locked as they are mapped
+    if (config.lockMemory) placement::lockMemory();
+
     mergeBuffer_ = std::make_unique<MergeBuffer>(config.universeCount);
+    input_ = std::make_unique<InputCoalescer>(config.universeCount);
     deviceManager_ = std::make_unique<DeviceManager>();
-    outputScheduler_ = std::make_unique<OutputScheduler>(*mergeBuffer_, *deviceManager_);
-    wsBroadcaster_ = std::make_unique<WsBroadcaster>(*mergeBuffer_, config.wsBroadcastHz);
-    webServer_ = std::make_unique<WebServer>(*mergeBuffer_, actionQueue_,
+    outputScheduler_ = std::make_unique<OutputScheduler>(*mergeBuffer_, *deviceManager_, clock_);
+    wsBroadcaster_ = std::make_unique<WsBroadcaster>(
+        *mergeBuffer_, RateController::Options{config.wsMinHz, config.wsMaxHz, config.wsBroadcastHz}, clock_);
+    webServer_ = std::make_unique<WebServer>(*mergeBuffer_, *input_,
                                               *deviceManager_, *wsBroadcaster_, config);
 
     setupDefaultDevices(config);
+
+    // Restore before the first output tick so the stage comes back lit
+    if (!config.snapshotPath.empty()) {
+        ShowSnapshot::restore(config.snapshotPath, *mergeBuffer_);
+        showSnapshot_ = std::make_unique<ShowSnapshot>(*mergeBuffer_);
+        showSnapshot_->start(config.snapshotPath, std::chrono::milliseconds(
+            static_cast<long>(config.snapshotInterval * 1000.0)));
+        webServer_->setSnapshot(showSnapshot_.get());
+    }
+
+    if (!config.recordPath.empty()) {
+        showRecorder_ = std::make_unique<ShowRecorder>();
+        if (showRecorder_->start(config.recordPath, config.universeCount)) {
+            outputScheduler_->addObserver(showRecorder_.get());
+        } else {
+            showRecorder_.reset();
+        }
+    }
+
+    if (config.standbyPort != 0) {
+        // Output stays off until the primary goes quiet
+        outputScheduler_->setOutputEnabled(false);
+        replicationReceiver_ = std::make_unique<ReplicationReceiver>(
+            *mergeBuffer_, [this](bool active) { outputScheduler_->setOutputEnabled(active); });
+        if (replicationReceiver_->start(config.standbyPort, std::chrono::milliseconds(config.failoverMs))) {
+            webServer_->setStandby(replicationReceiver_.get());
+        } else {
+            replicationReceiver_.reset();
+            outputScheduler_->setOutputEnabled(true);
+        }
+    }
+
     outputScheduler_->setRefreshRate(config.outputHz);
     outputScheduler_->start();
+
+    if (!config.replicateTo.empty()) {
+        replicationSender_ = std::make_unique<ReplicationSender>(*mergeBuffer_);
+        if (!replicationSender_->start(config.replicateTo, config.outputHz)) replicationSender_.reset();
+    }
+
+    if (!config.playbackPath.empty()) {
+        showPlayer_ = std::make_unique<ShowPlayer>(*mergeBuffer_, SourcePriority::CuePlayback, clock_);
+        if (showPlayer_->open(config.playbackPath)) {
+            showPlayer_->start(config.playbackLoop);
+        } else {
+            showPlayer_.reset();
+        }
+    }
+
+    if (!config.pixelMapPath.empty()) {
+        PixelMap map;
+        if (map.load(config.pixelMapPath, config.universeCount)) {
+            pixelMapper_ = std::make_unique<PixelMapper>(*mergeBuffer_);
+            pixelMapper_->setMap(std::move(map));
+            webServer_->setPixelMapper(pixelMapper_.get());
+
+            // Frames can always arrive over WebSocket; a local source is optional
+            pixelSource_ = std::make_unique<PixelSource>(*pixelMapper_, clock_);
+            bool started = !config.pixelShmName.empty()
+                ? pixelSource_->startSharedMemory(config.pixelShmName, config.pixelFps)
+                : !config.pixelStreamPath.empty() &&
+                      pixelSource_->startStream(config.pixelStreamPath, config.pixelFps);
+            if (!started) pixelSource_.reset();
+        }
+    }
     wsBroadcaster_->start();
 
     // Start relay client if configured
     if (config.hasRelay()) {
-        relayClient_ = std::make_unique<RelayClient>(config.relayUrl, config.relayToken, actionQueue_);
+        relayClient_ = std::make_unique<RelayClient>(config.relayUrl, config.relayToken, *input_,
+                                                      config.relayHz, clock_);
         wsBroadcaster_->addObserver(relayClient_.get());
         relayClient_->start();
         spdlog::info("Relay client enabled — connecting to {}", config.relayUrl);
     }
 
+    metricsCollector_ = metrics::registry().addCollector([this](std::string& out) { collectMetrics(out); });
+
     engineThread_ = std::thread([this] { engineLoop(); });
 
     webThread_ = std::thread([this] {
+        // Crow's I/O threads are spawned from here and inherit this placement
+        placement::apply(placement::Role::Web, "web");
         spdlog::info("Web server starting on port {}", config_.webPort);
         webServer_->start();
     });
@@ -56,14 +145,26 @@ void Application::stop() {
     if (!running_.exchange(false)) return;
 
     spdlog::info("Shutting down...");
+    clock_.wake();
+    metrics::registry().removeCollector(metricsCollector_);
     if (relayClient_) {
         wsBroadcaster_->removeObserver(relayClient_.get());
         relayClient_->stop();
         relayClient_.reset();
     }
+    if (showPlayer_) showPlayer_->stop();
+    if (pixelSource_) pixelSource_->stop();
     webServer_->stop();
+    // Input has stopped; save the final state
+    if (showSnapshot_) showSnapshot_->stop();
+    if (replicationSender_) replicationSender_->stop();
+    if (replicationReceiver_) replicationReceiver_->stop();
     wsBroadcaster_->stop();
     outputScheduler_->stop();
+    if (showRecorder_) {
+        outputScheduler_->removeObserver(showRecorder_.get());
+        showRecorder_->stop();
+    }
 
     if (engineThread_.joinable()) engineThread_.join();
     if (webThread_.joinable()) webThread_.join();
@@ -77,30 +178,75 @@ void Application::waitForStop() {
 }
 
 void Application::engineLoop() {
+    trace::setThreadName("engine");
+    placement::apply(placement::Role::Engine, "engine");
     spdlog::info("Show engine thread started (~100 Hz)");
 
+    // Inputs arrive coalesced: at most one write per touched channel, applied
+    // in one MergeBuffer update so the output never shows half a batch
+    CoalescedBatch batch;
     while (running_.load()) {
-        auto actions = actionQueue_.drain();
-        for (auto& action : actions) {
-            std::visit(overloaded{
-                [this](const action::SetChannel& a) {
-                    mergeBuffer_->setValue(a.universe, a.channel, a.value,
-                                          SourcePriority::Programmer);
-                },
-                [this](const action::Blackout&) {
-                    mergeBuffer_->blackout();
-                    spdlog::info("Blackout executed");
-                }
-            }, action);
+        {
+            PHOTON_TRACE_SCOPE("engine.iteration");
+            if (input_->drain(batch)) {
+                mergeBuffer_->apply(batch);
+                inputApplySeconds.observe(
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - batch.since).count());
+                inputBatches.inc();
+                if (batch.blackout) spdlog::info("Blackout executed");
+            }
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        clock_.sleepFor(std::chrono::milliseconds(10), running_);
     }
 
     spdlog::info("Show engine thread stopped");
 }
 
+void Application::collectMetrics(std::string& out) const {
+    // Pulled at scrape time from stats the components already keep
+    auto input = input_->getStats();
+    metrics::writeHeader(out, "photon_input_writes_total", "Channel writes received from all inputs", "counter");
+    metrics::writeSample(out, "photon_input_writes_total", {}, static_cast<double>(input.writes));
+    metrics::writeHeader(out, "photon_input_coalesced_total",
+                         "Channel writes overwritten or discarded before the engine applied them", "counter");
+    metrics::writeSample(out, "photon_input_coalesced_total", {}, static_cast<double>(input.coalesced));
+    metrics::writeHeader(out, "photon_input_pending", "Channel writes waiting for the engine", "gauge");
+    metrics::writeSample(out, "photon_input_pending", {}, static_cast<double>(input.pending));
+
+    // One device is usually assigned to many universes; report it once
+    struct Row { std::string labels; DeviceStats stats; };
+    std::vector<Row> rows;
+    std::unordered_set<const OutputDevice*> seen;
+    for (const auto& assignment : deviceManager_->getAllDevices()) {
+        if (!seen.insert(assignment.device.get()).second) continue;
+        auto stats = assignment.device->getStats();
+        rows.push_back({metrics::label("device", assignment.device->getDescription()) + "," +
+                        metrics::label("type", assignment.device->getTypeName()) + "," +
+                        metrics::label("transport", stats.transport), stats});
+    }
+    auto family = [&](const char* name, const char* help, const char* type, auto field) {
+        metrics::writeHeader(out, name, help, type);
+        for (const auto& row : rows) metrics::writeSample(out, name, row.labels, field(row.stats));
+    };
+    family("photon_device_packets_total", "Packets sent by each output device", "counter",
+           [](const DeviceStats& s) { return static_cast<double>(s.packets); });
+    family("photon_device_sent_bytes_total", "Bytes sent by each output device", "counter",
+           [](const DeviceStats& s) { return static_cast<double>(s.bytes); });
+    family("photon_device_errors_total", "Send errors on each output device", "counter",
+           [](const DeviceStats& s) { return static_cast<double>(s.errors); });
+    family("photon_device_submit_seconds", "Time each device spent submitting the last tick", "gauge",
+           [](const DeviceStats& s) { return s.lastSubmitUs / 1e6; });
+
+    if (relayClient_) {
+        metrics::writeHeader(out, "photon_relay_backlog_bytes", "Bytes queued on the relay uplink", "gauge");
+        metrics::writeSample(out, "photon_relay_backlog_bytes", {},
+                             static_cast<double>(relayClient_->bufferedBytes()));
+    }
+}
+
 void Application::setupDefaultDevices(const Config& config) {
-    auto artnet = std::make_shared<ArtNetSender>(config.artnetTargetIp, config.artnetPort);
+    auto artnet = std::make_shared<ArtNetSender>(config.artnetTargetIp, config.artnetPort,
+                                                 parseUdpBackend(config.udpBackend));
 
     for (uint16_t u = 0; u < config.universeCount; ++u) {
         deviceManager_->addDevice(artnet, u);
@@ -3,7 +3,8 @@
 #include <memory>
 #include <thread>
 #include "application/Config.h"
-#include "engine/ActionQueue.h"
+#include "engine/Clock.h"
+#include "engine/InputCoalescer.h"
 #include "engine/MergeBuffer.h"
 #include "engine/OutputScheduler.h"
 #include "protocol/DeviceManager.h"
@@ -12,11 +13,19 @@
 
 namespace photon {
 
+class PixelMapper;
+class PixelSource;
 class RelayClient;
+class ReplicationReceiver;
+class ReplicationSender;
+class ShowPlayer;
+class ShowRecorder;
+class ShowSnapshot;
 
 class Application {
 public:
-    Application();
+    // Every periodic loop runs on `clock`; a SimulatedClock steps them by hand
+    explicit Application(Clock& clock = Clock::system());
     ~Application();
 
     void start(const Config& config);
@@ -26,19 +35,29 @@ public:
 private:
     void engineLoop();
     void setupDefaultDevices(const Config& config);
+    void collectMetrics(std::string& out) const;
 
+    Clock& clock_;
     Config config_;
     std::unique_ptr<MergeBuffer> mergeBuffer_;
-    ActionQueue<Action> actionQueue_;
+    std::unique_ptr<InputCoalescer> input_;
     std::unique_ptr<DeviceManager> deviceManager_;
     std::unique_ptr<OutputScheduler> outputScheduler_;
     std::unique_ptr<WsBroadcaster> wsBroadcaster_;
     std::unique_ptr<WebServer> webServer_;
     std::unique_ptr<RelayClient> relayClient_;
+    std::unique_ptr<ShowRecorder> showRecorder_;
+    std::unique_ptr<ShowPlayer> showPlayer_;
+    std::unique_ptr<ShowSnapshot> showSnapshot_;
+    std::unique_ptr<ReplicationSender> replicationSender_;
+    std::unique_ptr<ReplicationReceiver> replicationReceiver_;
+    std::unique_ptr<PixelMapper> pixelMapper_;
+    std::unique_ptr<PixelSource> pixelSource_;
 
     std::thread engineThread_;
     std::thread webThread_;
     std::atomic<bool> running_{false};
+    int metricsCollector_{-1};
 };
 
 } // namespace photon
@@ -27,21 +27,70 @@ Config Config::fromArgs(int argc, char* argv[]) {
                       << "  --universes N       Number of DMX universes (default: 4)\n"
                       << "  --artnet-ip IP      Art-Net target IP (default: 255.255.255.255)\n"
                       << "  --artnet-port N     Art-Net UDP port (default: 6454)\n"
+                      << "  --udp-backend NAME  UDP transmit path: socket or io_uring (default: socket)\n"
                       << "  --frontend-dir PATH Path to frontend dist/ directory\n"
+                      << "  --watch-frontend    Reload frontend files when they change (development)\n"
+                      << "  --ws-min-hz N       Lowest per-client WebSocket update rate (default: 2)\n"
+                      << "  --ws-max-hz N       Highest per-client WebSocket update rate (default: 60)\n"
                       << "  --relay-url URL     Relay service WebSocket URL\n"
                       << "  --relay-token TOKEN Relay instance token (32-byte hex)\n"
+                      << "  --relay-hz N        Relay uplink update rate (default: 15)\n"
+                      << "  --record FILE       Record output frames to FILE\n"
+                      << "  --play FILE         Play back a recording made with --record\n"
+                      << "  --loop              Loop playback\n"
+                      << "  --snapshot FILE     Restore show state from FILE at startup and save it there\n"
+                      << "  --snapshot-interval N  Seconds between snapshots (default: 5, 0 = on request only)\n"
+                      << "  --replicate-to HOST:PORT  Stream show state to a hot standby\n"
+                      << "  --standby PORT      Run as a hot standby, receiving replication on UDP PORT\n"
+                      << "  --failover-ms N     Standby takes over output after N ms without the primary (default: 1000)\n"
+                      << "  --pixel-map FILE    Render pixel frames onto the fixtures described in FILE (JSON)\n"
+                      << "  --pixel-stream PATH Read raw RGB frames from a file or named pipe\n"
+                      << "  --pixel-shm NAME    Read frames from a POSIX shared-memory segment\n"
+                      << "  --pixel-fps N       Pixel file playback / shared-memory poll rate (default: 60)\n"
+                      << "  --thread SPEC       Place a thread: ROLE=CPUS[:POLICY[:PRIO]], e.g. output=3:fifo:80\n"
+                      << "                      (roles: output, engine, broadcast, web, relay; repeatable)\n"
+                      << "  --mlock             Lock process memory and pre-fault thread stacks\n"
                       << "  --help              Show this help\n";
             std::exit(0);
         }
 
+        if (arg == "--loop") {
+            cfg.playbackLoop = true;
+            continue;
+        }
+        if (arg == "--watch-frontend") {
+            cfg.frontendWatch = true;
+            continue;
+        }
+        if (arg == "--mlock") {
+            cfg.lockMemory = true;
+            continue;
+        }
+
         if (i + 1 < argc) {
             if (arg == "--port") cfg.webPort = static_cast<uint16_t>(std::stoi(argv[++i]));
             else if (arg == "--universes") cfg.universeCount = static_cast<uint16_t>(std::stoi(argv[++i]));
             else if (arg == "--artnet-ip") cfg.artnetTargetIp = argv[++i];
             else if (arg == "--artnet-port") cfg.artnetPort = static_cast<uint16_t>(std::stoi(argv[++i]));
+            else if (arg == "--udp-backend") cfg.udpBackend = argv[++i];
             else if (arg == "--frontend-dir") cfg.frontendDir = argv[++i];
+            else if (arg == "--ws-min-hz") cfg.wsMinHz = std::stod(argv[++i]);
+            else if (arg == "--ws-max-hz") cfg.wsMaxHz = std::stod(argv[++i]);
             else if (arg == "--relay-url") cfg.relayUrl = argv[++i];
             else if (arg == "--relay-token") cfg.relayToken = argv[++i];
+            else if (arg == "--relay-hz") cfg.relayHz = std::stod(argv[++i]);
+            else if (arg == "--record") cfg.recordPath = argv[++i];
+            else if (arg == "--play") cfg.playbackPath = argv[++i];
+            else if (arg == "--snapshot") cfg.snapshotPath = argv[++i];
+            else if (arg == "--snapshot-interval") cfg.snapshotInterval = std::stod(argv[++i]);
+            else if (arg == "--replicate-to") cfg.replicateTo = argv[++i];
+            else if (arg == "--standby") cfg.standbyPort = static_cast<uint16_t>(std::stoi(argv[++i]));
+            else if (arg == "--failover-ms") cfg.failoverMs = std::stoi(argv[++i]);
+            else if (arg == "--pixel-map") cfg.pixelMapPath = argv[++i];
+            else if (arg == "--pixel-stream") cfg.pixelStreamPath = argv[++i];
+            else if (arg == "--pixel-shm") cfg.pixelShmName = argv[++i];
+            else if (arg == "--pixel-fps") cfg.pixelFps = std::stod(argv[++i]);
+            else if (arg == "--thread") cfg.threadSpecs.push_back(argv[++i]);
         }
     }
 
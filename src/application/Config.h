@@ -1,6 +1,7 @@
 #pragma once
 #include <cstdint>
 #include <string>
+#include <vector>
 
 namespace photon {
 
@@ -9,13 +10,42 @@ struct Config {
     uint16_t universeCount = 4;
     std::string artnetTargetIp = "255.255.255.255";
     uint16_t artnetPort = 6454;
+    std::string udpBackend = "socket";  // "socket" or "io_uring"
     double outputHz = 44.0;
-    double wsBroadcastHz = 15.0;
+    double wsBroadcastHz = 15.0;  // starting rate for each WebSocket client
+    double wsMinHz = 2.0;         // per-client rate adapts within these bounds
+    double wsMaxHz = 60.0;
     std::string frontendDir;
+    bool frontendWatch = false;  // reload frontend assets when files change
 
     // Relay settings (optional — engine connects outbound to relay service)
     std::string relayUrl;    // e.g. wss://photon-relay.fly.dev/engine
     std::string relayToken;  // 32-byte hex instance secret
+    double relayHz = 15.0;   // uplink rate, independent of local clients
+
+    // Show recording / playback (optional)
+    std::string recordPath;    // record output frames to this file
+    std::string playbackPath;  // play this recording into the CuePlayback plane
+    bool playbackLoop = false;
+
+    // Show-state snapshot (optional): restored at startup, saved periodically
+    std::string snapshotPath;
+    double snapshotInterval = 5.0;  // seconds; 0 saves only on request and at shutdown
+
+    // Hot-standby replication (optional): a primary streams to a standby
+    std::string replicateTo;   // primary: HOST:PORT of the standby
+    uint16_t standbyPort = 0;  // standby: UDP port to receive on
+    int failoverMs = 1000;     // standby takes over after this much silence
+
+    // Pixel mapping (optional): video frames rendered onto LED fixtures
+    std::string pixelMapPath;     // JSON pixel map; enables PixelFrame messages
+    std::string pixelStreamPath;  // raw RGB frames from a file or named pipe
+    std::string pixelShmName;     // frames from a POSIX shared-memory segment
+    double pixelFps = 60.0;       // file playback and shared-memory poll rate
+
+    // Thread placement: ROLE=CPUS[:POLICY[:PRIORITY]] per --thread flag
+    std::vector<std::string> threadSpecs;
+    bool lockMemory = false;  // mlockall and pre-fault thread stacks
 
     bool hasRelay() const { return !relayUrl.empty() && !relayToken.empty(); }
 
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint>
+#include <variant>
+#include "engine/SourcePriority.h"
+
+namespace photon {
+
+namespace action {
+
+struct SetChannel {
+    uint16_t universe;
+    uint16_t channel;
+    uint8_t value;
+    SourcePriority source{SourcePriority::Programmer};
+};
+
+struct Blackout {};
+
+} // namespace action
+
+using Action = std::variant<action::SetChannel, action::Blackout>;
+
+} // namespace photon
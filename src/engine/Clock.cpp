@@ -0,0 +1,97 @@
+#include "engine/Clock.h"
+#include <iterator>
+#include <thread>
+
+namespace photon {
+
+namespace {
+
+// The simulated clock a thread was woken by and hasn't gone back to sleep on
+thread_local const SimulatedClock* wokenBy = nullptr;
+
+} // namespace
+
+Clock& Clock::system() {
+    static SystemClock clock;
+    return clock;
+}
+
+Clock::time_point SystemClock::now() const {
+    return std::chrono::steady_clock::now();
+}
+
+void SystemClock::sleepUntil(time_point deadline, const std::atomic<bool>&) {
+    // Real sleeps are at most one loop period; stop() simply waits them out
+    std::this_thread::sleep_until(deadline);
+}
+
+SimulatedClock::SimulatedClock(time_point start) : now_(start) {}
+
+Clock::time_point SimulatedClock::now() const {
+    std::lock_guard lock(mutex_);
+    return now_;
+}
+
+void SimulatedClock::sleepUntil(time_point deadline, const std::atomic<bool>& running) {
+    std::unique_lock lock(mutex_);
+    if (wokenBy == this) {
+        wokenBy = nullptr;
+        --awake_;
+    }
+    if (!running.load()) {
+        stepCv_.notify_all();
+        return;
+    }
+    if (deadline <= now_) {
+        // Already due (a loop catching up): keep running within this step
+        ++awake_;
+        wokenBy = this;
+        return;
+    }
+
+    auto entry = deadlines_.insert(deadline);
+    stepCv_.notify_all();
+    sleeperCv_.wait(lock, [&] { return now_ >= deadline || !running.load(); });
+    deadlines_.erase(entry);
+
+    if (now_ < deadline) {
+        // Left early for stop(); advance() never counted this thread
+        stepCv_.notify_all();
+    } else if (running.load()) {
+        wokenBy = this;
+    } else {
+        // Woken by advance() but exiting, so it won't sleep again
+        --awake_;
+        stepCv_.notify_all();
+    }
+}
+
+void SimulatedClock::wake() {
+    std::lock_guard lock(mutex_);
+    sleeperCv_.notify_all();
+}
+
+void SimulatedClock::advance(duration d) {
+    advanceTo(now() + d);
+}
+
+void SimulatedClock::advanceTo(time_point target) {
+    std::unique_lock lock(mutex_);
+    for (;;) {
+        stepCv_.wait(lock, [&] { return awake_ == 0; });
+        if (deadlines_.empty() || *deadlines_.begin() > target) break;
+
+        // Step to the earliest deadline and release every thread due by then
+        now_ = *deadlines_.begin();
+        awake_ += static_cast<size_t>(std::distance(deadlines_.begin(), deadlines_.upper_bound(now_)));
+        sleeperCv_.notify_all();
+    }
+    if (target > now_) now_ = target;
+}
+
+bool SimulatedClock::waitForSleepers(size_t count, std::chrono::milliseconds timeout) {
+    std::unique_lock lock(mutex_);
+    return stepCv_.wait_for(lock, timeout, [&] { return deadlines_.size() >= count && awake_ == 0; });
+}
+
+} // namespace photon
@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <set>
+
+namespace photon {
+
+// Time source for the periodic loops (output scheduler, engine, broadcaster,
+// relay). The real clock is steady_clock and the thread's own sleep; tests
+// and benchmarks inject a SimulatedClock and step show time by hand.
+class Clock {
+public:
+    using time_point = std::chrono::steady_clock::time_point;
+    using duration = std::chrono::steady_clock::duration;
+
+    virtual ~Clock() = default;
+
+    virtual time_point now() const = 0;
+
+    // Sleeps until `deadline`. Returns early once `running` is false and
+    // wake() has been called, so a stop() never waits on a simulated sleep.
+    virtual void sleepUntil(time_point deadline, const std::atomic<bool>& running) = 0;
+    void sleepFor(duration d, const std::atomic<bool>& running) { sleepUntil(now() + d, running); }
+
+    // Called by stop() after clearing its running flag
+    virtual void wake() {}
+
+    // The process-wide steady clock
+    static Clock& system();
+};
+
+class SystemClock : public Clock {
+public:
+    time_point now() const override;
+    void sleepUntil(time_point deadline, const std::atomic<bool>& running) override;
+};
+
+// Manually stepped time. Loop threads block in sleepUntil() until advance()
+// moves time past their deadline; advance() wakes them one deadline at a time
+// and waits for each woken thread to finish its work and sleep again, so
+// when it returns every tick due by the new time has run, in order. An hour
+// of 44 Hz output costs only the ticks' own CPU time.
+//
+// Don't stop a component while another thread is inside advance(): a loop
+// that exits mid-step never goes back to sleep and advance() waits for it.
+class SimulatedClock : public Clock {
+public:
+    // A day past the epoch, so default-initialised time points read as long ago
+    static constexpr auto DEFAULT_START = time_point(std::chrono::hours(24));
+
+    explicit SimulatedClock(time_point start = DEFAULT_START);
+
+    time_point now() const override;
+    void sleepUntil(time_point deadline, const std::atomic<bool>& running) override;
+    void wake() override;
+
+    void advance(duration d);
+    void advanceTo(time_point target);
+
+    // Waits, in real time, until `count` threads are asleep on this clock;
+    // call after start() so the first advance() doesn't run without them
+    bool waitForSleepers(size_t count, std::chrono::milliseconds timeout = std::chrono::seconds(5));
+
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable sleeperCv_;  // sleeping loop threads
+    std::condition_variable stepCv_;     // advance() and waitForSleepers()
+    time_point now_;
+    std::multiset<time_point> deadlines_; // one per sleeping thread
+    size_t awake_{0};                     // woken by advance(), not yet asleep again
+};
+
+} // namespace photon
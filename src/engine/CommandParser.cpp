@@ -0,0 +1,241 @@
+#include "engine/CommandParser.h"
+#include <array>
+
+namespace photon::command {
+
+namespace {
+
+// More pairs than a universe has channels is unusual enough for the DOM path
+constexpr size_t MAX_CHANNELS = 512;
+constexpr int MAX_DEPTH = 16;
+
+class Scanner {
+public:
+    explicit Scanner(std::string_view s) : s_(s) {}
+
+    bool consume(char c) {
+        skipSpace();
+        if (p_ < s_.size() && s_[p_] == c) {
+            ++p_;
+            return true;
+        }
+        return false;
+    }
+
+    bool peek(char c) {
+        skipSpace();
+        return p_ < s_.size() && s_[p_] == c;
+    }
+
+    bool atEnd() {
+        skipSpace();
+        return p_ == s_.size();
+    }
+
+    size_t position() const { return p_; }
+
+    // A string without escapes, as a view into the input
+    bool string(std::string_view& out) {
+        if (!consume('"')) return false;
+        size_t start = p_;
+        while (p_ < s_.size()) {
+            char c = s_[p_];
+            if (c == '"') {
+                out = s_.substr(start, p_ - start);
+                ++p_;
+                return true;
+            }
+            if (c == '\\' || static_cast<unsigned char>(c) < 0x20) return false;
+            ++p_;
+        }
+        return false;
+    }
+
+    // A plain non-negative integer no larger than `max`
+    bool integer(uint32_t& out, uint32_t max) {
+        skipSpace();
+        size_t start = p_;
+        uint64_t value = 0;
+        while (p_ < s_.size() && s_[p_] >= '0' && s_[p_] <= '9') {
+            value = value * 10 + static_cast<uint64_t>(s_[p_] - '0');
+            if (value > max) return false;
+            ++p_;
+        }
+        if (p_ == start) return false;
+        if (p_ < s_.size() && (s_[p_] == '.' || s_[p_] == 'e' || s_[p_] == 'E')) return false;
+        out = static_cast<uint32_t>(value);
+        return true;
+    }
+
+    // Skips any JSON value, escapes included
+    bool skipValue(int depth = 0) {
+        skipSpace();
+        if (p_ >= s_.size() || depth > MAX_DEPTH) return false;
+        char c = s_[p_];
+        if (c == '"') {
+            for (++p_; p_ < s_.size(); ++p_) {
+                if (s_[p_] == '\\') ++p_;
+                else if (s_[p_] == '"') {
+                    ++p_;
+                    return true;
+                }
+            }
+            return false;
+        }
+        if (c == '{' || c == '[') {
+            char close = c == '{' ? '}' : ']';
+            ++p_;
+            if (consume(close)) return true;
+            do {
+                if (c == '{' && (!skipValue(depth + 1) || !consume(':'))) return false;
+                if (!skipValue(depth + 1)) return false;
+            } while (consume(','));
+            return consume(close);
+        }
+        // Number or literal
+        size_t start = p_;
+        while (p_ < s_.size()) {
+            char ch = s_[p_];
+            bool literal = (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'z') ||
+                           ch == '-' || ch == '+' || ch == '.' || ch == 'E';
+            if (!literal) break;
+            ++p_;
+        }
+        return p_ > start;
+    }
+
+private:
+    void skipSpace() {
+        while (p_ < s_.size() && (s_[p_] == ' ' || s_[p_] == '\t' || s_[p_] == '\n' || s_[p_] == '\r')) ++p_;
+    }
+
+    std::string_view s_;
+    size_t p_{0};
+};
+
+// Calls onField(key) with the scanner positioned at each member's value; the
+// callback must consume the value.
+template <typename F>
+bool object(Scanner& sc, F&& onField) {
+    if (!sc.consume('{')) return false;
+    if (sc.consume('}')) return true;
+    do {
+        std::string_view key;
+        if (!sc.string(key) || !sc.consume(':')) return false;
+        if (!onField(key)) return false;
+    } while (sc.consume(','));
+    return sc.consume('}');
+}
+
+struct ChannelBuffer {
+    std::array<action::SetChannel, MAX_CHANNELS> items;
+    size_t count{0};
+
+    bool add(uint32_t channel, uint32_t value) {
+        if (count == items.size()) return false;
+        items[count++] = action::SetChannel{0, static_cast<uint16_t>(channel), static_cast<uint8_t>(value)};
+        return true;
+    }
+
+    void push(uint16_t universe, InputCoalescer& input) {
+        for (size_t i = 0; i < count; ++i) items[i].universe = universe;
+        input.push(items.begin(), items.begin() + count);
+    }
+};
+
+// [[channel, value], ...] or {"channel": value, ...}
+bool channelList(Scanner& sc, ChannelBuffer& out) {
+    if (sc.peek('{')) {
+        return object(sc, [&](std::string_view key) {
+            uint32_t channel = 0, value = 0;
+            Scanner keyScanner(key);
+            return keyScanner.integer(channel, 0xFFFF) && keyScanner.atEnd() &&
+                   sc.integer(value, 255) && out.add(channel, value);
+        });
+    }
+    if (!sc.consume('[')) return false;
+    if (sc.consume(']')) return true;
+    do {
+        uint32_t channel = 0, value = 0;
+        if (!sc.consume('[') || !sc.integer(channel, 0xFFFF) || !sc.consume(',') ||
+            !sc.integer(value, 255) || !sc.consume(']') || !out.add(channel, value)) {
+            return false;
+        }
+    } while (sc.consume(','));
+    return sc.consume(']');
+}
+
+struct Fields {
+    std::string_view type;
+    bool hasUniverse{false}, hasChannel{false}, hasValue{false}, hasChannels{false};
+    uint32_t universe{0}, channel{0}, value{0};
+    ChannelBuffer channels;
+    // Relay envelopes: byte range of the "data" object
+    size_t dataBegin{0}, dataEnd{0};
+};
+
+bool parseFields(std::string_view message, Fields& f) {
+    Scanner sc(message);
+    bool ok = object(sc, [&](std::string_view key) {
+        if (key == "type") return sc.string(f.type);
+        if (key == "universe") return f.hasUniverse = sc.integer(f.universe, 0xFFFF);
+        if (key == "channel") return f.hasChannel = sc.integer(f.channel, 0xFFFF);
+        if (key == "value") return f.hasValue = sc.integer(f.value, 255);
+        if (key == "channels") return f.hasChannels = channelList(sc, f.channels);
+        if (key == "data" && sc.peek('{')) {
+            f.dataBegin = sc.position();
+            bool skipped = sc.skipValue();
+            f.dataEnd = sc.position();
+            return skipped;
+        }
+        return sc.skipValue();
+    });
+    return ok && sc.atEnd();
+}
+
+} // namespace
+
+Type parse(std::string_view message, InputCoalescer& input) {
+    Fields f;
+    if (!parseFields(message, f)) return Type::None;
+
+    if (f.type == "set_channel" && f.hasUniverse && f.hasChannel && f.hasValue) {
+        input.push(action::SetChannel{
+            static_cast<uint16_t>(f.universe),
+            static_cast<uint16_t>(f.channel),
+            static_cast<uint8_t>(f.value)
+        });
+        return Type::SetChannel;
+    }
+    if (f.type == "set_channels" && f.hasUniverse && f.hasChannels) {
+        f.channels.push(static_cast<uint16_t>(f.universe), input);
+        return Type::SetChannels;
+    }
+    if (f.type == "blackout") {
+        input.push(action::Blackout{});
+        return Type::Blackout;
+    }
+    return Type::None;
+}
+
+Type parseRelayCommand(std::string_view message, InputCoalescer& input) {
+    Fields f;
+    if (!parseFields(message, f) || f.type != "command" || f.dataEnd == 0) return Type::None;
+    return parse(message.substr(f.dataBegin, f.dataEnd - f.dataBegin), input);
+}
+
+bool parseChannelValue(std::string_view body, uint8_t& value) {
+    Fields f;
+    if (!parseFields(body, f) || !f.hasValue) return false;
+    value = static_cast<uint8_t>(f.value);
+    return true;
+}
+
+bool parseChannelMap(std::string_view body, uint16_t universe, InputCoalescer& input) {
+    Fields f;
+    if (!parseFields(body, f) || !f.hasChannels) return false;
+    f.channels.push(universe, input);
+    return true;
+}
+
+} // namespace photon::command
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include "engine/InputCoalescer.h"
+
+// Allocation-free fast path for the control messages that arrive at fader
+// rate. It understands only the small command grammar and writes straight
+// into the input stage; anything it does not recognise (other message
+// types, string escapes, non-integer numbers, malformed JSON) is reported as
+// unhandled with nothing queued, and the caller falls back to the DOM parser.
+namespace photon::command {
+
+enum class Type {
+    None,        // not handled, use the DOM parser
+    SetChannel,  // {"type":"set_channel","universe":0,"channel":5,"value":255}
+    SetChannels, // {"type":"set_channels","universe":0,"channels":[[5,255],[6,0]]}
+    Blackout,    // {"type":"blackout"}
+};
+
+// A WebSocket command object.
+Type parse(std::string_view message, InputCoalescer& input);
+
+// A relay envelope {"type":"command","data":{...}} wrapping a command object.
+Type parseRelayCommand(std::string_view message, InputCoalescer& input);
+
+// REST bodies: {"value":255} for a single channel, and {"channels":{"5":255}}
+// (or the [[5,255]] pair form) for several channels of `universe`.
+bool parseChannelValue(std::string_view body, uint8_t& value);
+bool parseChannelMap(std::string_view body, uint16_t universe, InputCoalescer& input);
+
+} // namespace photon::command
@@ -0,0 +1,19 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace photon {
+
+// Notified by OutputScheduler once per tick with the frames that were sent.
+// Called on the real-time output thread — implementations must not block.
+class FrameObserver {
+public:
+    virtual ~FrameObserver() = default;
+
+    virtual void onOutputFrame(std::chrono::steady_clock::time_point tick,
+                               const std::vector<std::array<uint8_t, 512>>& frames) = 0;
+};
+
+} // namespace photon
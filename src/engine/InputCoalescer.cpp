@@ -0,0 +1,121 @@
+#include "engine/InputCoalescer.h"
+
+namespace photon {
+
+InputCoalescer::InputCoalescer(uint16_t universeCount)
+    : universeCount_(universeCount),
+      slots_(static_cast<size_t>(SourcePriority::COUNT) * universeCount) {}
+
+void InputCoalescer::push(const Action& action) {
+    std::lock_guard lock(mutex_);
+    apply(action);
+}
+
+void InputCoalescer::push(const action::SetChannel& write) {
+    std::lock_guard lock(mutex_);
+    apply(write);
+}
+
+void InputCoalescer::push(const action::Blackout& blackout) {
+    std::lock_guard lock(mutex_);
+    apply(blackout);
+}
+
+void InputCoalescer::pushRuns(const ChannelRun* runs, size_t count, bool blackoutFirst) {
+    std::lock_guard lock(mutex_);
+    if (blackoutFirst) apply(action::Blackout{});
+    for (size_t r = 0; r < count; ++r) {
+        const auto& run = runs[r];
+        for (uint16_t i = 0; i < run.count; ++i) {
+            apply(action::SetChannel{run.universe, static_cast<uint16_t>(run.start + i),
+                                     run.values[i], run.source});
+        }
+    }
+}
+
+void InputCoalescer::apply(const Action& action) {
+    std::visit([this](const auto& a) { apply(a); }, action);
+}
+
+void InputCoalescer::apply(const action::SetChannel& write) {
+    if (write.universe >= universeCount_ || write.channel >= 512 ||
+        write.source >= SourcePriority::COUNT) {
+        return;
+    }
+    ++writes_;
+    markPending();
+
+    auto index = static_cast<uint32_t>(static_cast<size_t>(write.source) * universeCount_ + write.universe);
+    auto& slot = slots_[index];
+    if (!slot) slot = std::make_unique<Slot>();
+
+    if (slot->touched.empty()) dirtySlots_.push_back(index);
+    if (slot->dirty.test(write.channel)) {
+        ++coalesced_;
+    } else {
+        slot->dirty.set(write.channel);
+        slot->touched.push_back(write.channel);
+        ++pending_;
+    }
+    slot->values[write.channel] = write.value;
+}
+
+void InputCoalescer::apply(const action::Blackout&) {
+    markPending();
+    for (auto index : dirtySlots_) {
+        auto& slot = *slots_[index];
+        slot.dirty.reset();
+        slot.touched.clear();
+    }
+    dirtySlots_.clear();
+    coalesced_ += pending_;
+    pending_ = 0;
+    blackout_ = true;
+}
+
+void InputCoalescer::markPending() {
+    if (!blackout_ && dirtySlots_.empty()) since_ = std::chrono::steady_clock::now();
+}
+
+bool InputCoalescer::drain(CoalescedBatch& out) {
+    out.clear();
+    std::lock_guard lock(mutex_);
+    if (!blackout_ && dirtySlots_.empty()) return false;
+
+    out.blackout = blackout_;
+    out.since = since_;
+    blackout_ = false;
+    out.channels.reserve(pending_);
+    out.values.reserve(pending_);
+    for (auto index : dirtySlots_) {
+        auto& slot = *slots_[index];
+        CoalescedBatch::Run run{
+            static_cast<uint16_t>(index % universeCount_),
+            static_cast<SourcePriority>(index / universeCount_),
+            static_cast<uint32_t>(out.channels.size()),
+            static_cast<uint16_t>(slot.touched.size())
+        };
+        for (auto ch : slot.touched) {
+            out.channels.push_back(ch);
+            out.values.push_back(slot.values[ch]);
+        }
+        out.runs.push_back(run);
+        slot.dirty.reset();
+        slot.touched.clear();
+    }
+    dirtySlots_.clear();
+    pending_ = 0;
+    return true;
+}
+
+bool InputCoalescer::empty() const {
+    std::lock_guard lock(mutex_);
+    return !blackout_ && dirtySlots_.empty();
+}
+
+InputCoalescer::Stats InputCoalescer::getStats() const {
+    std::lock_guard lock(mutex_);
+    return Stats{writes_, coalesced_, pending_};
+}
+
+} // namespace photon
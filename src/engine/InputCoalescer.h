@@ -0,0 +1,109 @@
+#pragma once
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "engine/Action.h"
+
+namespace photon {
+
+// Contiguous values for one universe, viewed in place (e.g. in a request body)
+struct ChannelRun {
+    uint16_t universe;
+    uint16_t start;
+    uint16_t count;
+    const uint8_t* values;
+    SourcePriority source{SourcePriority::Programmer};
+};
+
+// One drain of InputCoalescer: an optional blackout, applied first, then
+// one run of channel writes per (universe, source) that was touched.
+struct CoalescedBatch {
+    struct Run {
+        uint16_t universe;
+        SourcePriority source;
+        uint32_t offset; // into channels/values
+        uint16_t count;
+    };
+
+    bool blackout{false};
+    // When the oldest input in the batch arrived
+    std::chrono::steady_clock::time_point since;
+    std::vector<Run> runs;
+    std::vector<uint16_t> channels;
+    std::vector<uint8_t> values;
+
+    void clear() {
+        blackout = false;
+        runs.clear();
+        channels.clear();
+        values.clear();
+    }
+};
+
+// Ingest-side last-write-wins stage between the web/relay producers and the
+// engine. A channel write replaces any pending value for the same
+// (source, universe, channel), so the pending set — and the engine's work per
+// iteration — is bounded by the number of touched channels rather than by the
+// message rate. A blackout discards every write queued before it.
+class InputCoalescer {
+public:
+    struct Stats {
+        uint64_t writes{0};
+        uint64_t coalesced{0}; // writes overwritten or discarded before the engine saw them
+        size_t pending{0};
+    };
+
+    explicit InputCoalescer(uint16_t universeCount);
+
+    void push(const Action& action);
+    void push(const action::SetChannel& write);
+    void push(const action::Blackout& blackout);
+
+    // Writes every run under one lock, so they all reach the engine — and the
+    // output — in the same batch; with blackoutFirst the blackout is part of
+    // that batch too
+    void pushRuns(const ChannelRun* runs, size_t count, bool blackoutFirst = false);
+
+    // Applies a batch under a single lock
+    template <typename It>
+    void push(It first, It last) {
+        std::lock_guard lock(mutex_);
+        for (; first != last; ++first) apply(*first);
+    }
+
+    // Moves everything pending into `out` (cleared first); false if there was
+    // nothing to do.
+    bool drain(CoalescedBatch& out);
+
+    bool empty() const;
+    Stats getStats() const;
+
+private:
+    struct Slot {
+        std::array<uint8_t, 512> values{};
+        std::bitset<512> dirty;
+        std::vector<uint16_t> touched; // dirty channels in first-write order
+    };
+
+    void apply(const Action& action);
+    void apply(const action::SetChannel& write);
+    void apply(const action::Blackout& blackout);
+    void markPending();
+
+    uint16_t universeCount_;
+    mutable std::mutex mutex_;
+    // Indexed by source * universeCount + universe, allocated on first write
+    std::vector<std::unique_ptr<Slot>> slots_;
+    std::vector<uint32_t> dirtySlots_;
+    bool blackout_{false};
+    std::chrono::steady_clock::time_point since_;
+    size_t pending_{0};
+    uint64_t writes_{0};
+    uint64_t coalesced_{0};
+};
+
+} // namespace photon
@@ -1,25 +1,82 @@
 #include "engine/MergeBuffer.h"
+#include "engine/InputCoalescer.h"
+#include "metrics/Trace.h"
+#include <algorithm>
+#include <mutex>
 
 namespace photon {
 
 MergeBuffer::MergeBuffer(uint16_t universeCount)
-    : universes_(universeCount) {}
+    : universes_(universeCount), versions_(universeCount, 0) {}
 
 void MergeBuffer::setValue(uint16_t universe, uint16_t channel, uint8_t value, SourcePriority priority) {
+    PHOTON_TRACE_SCOPE_ARG("merge.setValue", "universe", universe);
     std::unique_lock lock(mutex_);
     if (universe >= universes_.size()) return;
     universes_[universe].setValue(channel, value, priority);
+    versions_[universe] = ++version_;
+}
+
+void MergeBuffer::setValues(uint16_t universe, uint16_t startChannel, const uint8_t* values,
+                            uint16_t count, SourcePriority priority) {
+    PHOTON_TRACE_SCOPE_ARG("merge.setValues", "universe", universe);
+    std::unique_lock lock(mutex_);
+    if (universe >= universes_.size()) return;
+    universes_[universe].setValues(startChannel, values, count, priority);
+    versions_[universe] = ++version_;
+}
+
+void MergeBuffer::setChannels(uint16_t universe, const uint16_t* channels, const uint8_t* values,
+                              size_t count, SourcePriority priority) {
+    PHOTON_TRACE_SCOPE_ARG("merge.setChannels", "universe", universe);
+    std::unique_lock lock(mutex_);
+    if (universe >= universes_.size()) return;
+    auto& u = universes_[universe];
+    for (size_t i = 0; i < count; ++i) u.setValue(channels[i], values[i], priority);
+    versions_[universe] = ++version_;
+}
+
+void MergeBuffer::apply(const CoalescedBatch& batch) {
+    PHOTON_TRACE_SCOPE_ARG("merge.apply", "channels", batch.channels.size());
+    std::unique_lock lock(mutex_);
+    if (batch.blackout) {
+        for (auto& u : universes_) u.blackout();
+        ++version_;
+        std::fill(versions_.begin(), versions_.end(), version_);
+    }
+    for (const auto& run : batch.runs) {
+        if (run.universe >= universes_.size()) continue;
+        auto& u = universes_[run.universe];
+        for (uint32_t i = run.offset; i < run.offset + run.count; ++i) {
+            u.setValue(batch.channels[i], batch.values[i], run.source);
+        }
+        versions_[run.universe] = ++version_;
+    }
+}
+
+void MergeBuffer::setRuns(const ChannelRun* runs, size_t count) {
+    PHOTON_TRACE_SCOPE_ARG("merge.setRuns", "runs", count);
+    std::unique_lock lock(mutex_);
+    for (size_t i = 0; i < count; ++i) {
+        const auto& run = runs[i];
+        if (run.universe >= universes_.size()) continue;
+        universes_[run.universe].setValues(run.start, run.values, run.count, run.source);
+        versions_[run.universe] = ++version_;
+    }
 }
 
 void MergeBuffer::clearPriority(uint16_t universe, SourcePriority priority) {
     std::unique_lock lock(mutex_);
     if (universe >= universes_.size()) return;
     universes_[universe].clearPriority(priority);
+    versions_[universe] = ++version_;
 }
 
 void MergeBuffer::blackout() {
     std::unique_lock lock(mutex_);
     for (auto& u : universes_) u.blackout();
+    ++version_;
+    std::fill(versions_.begin(), versions_.end(), version_);
 }
 
 std::array<uint8_t, 512> MergeBuffer::getOutput(uint16_t universe) const {
@@ -36,6 +93,69 @@ bool MergeBuffer::tryGetOutput(uint16_t universe, std::array<uint8_t, 512>& out)
     return true;
 }
 
+bool MergeBuffer::tryGetOutputs(std::vector<std::array<uint8_t, 512>>& out) const {
+    PHOTON_TRACE_SCOPE("merge.snapshot");
+    std::shared_lock lock(mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) return false;
+    out.resize(universes_.size());
+    for (size_t u = 0; u < universes_.size(); ++u) out[u] = universes_[u].getOutput();
+    return true;
+}
+
+uint64_t MergeBuffer::getVersion() const {
+    std::shared_lock lock(mutex_);
+    return version_;
+}
+
+uint64_t MergeBuffer::getUniverseVersion(uint16_t universe) const {
+    std::shared_lock lock(mutex_);
+    if (universe >= universes_.size()) return 0;
+    return versions_[universe];
+}
+
+uint64_t MergeBuffer::getOutput(uint16_t universe, std::array<uint8_t, 512>& out) const {
+    std::shared_lock lock(mutex_);
+    if (universe >= universes_.size()) {
+        out.fill(0);
+        return 0;
+    }
+    out = universes_[universe].getOutput();
+    return versions_[universe];
+}
+
+uint64_t MergeBuffer::capturePlanes(std::vector<Universe::Planes>& out, uint64_t sinceVersion,
+                                    std::vector<uint16_t>* changed) const {
+    PHOTON_TRACE_SCOPE("merge.capturePlanes");
+    if (changed) changed->clear();
+    std::shared_lock lock(mutex_);
+    // A fresh `out` holds nothing yet, so everything is copied once
+    bool all = out.size() != universes_.size();
+    if (all) out.resize(universes_.size());
+    for (size_t u = 0; u < universes_.size(); ++u) {
+        if (!all && versions_[u] <= sinceVersion) continue;
+        universes_[u].savePlanes(out[u]);
+        if (changed) changed->push_back(static_cast<uint16_t>(u));
+    }
+    return version_;
+}
+
+void MergeBuffer::restorePlanes(const Universe::Planes* planes, size_t count) {
+    std::unique_lock lock(mutex_);
+    for (size_t u = 0; u < universes_.size(); ++u) {
+        if (u < count) universes_[u].loadPlanes(planes[u]);
+        else universes_[u].blackout();
+    }
+    ++version_;
+    std::fill(versions_.begin(), versions_.end(), version_);
+}
+
+void MergeBuffer::setPlanes(uint16_t universe, const Universe::Planes& planes) {
+    std::unique_lock lock(mutex_);
+    if (universe >= universes_.size()) return;
+    universes_[universe].loadPlanes(planes);
+    versions_[universe] = ++version_;
+}
+
 uint16_t MergeBuffer::getUniverseCount() const {
     return static_cast<uint16_t>(universes_.size());
 }
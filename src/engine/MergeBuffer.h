@@ -8,16 +8,54 @@
 
 namespace photon {
 
+struct ChannelRun;
+struct CoalescedBatch;
+
 class MergeBuffer {
 public:
     explicit MergeBuffer(uint16_t universeCount = 4);
 
     void setValue(uint16_t universe, uint16_t channel, uint8_t value, SourcePriority priority);
+    void setValues(uint16_t universe, uint16_t startChannel, const uint8_t* values, uint16_t count,
+                   SourcePriority priority);
+    // Sparse writes to one universe under a single lock and version bump
+    void setChannels(uint16_t universe, const uint16_t* channels, const uint8_t* values, size_t count,
+                     SourcePriority priority);
+    // A drained InputCoalescer batch, applied under one lock so the output
+    // never shows part of it
+    void apply(const CoalescedBatch& batch);
+    // Contiguous runs over any number of universes, under one lock, so a
+    // whole pixel frame lands in a single output tick
+    void setRuns(const ChannelRun* runs, size_t count);
     void clearPriority(uint16_t universe, SourcePriority priority);
     void blackout();
 
     std::array<uint8_t, 512> getOutput(uint16_t universe) const;
     bool tryGetOutput(uint16_t universe, std::array<uint8_t, 512>& out) const;
+    // Every universe from one consistent state; false (out untouched) if a
+    // writer holds the lock
+    bool tryGetOutputs(std::vector<std::array<uint8_t, 512>>& out) const;
+
+    // Every write bumps a buffer-wide counter and stamps the universe with it,
+    // so a universe changed since V exactly when its version is greater than V.
+    uint64_t getVersion() const;
+    uint64_t getUniverseVersion(uint16_t universe) const;
+    // Output together with the version it reflects, read under one lock.
+    uint64_t getOutput(uint16_t universe, std::array<uint8_t, 512>& out) const;
+
+    // Brings `out` (one entry per universe) up to date with the current
+    // priority planes and returns the version it now reflects. Only universes
+    // written after `sinceVersion` are copied, so passing the previous return
+    // value keeps the shared lock short even with thousands of universes. An
+    // `out` of the wrong size is resized and copied in full.
+    // `changed`, if given, receives the universes that were copied.
+    uint64_t capturePlanes(std::vector<Universe::Planes>& out, uint64_t sinceVersion,
+                           std::vector<uint16_t>* changed = nullptr) const;
+    // Replaces the planes of the first `count` universes (the rest are
+    // cleared) as a single write.
+    void restorePlanes(const Universe::Planes* planes, size_t count);
+    // Replaces one universe's planes
+    void setPlanes(uint16_t universe, const Universe::Planes& planes);
 
     uint16_t getUniverseCount() const;
     bool isUniverseDirty(uint16_t universe) const;
@@ -26,6 +64,8 @@ public:
 private:
     mutable std::shared_mutex mutex_;
     std::vector<Universe> universes_;
+    std::vector<uint64_t> versions_;
+    uint64_t version_{0};
 };
 
 } // namespace photon
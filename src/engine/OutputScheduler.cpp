@@ -1,17 +1,30 @@
 #include "engine/OutputScheduler.h"
 #include "protocol/DeviceManager.h"
+#include "metrics/Metrics.h"
+#include "metrics/Trace.h"
+#include "engine/ThreadPlacement.h"
 #include <spdlog/spdlog.h>
+#include <algorithm>
 #include <chrono>
 
-#ifndef _WIN32
-#include <pthread.h>
-#include <sched.h>
-#endif
-
 namespace photon {
 
-OutputScheduler::OutputScheduler(MergeBuffer& mergeBuffer, DeviceManager& deviceManager)
-    : mergeBuffer_(mergeBuffer), deviceManager_(deviceManager) {}
+namespace {
+
+metrics::Histogram tickSeconds{"photon_output_tick_seconds",
+    "Time spent snapshotting and sending one output tick",
+    {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05}};
+metrics::Histogram tickLatenessSeconds{"photon_output_tick_lateness_seconds",
+    "How far past its scheduled time each output tick started",
+    {0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025}};
+metrics::Counter snapshotMisses{"photon_output_snapshot_misses_total",
+    "Ticks that resent the previous frame because the merge buffer was busy"};
+metrics::Counter ticksTotal{"photon_output_ticks_total", "Output ticks run"};
+
+} // namespace
+
+OutputScheduler::OutputScheduler(MergeBuffer& mergeBuffer, DeviceManager& deviceManager, Clock& clock)
+    : mergeBuffer_(mergeBuffer), deviceManager_(deviceManager), clock_(clock) {}
 
 OutputScheduler::~OutputScheduler() {
     stop();
@@ -28,6 +41,7 @@ void OutputScheduler::start() {
 
 void OutputScheduler::stop() {
     running_.store(false);
+    clock_.wake();
     if (thread_.joinable()) thread_.join();
 }
 
@@ -43,45 +57,88 @@ double OutputScheduler::getRefreshRate() const {
     return refreshHz_.load();
 }
 
-void OutputScheduler::run() {
-#ifndef _WIN32
-    sched_param param{};
-    param.sched_priority = 80;
-    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
-        spdlog::warn("Could not set real-time thread priority (run as root for RT scheduling)");
-    }
-#endif
+void OutputScheduler::setOutputEnabled(bool enabled) {
+    outputEnabled_.store(enabled);
+}
+
+bool OutputScheduler::isOutputEnabled() const {
+    return outputEnabled_.load();
+}
+
+void OutputScheduler::addObserver(FrameObserver* observer) {
+    std::lock_guard lock(observerMutex_);
+    observers_.push_back(observer);
+}
+
+void OutputScheduler::removeObserver(FrameObserver* observer) {
+    std::lock_guard lock(observerMutex_);
+    observers_.erase(
+        std::remove(observers_.begin(), observers_.end(), observer),
+        observers_.end()
+    );
+}
 
+void OutputScheduler::run() {
+    // SCHED_FIFO 80 unless --thread output=... says otherwise
+    placement::apply(placement::Role::Output, "output");
+    trace::setThreadName("output");
     spdlog::info("Output scheduler started at {:.0f} Hz", refreshHz_.load());
 
-    using clock = std::chrono::steady_clock;
-    auto nextTick = clock::now();
+    auto nextTick = clock_.now();
 
     while (running_.load()) {
         double hz = refreshHz_.load();
         auto interval = std::chrono::microseconds(static_cast<long>(1'000'000.0 / hz));
+        auto tickStart = clock_.now();
+        // nextTick is the time this tick was due; the sleep below wakes at it
+        tickLatenessSeconds.observe(
+            std::max(0.0, std::chrono::duration<double>(tickStart - nextTick).count()));
         nextTick += interval;
+        {
+            PHOTON_TRACE_SCOPE("output.tick");
 
-        uint16_t universeCount = mergeBuffer_.getUniverseCount();
-        if (lastFrames_.size() < universeCount) {
-            lastFrames_.resize(universeCount);
-        }
-
-        for (uint16_t u = 0; u < universeCount; ++u) {
-            std::array<uint8_t, 512> frame{};
-            if (mergeBuffer_.tryGetOutput(u, frame)) {
-                lastFrames_[u] = frame;
+            uint16_t universeCount = mergeBuffer_.getUniverseCount();
+            if (lastFrames_.size() < universeCount) {
+                lastFrames_.resize(universeCount);
             }
 
-            auto devices = deviceManager_.getDevicesForUniverse(u);
-            for (auto& device : devices) {
-                if (device->isOpen()) {
-                    device->send(u, lastFrames_[u]);
+            // One consistent snapshot for the whole tick, so a multi-universe
+            // write lands in a single output frame; on contention resend the last
+            if (!mergeBuffer_.tryGetOutputs(lastFrames_)) snapshotMisses.inc();
+
+            tickDevices_.clear();
+            bool sending = outputEnabled_.load(std::memory_order_relaxed);
+            for (uint16_t u = 0; sending && u < universeCount; ++u) {
+                auto devices = deviceManager_.getDevicesForUniverse(u);
+                for (auto& device : devices) {
+                    if (device->isOpen()) {
+                        PHOTON_TRACE_SCOPE_ARG("device.send", "universe", u);
+                        device->send(u, lastFrames_[u]);
+                        if (std::find(tickDevices_.begin(), tickDevices_.end(), device) == tickDevices_.end()) {
+                            tickDevices_.push_back(device);
+                        }
+                    }
                 }
             }
+
+            // One flush per device lets batching transports submit the whole tick at once
+            for (auto& device : tickDevices_) {
+                PHOTON_TRACE_SCOPE("device.flush");
+                device->flush();
+            }
+        }
+        tickSeconds.observe(std::chrono::duration<double>(clock_.now() - tickStart).count());
+        ticksTotal.inc();
+
+        {
+            PHOTON_TRACE_SCOPE("output.observers");
+            std::lock_guard lock(observerMutex_);
+            for (auto* obs : observers_) {
+                obs->onOutputFrame(nextTick - interval, lastFrames_);
+            }
         }
 
-        std::this_thread::sleep_until(nextTick);
+        clock_.sleepUntil(nextTick, running_);
     }
 
     spdlog::info("Output scheduler stopped");
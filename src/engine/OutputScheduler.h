@@ -3,19 +3,24 @@
 #include <atomic>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
+#include "engine/Clock.h"
+#include "engine/FrameObserver.h"
 #include "engine/MergeBuffer.h"
 
 namespace photon {
 
 class DeviceManager;
+class OutputDevice;
 
 class OutputScheduler {
 public:
     static constexpr double DEFAULT_REFRESH_HZ = 44.0;
 
-    OutputScheduler(MergeBuffer& mergeBuffer, DeviceManager& deviceManager);
+    OutputScheduler(MergeBuffer& mergeBuffer, DeviceManager& deviceManager,
+                    Clock& clock = Clock::system());
     ~OutputScheduler();
 
     void start();
@@ -25,15 +30,29 @@ public:
     void setRefreshRate(double hz);
     double getRefreshRate() const;
 
+    // A hot standby keeps ticking (observers still see every frame) but
+    // sends nothing to devices until it takes over
+    void setOutputEnabled(bool enabled);
+    bool isOutputEnabled() const;
+
+    void addObserver(FrameObserver* observer);
+    void removeObserver(FrameObserver* observer);
+
 private:
     void run();
 
     MergeBuffer& mergeBuffer_;
     DeviceManager& deviceManager_;
+    Clock& clock_;
     std::thread thread_;
     std::atomic<bool> running_{false};
     std::atomic<double> refreshHz_{DEFAULT_REFRESH_HZ};
+    std::atomic<bool> outputEnabled_{true};
     std::vector<std::array<uint8_t, 512>> lastFrames_;
+    std::vector<std::shared_ptr<OutputDevice>> tickDevices_;
+
+    std::mutex observerMutex_;
+    std::vector<FrameObserver*> observers_;
 };
 
 } // namespace photon
@@ -0,0 +1,45 @@
+#include "engine/PlaneCodec.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace photon::planecodec {
+
+uint8_t planeMask(const Universe::Planes& planes) {
+    uint8_t mask = 0;
+    for (size_t p = 0; p < Universe::NUM_PRIORITIES; ++p) {
+        const auto& active = planes.active[p];
+        if (std::any_of(active.begin(), active.end(), [](uint8_t b) { return b != 0; })) {
+            mask |= static_cast<uint8_t>(1u << p);
+        }
+    }
+    return mask;
+}
+
+size_t encodedSize(uint8_t mask) {
+    return static_cast<size_t>(std::popcount(mask)) * PLANE_SIZE;
+}
+
+void encode(const Universe::Planes& planes, uint8_t mask, uint8_t* out) {
+    for (size_t p = 0; p < Universe::NUM_PRIORITIES; ++p) {
+        if (!(mask & (1u << p))) continue;
+        std::memcpy(out, planes.active[p].data(), ACTIVE_BYTES);
+        std::memcpy(out + ACTIVE_BYTES, planes.values[p].data(), Universe::NUM_CHANNELS);
+        out += PLANE_SIZE;
+    }
+}
+
+const uint8_t* decode(const uint8_t* data, const uint8_t* end, uint8_t mask, Universe::Planes& planes) {
+    for (size_t p = 0; p < 8; ++p) {
+        if (!(mask & (1u << p))) continue;
+        if (static_cast<size_t>(end - data) < PLANE_SIZE) return nullptr;
+        if (p < Universe::NUM_PRIORITIES) {
+            std::memcpy(planes.active[p].data(), data, ACTIVE_BYTES);
+            std::memcpy(planes.values[p].data(), data + ACTIVE_BYTES, Universe::NUM_CHANNELS);
+        }
+        data += PLANE_SIZE;
+    }
+    return data;
+}
+
+} // namespace photon::planecodec
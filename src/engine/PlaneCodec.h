@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "engine/Universe.h"
+
+// Serialised form of Universe::Planes, shared by show snapshots and hot-standby
+// replication (host byte order). A u8 plane mask has a bit per priority with
+// any active channel; for each set bit, lowest priority first, one plane
+// follows: the active bitmap, then the values.
+namespace photon::planecodec {
+
+inline constexpr size_t ACTIVE_BYTES = Universe::NUM_CHANNELS / 8;
+inline constexpr size_t PLANE_SIZE = ACTIVE_BYTES + Universe::NUM_CHANNELS;
+// Every bit of the mask set
+inline constexpr size_t MAX_SIZE = 8 * PLANE_SIZE;
+
+uint8_t planeMask(const Universe::Planes& planes);
+
+// Bytes the planes selected by `mask` take
+size_t encodedSize(uint8_t mask);
+
+// Writes the planes selected by `mask` to `out`, which must hold
+// encodedSize(mask) bytes.
+void encode(const Universe::Planes& planes, uint8_t mask, uint8_t* out);
+
+// Reads the planes selected by `mask` from [data, end) into `planes`; priorities
+// this build does not know are skipped. Returns the position after the last
+// plane, or nullptr if the input is too short.
+const uint8_t* decode(const uint8_t* data, const uint8_t* end, uint8_t mask, Universe::Planes& planes);
+
+} // namespace photon::planecodec
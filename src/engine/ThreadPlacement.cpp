@@ -0,0 +1,286 @@
+#include "engine/ThreadPlacement.h"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <mutex>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace photon::placement {
+
+namespace {
+
+// Bytes of stack each placed thread touches up front, so the first deep call
+// on the hot path does not take page faults
+constexpr size_t PREFAULT_STACK_BYTES = 256 * 1024;
+
+constexpr size_t ROLE_COUNT = static_cast<size_t>(Role::COUNT);
+
+std::array<ThreadPolicy, ROLE_COUNT> defaultPolicies() {
+    std::array<ThreadPolicy, ROLE_COUNT> policies{};
+    policies[static_cast<size_t>(Role::Output)] = ThreadPolicy{{}, Sched::Fifo, 80};
+    return policies;
+}
+
+std::mutex mutex;
+std::array<ThreadPolicy, ROLE_COUNT> policies = defaultPolicies();
+std::vector<ThreadReport> reports;
+std::atomic<bool> locked{false};
+
+bool parseInt(std::string_view text, int& out) {
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+    return ec == std::errc() && ptr == text.data() + text.size();
+}
+
+bool parseCpus(std::string_view text, std::vector<int>& cpus) {
+    cpus.clear();
+    if (text == "*") return true;
+    while (!text.empty()) {
+        auto comma = text.find(',');
+        auto item = text.substr(0, comma);
+        text = comma == std::string_view::npos ? std::string_view{} : text.substr(comma + 1);
+
+        int first = 0, last = 0;
+        auto dash = item.find('-');
+        if (dash == std::string_view::npos) {
+            if (!parseInt(item, first)) return false;
+            last = first;
+        } else if (!parseInt(item.substr(0, dash), first) || !parseInt(item.substr(dash + 1), last)) {
+            return false;
+        }
+        if (first < 0 || last < first || last >= 1024) return false;
+        for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return !cpus.empty();
+}
+
+long currentTid() {
+#ifdef __linux__
+    return static_cast<long>(syscall(SYS_gettid));
+#else
+    return 0;
+#endif
+}
+
+#ifndef _WIN32
+[[gnu::noinline]] void prefaultStack() {
+    volatile char stack[PREFAULT_STACK_BYTES];
+    for (size_t i = 0; i < sizeof(stack); i += 4096) stack[i] = 0;
+}
+
+int toNative(Sched sched) {
+    switch (sched) {
+        case Sched::Fifo: return SCHED_FIFO;
+        case Sched::RoundRobin: return SCHED_RR;
+        default: return SCHED_OTHER;
+    }
+}
+
+const char* nativeName(int policy) {
+    if (policy == SCHED_FIFO) return "fifo";
+    if (policy == SCHED_RR) return "rr";
+    return "other";
+}
+#endif
+
+void appendError(std::string& error, const std::string& message) {
+    if (!error.empty()) error += "; ";
+    error += message;
+}
+
+} // namespace
+
+const char* roleName(Role role) {
+    switch (role) {
+        case Role::Output: return "output";
+        case Role::Engine: return "engine";
+        case Role::Broadcast: return "broadcast";
+        case Role::Web: return "web";
+        case Role::Relay: return "relay";
+        default: return "unknown";
+    }
+}
+
+const char* schedName(Sched sched) {
+    switch (sched) {
+        case Sched::Fifo: return "fifo";
+        case Sched::RoundRobin: return "rr";
+        default: return "other";
+    }
+}
+
+bool parseSpec(std::string_view spec, Role& role, ThreadPolicy& policy, std::string& error) {
+    auto eq = spec.find('=');
+    if (eq == std::string_view::npos) {
+        error = "expected ROLE=CPUS[:POLICY[:PRIORITY]]";
+        return false;
+    }
+    auto roleText = spec.substr(0, eq);
+    size_t r = 0;
+    while (r < ROLE_COUNT && roleText != roleName(static_cast<Role>(r))) ++r;
+    if (r == ROLE_COUNT) {
+        error = "unknown thread role '" + std::string(roleText) +
+                "' (output, engine, broadcast, web, relay)";
+        return false;
+    }
+    role = static_cast<Role>(r);
+
+    std::string_view fields[3];
+    size_t n = 0;
+    auto rest = spec.substr(eq + 1);
+    while (n < 3) {
+        auto colon = rest.find(':');
+        fields[n++] = rest.substr(0, colon);
+        if (colon == std::string_view::npos) break;
+        rest = rest.substr(colon + 1);
+        if (n == 3) {
+            error = "too many fields";
+            return false;
+        }
+    }
+
+    policy = ThreadPolicy{};
+    if (!parseCpus(fields[0], policy.cpus)) {
+        error = "invalid CPU list '" + std::string(fields[0]) + "'";
+        return false;
+    }
+    if (n >= 2) {
+        if (fields[1] == "other") policy.sched = Sched::Other;
+        else if (fields[1] == "fifo") policy.sched = Sched::Fifo;
+        else if (fields[1] == "rr") policy.sched = Sched::RoundRobin;
+        else {
+            error = "unknown policy '" + std::string(fields[1]) + "' (other, fifo, rr)";
+            return false;
+        }
+    }
+    if (policy.sched != Sched::Other) {
+        policy.priority = 50;
+        if (n == 3 && (!parseInt(fields[2], policy.priority) ||
+                       policy.priority < 1 || policy.priority > 99)) {
+            error = "priority must be 1-99";
+            return false;
+        }
+    } else if (n == 3) {
+        error = "priority needs the fifo or rr policy";
+        return false;
+    }
+    return true;
+}
+
+bool configure(const std::vector<std::string>& specs) {
+    auto configured = defaultPolicies();
+    for (const auto& spec : specs) {
+        Role role{};
+        ThreadPolicy policy;
+        std::string error;
+        if (!parseSpec(spec, role, policy, error)) {
+            spdlog::error("Invalid --thread '{}': {}", spec, error);
+            return false;
+        }
+        configured[static_cast<size_t>(role)] = policy;
+    }
+    std::lock_guard lock(mutex);
+    policies = configured;
+    return true;
+}
+
+void apply(Role role, const char* name) {
+    ThreadReport entry;
+    entry.role = roleName(role);
+    entry.name = name;
+    entry.tid = currentTid();
+    {
+        std::lock_guard lock(mutex);
+        entry.requested = policies[static_cast<size_t>(role)];
+    }
+    const auto& requested = entry.requested;
+
+#ifdef __linux__
+    if (!requested.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : requested.cpus) CPU_SET(cpu, &set);
+        if (int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set); rc != 0) {
+            appendError(entry.error, std::string("affinity: ") + std::strerror(rc));
+        }
+    }
+    cpu_set_t effective;
+    CPU_ZERO(&effective);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(effective), &effective) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &effective)) entry.cpus.push_back(cpu);
+        }
+    }
+#else
+    if (!requested.cpus.empty()) appendError(entry.error, "affinity: not supported on this platform");
+#endif
+
+#ifndef _WIN32
+    if (requested.sched != Sched::Other) {
+        sched_param param{};
+        param.sched_priority = requested.priority;
+        if (int rc = pthread_setschedparam(pthread_self(), toNative(requested.sched), &param); rc != 0) {
+            appendError(entry.error, std::string("scheduling: ") + std::strerror(rc));
+            spdlog::warn("Could not set {} priority {} for the {} thread (needs root or CAP_SYS_NICE)",
+                         schedName(requested.sched), requested.priority, entry.role);
+        }
+    }
+    int policy = SCHED_OTHER;
+    sched_param param{};
+    if (pthread_getschedparam(pthread_self(), &policy, &param) == 0) {
+        entry.sched = nativeName(policy);
+        entry.priority = param.sched_priority;
+    }
+
+    if (locked.load()) prefaultStack();
+#endif
+
+    if (!entry.error.empty()) spdlog::warn("Thread placement for {}: {}", entry.role, entry.error);
+
+    std::lock_guard lock(mutex);
+    // A restarted thread replaces its earlier entry
+    reports.erase(std::remove_if(reports.begin(), reports.end(),
+                                 [&](const ThreadReport& r) { return r.name == entry.name; }),
+                  reports.end());
+    reports.push_back(std::move(entry));
+}
+
+bool lockMemory() {
+#ifndef _WIN32
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        spdlog::warn("mlockall failed: {} (raise RLIMIT_MEMLOCK or run with CAP_IPC_LOCK)",
+                     std::strerror(errno));
+        return false;
+    }
+    locked.store(true);
+    spdlog::info("Process memory locked");
+    return true;
+#else
+    spdlog::warn("Memory locking is not supported on this platform");
+    return false;
+#endif
+}
+
+bool memoryLocked() {
+    return locked.load();
+}
+
+std::vector<ThreadReport> report() {
+    std::lock_guard lock(mutex);
+    return reports;
+}
+
+} // namespace photon::placement
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace photon::placement {
+
+// CPU affinity and scheduling policy for Photon's threads, configured with
+// --thread ROLE=CPUS[:POLICY[:PRIORITY]] and applied by each thread to itself
+// as it starts. Threads spawned by a placed thread inherit its placement,
+// which is how Crow's I/O pool (started from the web thread) and
+// ixwebsocket's threads (started from the relay send thread) follow their
+// role.
+
+enum class Role { Output, Engine, Broadcast, Web, Relay, COUNT };
+
+enum class Sched { Other, Fifo, RoundRobin };
+
+struct ThreadPolicy {
+    std::vector<int> cpus; // empty: any CPU
+    Sched sched{Sched::Other};
+    int priority{0};       // 1-99 for Fifo/RoundRobin
+};
+
+// What a thread actually got, read back after applying its policy
+struct ThreadReport {
+    std::string role;
+    std::string name;
+    long tid{0};
+    ThreadPolicy requested;
+    std::vector<int> cpus;
+    std::string sched;
+    int priority{0};
+    std::string error; // empty when the request was applied in full
+};
+
+const char* roleName(Role role);
+const char* schedName(Sched sched);
+
+// Parses one "ROLE=CPUS[:POLICY[:PRIORITY]]" spec, e.g. "output=3:fifo:80",
+// "web=0-1" or "engine=2,3:rr:40". CPUS may be "*" for any.
+bool parseSpec(std::string_view spec, Role& role, ThreadPolicy& policy, std::string& error);
+
+// Replaces the configured policies; roles without a spec keep their default
+// (the output thread asks for SCHED_FIFO 80, the rest run unpinned).
+bool configure(const std::vector<std::string>& specs);
+
+// Applies `role`'s policy to the calling thread and records the outcome for
+// report(). Also pre-faults the thread's stack when memory is locked.
+void apply(Role role, const char* name);
+
+// mlockall(MCL_CURRENT | MCL_FUTURE): every mapped page is faulted in now and
+// later allocations are locked as they are mapped.
+bool lockMemory();
+bool memoryLocked();
+
+std::vector<ThreadReport> report();
+
+} // namespace photon::placement
@@ -17,6 +17,18 @@ void Universe::setValue(uint16_t channel, uint8_t value, SourcePriority priority
     dirty_.store(true, std::memory_order_relaxed);
 }
 
+void Universe::setValues(uint16_t startChannel, const uint8_t* values, uint16_t count,
+                         SourcePriority priority) {
+    if (startChannel >= NUM_CHANNELS) return;
+    if (count > NUM_CHANNELS - startChannel) count = NUM_CHANNELS - startChannel;
+    auto idx = static_cast<size_t>(priority);
+    for (uint16_t i = 0; i < count; ++i) {
+        channels_[startChannel + i].values[idx] = values[i];
+        channels_[startChannel + i].active[idx] = true;
+    }
+    dirty_.store(true, std::memory_order_relaxed);
+}
+
 void Universe::clearPriority(SourcePriority priority) {
     auto idx = static_cast<size_t>(priority);
     for (auto& ch : channels_) {
@@ -55,6 +67,31 @@ void Universe::clearDirty() {
     dirty_.store(false, std::memory_order_relaxed);
 }
 
+void Universe::savePlanes(Planes& out) const {
+    for (size_t p = 0; p < NUM_PRIORITIES; ++p) {
+        auto& values = out.values[p];
+        auto& active = out.active[p];
+        active.fill(0);
+        for (uint16_t c = 0; c < NUM_CHANNELS; ++c) {
+            values[c] = channels_[c].values[p];
+            if (channels_[c].active[p]) active[c >> 3] |= static_cast<uint8_t>(1u << (c & 7));
+        }
+    }
+}
+
+void Universe::loadPlanes(const Planes& in) {
+    for (size_t p = 0; p < NUM_PRIORITIES; ++p) {
+        const auto& values = in.values[p];
+        const auto& active = in.active[p];
+        for (uint16_t c = 0; c < NUM_CHANNELS; ++c) {
+            bool on = (active[c >> 3] >> (c & 7)) & 1;
+            channels_[c].active[p] = on;
+            channels_[c].values[p] = on ? values[c] : 0;
+        }
+    }
+    dirty_.store(true, std::memory_order_relaxed);
+}
+
 uint8_t Universe::mergeChannel(const ChannelState& state) const {
     for (int p = NUM_PRIORITIES - 1; p >= 0; --p) {
         if (state.active[p]) return state.values[p];
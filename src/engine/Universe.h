@@ -1,6 +1,7 @@
 #pragma once
 #include <array>
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include "engine/SourcePriority.h"
 
@@ -9,10 +10,19 @@ namespace photon {
 class Universe {
 public:
     static constexpr uint16_t NUM_CHANNELS = 512;
+    static constexpr size_t NUM_PRIORITIES = static_cast<size_t>(SourcePriority::COUNT);
+
+    // Every priority's values and active flags, plane by plane; the layout
+    // show snapshots store. Bit c % 8 of active[p][c / 8] is channel c.
+    struct Planes {
+        std::array<std::array<uint8_t, NUM_CHANNELS>, NUM_PRIORITIES> values{};
+        std::array<std::array<uint8_t, NUM_CHANNELS / 8>, NUM_PRIORITIES> active{};
+    };
 
     Universe();
 
     void setValue(uint16_t channel, uint8_t value, SourcePriority priority);
+    void setValues(uint16_t startChannel, const uint8_t* values, uint16_t count, SourcePriority priority);
     void clearPriority(SourcePriority priority);
     void blackout();
 
@@ -22,9 +32,10 @@ public:
     bool isDirty() const;
     void clearDirty();
 
-private:
-    static constexpr size_t NUM_PRIORITIES = static_cast<size_t>(SourcePriority::COUNT);
+    void savePlanes(Planes& out) const;
+    void loadPlanes(const Planes& in);
 
+private:
     struct ChannelState {
         std::array<uint8_t, NUM_PRIORITIES> values{};
         std::array<bool, NUM_PRIORITIES> active{};
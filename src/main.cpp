@@ -2,6 +2,7 @@
 #include <iostream>
 #include "application/Application.h"
 #include "application/Config.h"
+#include "engine/ThreadPlacement.h"
 #include <spdlog/spdlog.h>
 
 static photon::Application* g_app = nullptr;
@@ -15,6 +16,7 @@ int main(int argc, char* argv[]) {
     spdlog::set_pattern("[%H:%M:%S.%e] [%^%l%$] %v");
 
     auto config = photon::Config::fromArgs(argc, argv);
+    if (!photon::placement::configure(config.threadSpecs)) return 1;
 
     photon::Application app;
     g_app = &app;
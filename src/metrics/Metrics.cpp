@@ -0,0 +1,211 @@
+#include "metrics/Metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace photon::metrics {
+
+namespace {
+
+void appendNumber(std::string& out, double value) {
+    if (std::isnan(value)) { out += "NaN"; return; }
+    if (std::isinf(value)) { out += value > 0 ? "+Inf" : "-Inf"; return; }
+    // Shortest form that reads back exactly, so bounds print as written
+    char buf[32];
+    int len = 0;
+    for (int precision = 15; precision <= 17; ++precision) {
+        len = std::snprintf(buf, sizeof(buf), "%.*g", precision, value);
+        if (std::strtod(buf, nullptr) == value) break;
+    }
+    out.append(buf, static_cast<size_t>(len));
+}
+
+void appendInteger(std::string& out, uint64_t value) {
+    out += std::to_string(value);
+}
+
+} // namespace
+
+namespace detail {
+
+size_t nextShard() {
+    static std::atomic<size_t> next{0};
+    return next.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+}
+
+} // namespace detail
+
+Metric::Metric(std::string_view name, std::string_view help) : name_(name), help_(help) {
+    registry().add(this);
+}
+
+Metric::~Metric() {
+    registry().remove(this);
+}
+
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) total += shard.value.load(std::memory_order_relaxed);
+    return total;
+}
+
+void Counter::render(std::string& out) const {
+    writeHeader(out, name(), help(), "counter");
+    out += name();
+    out += ' ';
+    appendInteger(out, value());
+    out += '\n';
+}
+
+void Gauge::render(std::string& out) const {
+    writeHeader(out, name(), help(), "gauge");
+    out += name();
+    out += ' ';
+    out += std::to_string(value());
+    out += '\n';
+}
+
+Histogram::Histogram(std::string_view name, std::string_view help, std::initializer_list<double> bounds)
+    : Metric(name, help), bounds_(bounds),
+      linesPerShard_((bounds.size() + 1 + detail::BucketLine::SLOTS - 1) / detail::BucketLine::SLOTS),
+      lines_(std::make_unique<detail::BucketLine[]>(detail::SHARDS * linesPerShard_)) {
+    std::sort(bounds_.begin(), bounds_.end());
+}
+
+void Histogram::observe(double value) {
+    size_t i = 0;
+    while (i < bounds_.size() && value > bounds_[i]) ++i;
+    size_t shard = detail::shardIndex();
+    slot(shard, i).fetch_add(1, std::memory_order_relaxed);
+    totals_[shard].count.fetch_add(1, std::memory_order_relaxed);
+    totals_[shard].sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+uint64_t Histogram::count() const {
+    uint64_t total = 0;
+    for (const auto& t : totals_) total += t.count.load(std::memory_order_relaxed);
+    return total;
+}
+
+double Histogram::sum() const {
+    double total = 0;
+    for (const auto& t : totals_) total += t.sum.load(std::memory_order_relaxed);
+    return total;
+}
+
+uint64_t Histogram::bucket(size_t i) const {
+    uint64_t total = 0;
+    for (size_t shard = 0; shard < detail::SHARDS; ++shard) total += slot(shard, i).load(std::memory_order_relaxed);
+    return total;
+}
+
+void Histogram::render(std::string& out) const {
+    writeHeader(out, name(), help(), "histogram");
+    // Buckets are stored individually and made cumulative here; a scrape racing
+    // observe() can be off by one sample, which Prometheus tolerates
+    uint64_t cumulative = 0;
+    std::string bucketName = name() + "_bucket";
+    for (size_t i = 0; i <= bounds_.size(); ++i) {
+        cumulative += bucket(i);
+        std::string le;
+        if (i < bounds_.size()) appendNumber(le, bounds_[i]);
+        else le = "+Inf";
+        out += bucketName;
+        out += "{le=\"";
+        out += le;
+        out += "\"} ";
+        appendInteger(out, cumulative);
+        out += '\n';
+    }
+    writeSample(out, name() + "_sum", {}, sum());
+    out += name();
+    out += "_count ";
+    appendInteger(out, cumulative);
+    out += '\n';
+}
+
+void writeHeader(std::string& out, std::string_view name, std::string_view help, std::string_view type) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    for (char c : help) {
+        if (c == '\\') out += "\\\\";
+        else if (c == '\n') out += "\\n";
+        else out += c;
+    }
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+void writeSample(std::string& out, std::string_view name, std::string_view labels, double value) {
+    out += name;
+    if (!labels.empty()) {
+        out += '{';
+        out += labels;
+        out += '}';
+    }
+    out += ' ';
+    appendNumber(out, value);
+    out += '\n';
+}
+
+std::string label(std::string_view key, std::string_view value) {
+    std::string out(key);
+    out += "=\"";
+    for (char c : value) {
+        if (c == '\\') out += "\\\\";
+        else if (c == '"') out += "\\\"";
+        else if (c == '\n') out += "\\n";
+        else out += c;
+    }
+    out += '"';
+    return out;
+}
+
+int Registry::addCollector(Collector collector) {
+    std::lock_guard lock(mutex_);
+    int id = nextId_++;
+    collectors_.emplace_back(id, std::move(collector));
+    return id;
+}
+
+void Registry::removeCollector(int id) {
+    std::lock_guard lock(mutex_);
+    collectors_.erase(
+        std::remove_if(collectors_.begin(), collectors_.end(),
+                       [id](const auto& c) { return c.first == id; }),
+        collectors_.end());
+}
+
+std::string Registry::render() const {
+    std::lock_guard lock(mutex_);
+    std::string out;
+    out.reserve(4096);
+    for (const auto* metric : metrics_) metric->render(out);
+    for (const auto& [id, collector] : collectors_) collector(out);
+    return out;
+}
+
+void Registry::add(const Metric* metric) {
+    std::lock_guard lock(mutex_);
+    // Keep families sorted so the exposition is stable across builds
+    auto it = std::lower_bound(metrics_.begin(), metrics_.end(), metric,
+        [](const Metric* a, const Metric* b) { return a->name() < b->name(); });
+    metrics_.insert(it, metric);
+}
+
+void Registry::remove(const Metric* metric) {
+    std::lock_guard lock(mutex_);
+    metrics_.erase(std::remove(metrics_.begin(), metrics_.end(), metric), metrics_.end());
+}
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+} // namespace photon::metrics
@@ -0,0 +1,150 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace photon::metrics {
+
+// Process-wide instruments rendered by GET /api/metrics in the Prometheus
+// text format. Recording is a relaxed atomic add — no locks, no allocation —
+// so the instruments stay on in production and can sit on the output thread.
+// Counters and histograms are sharded per thread: each writer adds to its own
+// cache line and a scrape sums the shards, so instruments recorded from many
+// threads (Crow handlers, the broadcaster, the output thread) never contend.
+// Each instrument registers itself on construction; define them at namespace
+// scope next to the code that records them.
+
+namespace detail {
+
+inline constexpr size_t SHARDS = 16;
+
+size_t nextShard();
+
+// The calling thread's shard, assigned round-robin on first use
+inline size_t shardIndex() {
+    thread_local const size_t index = nextShard();
+    return index;
+}
+
+struct alignas(64) CounterShard {
+    std::atomic<uint64_t> value{0};
+};
+
+struct alignas(64) BucketLine {
+    static constexpr size_t SLOTS = 64 / sizeof(std::atomic<uint64_t>);
+    std::atomic<uint64_t> slots[SLOTS]{};
+};
+
+struct alignas(64) HistogramTotals {
+    std::atomic<uint64_t> count{0};
+    std::atomic<double> sum{0.0};
+};
+
+} // namespace detail
+
+class Metric {
+public:
+    Metric(std::string_view name, std::string_view help);
+    virtual ~Metric();
+
+    Metric(const Metric&) = delete;
+    Metric& operator=(const Metric&) = delete;
+
+    const std::string& name() const { return name_; }
+    const std::string& help() const { return help_; }
+    virtual void render(std::string& out) const = 0;
+
+private:
+    std::string name_;
+    std::string help_;
+};
+
+class Counter : public Metric {
+public:
+    using Metric::Metric;
+
+    void inc(uint64_t n = 1) { shards_[detail::shardIndex()].value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const;
+    void render(std::string& out) const override;
+
+private:
+    std::array<detail::CounterShard, detail::SHARDS> shards_{};
+};
+
+// A single atomic: set() has no per-thread form, and gauges are not hot
+class Gauge : public Metric {
+public:
+    using Metric::Metric;
+
+    void set(int64_t v) { value_.store(v, std::memory_order_relaxed); }
+    void add(int64_t n) { value_.fetch_add(n, std::memory_order_relaxed); }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+    void render(std::string& out) const override;
+
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+// Fixed upper bounds (in seconds for durations) chosen at construction;
+// observe() is a short scan and two relaxed adds
+class Histogram : public Metric {
+public:
+    Histogram(std::string_view name, std::string_view help, std::initializer_list<double> bounds);
+
+    void observe(double value);
+    uint64_t count() const;
+    double sum() const;
+    // Non-cumulative count for bucket i; i == bounds().size() is +Inf
+    uint64_t bucket(size_t i) const;
+    const std::vector<double>& bounds() const { return bounds_; }
+    void render(std::string& out) const override;
+
+private:
+    std::atomic<uint64_t>& slot(size_t shard, size_t i) const {
+        return lines_[shard * linesPerShard_ + i / detail::BucketLine::SLOTS].slots[i % detail::BucketLine::SLOTS];
+    }
+
+    std::vector<double> bounds_;
+    size_t linesPerShard_;
+    std::unique_ptr<detail::BucketLine[]> lines_;
+    std::array<detail::HistogramTotals, detail::SHARDS> totals_{};
+};
+
+// Helpers for collectors that report labelled or pulled values at scrape time
+void writeHeader(std::string& out, std::string_view name, std::string_view help, std::string_view type);
+void writeSample(std::string& out, std::string_view name, std::string_view labels, double value);
+std::string label(std::string_view key, std::string_view value);
+
+class Registry {
+public:
+    using Collector = std::function<void(std::string& out)>;
+
+    // Collectors run on the scraping thread and read whatever stats the owner
+    // already keeps; the id is for removeCollector() before the owner dies
+    int addCollector(Collector collector);
+    void removeCollector(int id);
+
+    std::string render() const;
+
+private:
+    friend class Metric;
+    void add(const Metric* metric);
+    void remove(const Metric* metric);
+
+    mutable std::mutex mutex_;
+    std::vector<const Metric*> metrics_;
+    std::vector<std::pair<int, Collector>> collectors_;
+    int nextId_{0};
+};
+
+Registry& registry();
+
+} // namespace photon::metrics
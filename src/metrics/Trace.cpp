@@ -0,0 +1,181 @@
+#include "metrics/Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace photon::trace {
+
+namespace detail {
+std::atomic<bool> enabled{false};
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+} // namespace detail
+
+namespace {
+
+struct Event {
+    const char* name;
+    const char* argName;
+    int64_t arg;
+    uint64_t startNs;
+    uint64_t durNs;
+};
+
+// One per thread that has traced or been named. Only the owning thread
+// writes events; readers copy them out and discard anything the writer may
+// have overwritten meanwhile.
+struct ThreadBuffer {
+    uint32_t tid{0};
+    std::string name;              // guarded by registryMutex
+    std::unique_ptr<Event[]> events; // allocated by the owner on first record
+    uint64_t capture{0};           // owner-only: capture the ring belongs to
+    std::atomic<uint64_t> head{0}; // events ever written this capture
+    std::atomic<uint64_t> published{0}; // capture id matching `head`
+};
+
+std::mutex registryMutex;
+// Buffers outlive their threads so a capture can be exported after the
+// threads that produced it exit
+std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+std::atomic<uint64_t> captureId{0};
+std::atomic<uint64_t> epochNs{0};
+
+ThreadBuffer& localBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> local = [] {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard lock(registryMutex);
+        buffer->tid = static_cast<uint32_t>(buffers.size() + 1);
+        buffer->name = "thread " + std::to_string(buffer->tid);
+        buffers.push_back(buffer);
+        return buffer;
+    }();
+    return *local;
+}
+
+void appendEscaped(std::string& out, const char* s) {
+    for (; *s; ++s) {
+        char c = *s;
+        if (c == '"' || c == '\\') { out += '\\'; out += c; }
+        else if (static_cast<unsigned char>(c) < 0x20) out += ' ';
+        else out += c;
+    }
+}
+
+void appendMicros(std::string& out, uint64_t ns) {
+    char buf[32];
+    int len = std::snprintf(buf, sizeof(buf), "%.3f", static_cast<double>(ns) / 1000.0);
+    out.append(buf, static_cast<size_t>(len));
+}
+
+} // namespace
+
+namespace detail {
+
+void record(const char* name, uint64_t startNs, uint64_t endNs, const char* argName, int64_t arg) {
+    auto& buffer = localBuffer();
+    uint64_t capture = captureId.load(std::memory_order_acquire);
+    if (buffer.capture != capture) {
+        // First event of a new capture on this thread: restart the ring
+        if (!buffer.events) buffer.events = std::make_unique<Event[]>(EVENTS_PER_THREAD);
+        buffer.capture = capture;
+        buffer.head.store(0, std::memory_order_relaxed);
+        buffer.published.store(capture, std::memory_order_release);
+    }
+    uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    buffer.events[head % EVENTS_PER_THREAD] =
+        Event{name, argName, arg, startNs, endNs > startNs ? endNs - startNs : 0};
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+} // namespace detail
+
+void start() {
+    detail::enabled.store(false);
+    epochNs.store(detail::nowNs());
+    captureId.fetch_add(1, std::memory_order_acq_rel);
+    detail::enabled.store(true);
+}
+
+void stop() {
+    detail::enabled.store(false);
+}
+
+bool isCapturing() {
+    return detail::enabled.load();
+}
+
+void setThreadName(const char* name) {
+    auto& buffer = localBuffer();
+    std::lock_guard lock(registryMutex);
+    buffer.name = name;
+}
+
+std::string exportChromeJson() {
+    std::vector<std::shared_ptr<ThreadBuffer>> snapshot;
+    std::vector<std::string> names;
+    {
+        std::lock_guard lock(registryMutex);
+        snapshot = buffers;
+        for (const auto& b : buffers) names.push_back(b->name);
+    }
+    uint64_t capture = captureId.load(std::memory_order_acquire);
+    uint64_t epoch = epochNs.load();
+
+    std::string out = R"({"displayTimeUnit":"ms","traceEvents":[)";
+    bool first = true;
+    auto comma = [&] { if (!first) out += ','; first = false; };
+
+    std::vector<Event> events;
+    for (size_t i = 0; i < snapshot.size(); ++i) {
+        auto& buffer = *snapshot[i];
+        comma();
+        out += R"({"name":"thread_name","ph":"M","pid":1,"tid":)";
+        out += std::to_string(buffer.tid);
+        out += R"(,"args":{"name":")";
+        appendEscaped(out, names[i].c_str());
+        out += "\"}}";
+
+        if (buffer.published.load(std::memory_order_acquire) != capture) continue;
+        uint64_t end = buffer.head.load(std::memory_order_acquire);
+        uint64_t begin = end > EVENTS_PER_THREAD ? end - EVENTS_PER_THREAD : 0;
+        events.clear();
+        for (uint64_t e = begin; e < end; ++e) events.push_back(buffer.events[e % EVENTS_PER_THREAD]);
+        // Drop whatever the writer lapped while we copied, plus the slot it
+        // may be writing right now
+        uint64_t after = buffer.head.load(std::memory_order_acquire);
+        uint64_t valid = after + 1 > EVENTS_PER_THREAD ? after + 1 - EVENTS_PER_THREAD : 0;
+        if (buffer.published.load(std::memory_order_acquire) != capture) continue;
+        size_t skip = static_cast<size_t>(std::min(end, std::max(begin, valid)) - begin);
+
+        for (size_t e = skip; e < events.size(); ++e) {
+            const auto& ev = events[e];
+            comma();
+            out += R"({"name":")";
+            appendEscaped(out, ev.name);
+            out += R"(","ph":"X","pid":1,"tid":)";
+            out += std::to_string(buffer.tid);
+            out += R"(,"ts":)";
+            appendMicros(out, ev.startNs > epoch ? ev.startNs - epoch : 0);
+            out += R"(,"dur":)";
+            appendMicros(out, ev.durNs);
+            if (ev.argName) {
+                out += R"(,"args":{")";
+                appendEscaped(out, ev.argName);
+                out += "\":";
+                out += std::to_string(ev.arg);
+                out += '}';
+            }
+            out += '}';
+        }
+    }
+    out += "]}";
+    return out;
+}
+
+} // namespace photon::trace
@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace photon::trace {
+
+// In-process span recorder for diagnosing stutters. Each thread writes
+// complete events into its own fixed-size ring, so recording takes no locks;
+// when capture is off a scope costs one relaxed load. Captures export as
+// Chrome trace JSON, which chrome://tracing and ui.perfetto.dev open directly.
+
+namespace detail {
+extern std::atomic<bool> enabled;
+uint64_t nowNs();
+void record(const char* name, uint64_t startNs, uint64_t endNs, const char* argName, int64_t arg);
+} // namespace detail
+
+inline bool enabled() { return detail::enabled.load(std::memory_order_relaxed); }
+
+// Discards any previous capture and starts recording
+void start();
+void stop();
+bool isCapturing();
+
+// Everything recorded since start(), whether or not capture is still running
+std::string exportChromeJson();
+
+// Labels the calling thread's track in exported traces
+void setThreadName(const char* name);
+
+// Events kept per thread; older events are overwritten once a ring is full
+constexpr size_t EVENTS_PER_THREAD = 1 << 16;
+
+class Scope {
+public:
+    // `name` and `argName` must outlive the capture (string literals)
+    explicit Scope(const char* name, const char* argName = nullptr, int64_t arg = 0)
+        : name_(name), argName_(argName), arg_(arg),
+          start_(enabled() ? detail::nowNs() : 0) {}
+
+    ~Scope() {
+        if (start_) detail::record(name_, start_, detail::nowNs(), argName_, arg_);
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* name_;
+    const char* argName_;
+    int64_t arg_;
+    uint64_t start_;
+};
+
+} // namespace photon::trace
+
+#define PHOTON_TRACE_CONCAT_(a, b) a##b
+#define PHOTON_TRACE_CONCAT(a, b) PHOTON_TRACE_CONCAT_(a, b)
+
+// Records the enclosing block as one span
+#define PHOTON_TRACE_SCOPE(name) \
+    ::photon::trace::Scope PHOTON_TRACE_CONCAT(photonTraceScope_, __LINE__)(name)
+// Same, with one integer argument shown in the trace viewer
+#define PHOTON_TRACE_SCOPE_ARG(name, argName, arg) \
+    ::photon::trace::Scope PHOTON_TRACE_CONCAT(photonTraceScope_, __LINE__)(name, argName, static_cast<int64_t>(arg))
@@ -0,0 +1,170 @@
+#include "pixel/PixelMap.h"
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace photon {
+
+using json = nlohmann::json;
+
+namespace {
+
+constexpr const char* ORDER_NAMES[] = {"RGB", "RBG", "GRB", "GBR", "BRG", "BGR", "RGBW", "GRBW"};
+static_assert(std::size(ORDER_NAMES) == static_cast<size_t>(ColorOrder::COUNT));
+
+constexpr uint16_t CHANNELS = 512;
+
+} // namespace
+
+namespace pixelmap {
+
+bool parseOrder(const std::string& name, ColorOrder& out) {
+    std::string upper = name;
+    std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c) { return std::toupper(c); });
+    for (size_t i = 0; i < std::size(ORDER_NAMES); ++i) {
+        if (upper == ORDER_NAMES[i]) {
+            out = static_cast<ColorOrder>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* orderName(ColorOrder order) {
+    auto i = static_cast<size_t>(order);
+    return i < std::size(ORDER_NAMES) ? ORDER_NAMES[i] : "?";
+}
+
+size_t channelsPerPixel(ColorOrder order) {
+    return order == ColorOrder::RGBW || order == ColorOrder::GRBW ? 4 : 3;
+}
+
+} // namespace pixelmap
+
+bool PixelMap::compile(uint16_t width, uint16_t height, const std::vector<PixelStrip>& strips,
+                       uint16_t universeCount) {
+    segments_.clear();
+    runs_.clear();
+    width_ = width;
+    height_ = height;
+    pixelCount_ = 0;
+    channelCount_ = 0;
+    universesUsed_ = 0;
+
+    if (width == 0 || height == 0) {
+        spdlog::error("Pixel map: frame size {}x{} is empty", width, height);
+        return false;
+    }
+
+    uint32_t offset = 0;
+    for (size_t s = 0; s < strips.size(); ++s) {
+        const auto& strip = strips[s];
+        if (strip.count == 0) continue;
+        if (strip.order >= ColorOrder::COUNT || strip.channel >= CHANNELS) {
+            spdlog::error("Pixel map: strip {} has an invalid order or channel", s);
+            return false;
+        }
+        // Pixels step linearly, so both ends inside the frame means all are
+        int64_t lastX = strip.x + int64_t{strip.dx} * (strip.count - 1);
+        int64_t lastY = strip.y + int64_t{strip.dy} * (strip.count - 1);
+        if (strip.x >= width || strip.y >= height || lastX < 0 || lastX >= width || lastY < 0 || lastY >= height) {
+            spdlog::error("Pixel map: strip {} leaves the {}x{} frame", s, width, height);
+            return false;
+        }
+
+        auto perPixel = static_cast<uint16_t>(pixelmap::channelsPerPixel(strip.order));
+        int32_t step = int32_t{strip.dy} * width + strip.dx;
+        uint16_t universe = strip.universe;
+        uint16_t channel = strip.channel;
+        uint32_t done = 0;
+        while (done < strip.count) {
+            uint16_t fit = (CHANNELS - channel) / perPixel;
+            if (fit == 0) {
+                ++universe;
+                channel = 0;
+                continue;
+            }
+            if (universe >= universeCount) {
+                spdlog::error("Pixel map: strip {} runs past universe {}", s, universeCount - 1);
+                return false;
+            }
+            auto pixels = static_cast<uint16_t>(std::min<uint32_t>(fit, strip.count - done));
+            auto channels = static_cast<uint16_t>(pixels * perPixel);
+            uint32_t first = static_cast<uint32_t>((strip.y + int64_t{strip.dy} * done) * width +
+                                                   strip.x + int64_t{strip.dx} * done);
+            segments_.push_back({first, step, offset, pixels, strip.order});
+
+            // Strips cabled back to back in one universe become a single run
+            auto* last = runs_.empty() ? nullptr : &runs_.back();
+            if (last && last->universe == universe && last->channel + last->count == channel &&
+                last->offset + last->count == offset) {
+                last->count = static_cast<uint16_t>(last->count + channels);
+            } else {
+                runs_.push_back({universe, channel, channels, offset});
+            }
+
+            offset += channels;
+            channel = static_cast<uint16_t>(channel + channels);
+            done += pixels;
+        }
+        pixelCount_ += strip.count;
+    }
+
+    channelCount_ = offset;
+    std::vector<uint16_t> universes;
+    for (const auto& run : runs_) universes.push_back(run.universe);
+    std::sort(universes.begin(), universes.end());
+    universesUsed_ = static_cast<size_t>(std::unique(universes.begin(), universes.end()) - universes.begin());
+    return true;
+}
+
+bool PixelMap::parse(const std::string& text, uint16_t universeCount) {
+    std::vector<PixelStrip> strips;
+    uint16_t width = 0;
+    uint16_t height = 0;
+    try {
+        auto doc = json::parse(text);
+        width = doc.at("width").get<uint16_t>();
+        height = doc.at("height").get<uint16_t>();
+        for (const auto& s : doc.at("strips")) {
+            PixelStrip strip;
+            strip.x = s.at("x").get<uint16_t>();
+            strip.y = s.at("y").get<uint16_t>();
+            strip.dx = s.value("dx", int16_t{1});
+            strip.dy = s.value("dy", int16_t{0});
+            strip.count = s.at("count").get<uint32_t>();
+            strip.universe = s.at("universe").get<uint16_t>();
+            strip.channel = s.value("channel", uint16_t{0});
+            auto order = s.value("order", std::string("RGB"));
+            if (!pixelmap::parseOrder(order, strip.order)) {
+                spdlog::error("Pixel map: unknown color order '{}'", order);
+                return false;
+            }
+            strips.push_back(strip);
+        }
+    } catch (const std::exception& e) {
+        spdlog::error("Pixel map: {}", e.what());
+        return false;
+    }
+    return compile(width, height, strips, universeCount);
+}
+
+bool PixelMap::load(const std::string& path, uint16_t universeCount) {
+    std::ifstream file(path);
+    if (!file) {
+        spdlog::error("Pixel map: cannot open {}", path);
+        return false;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    if (!parse(text.str(), universeCount)) return false;
+    spdlog::info("Pixel map {}: {}x{} frame, {} pixels over {} universes", path, width_, height_,
+                 pixelCount_, universesUsed_);
+    return true;
+}
+
+} // namespace photon
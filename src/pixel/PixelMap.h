@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace photon {
+
+// Channel layout of one LED pixel on the wire
+enum class ColorOrder : uint8_t {
+    RGB, RBG, GRB, GBR, BRG, BGR,
+    RGBW, GRBW,  // white extracted as min(R, G, B)
+    COUNT
+};
+
+namespace pixelmap {
+
+bool parseOrder(const std::string& name, ColorOrder& out);
+const char* orderName(ColorOrder order);
+size_t channelsPerPixel(ColorOrder order);
+
+} // namespace pixelmap
+
+// One strip of pixels as the rig is cabled: `count` pixels read from the
+// frame starting at (x, y) and stepping (dx, dy) per pixel, written to
+// consecutive channels from `universe`/`channel`. A strip that fills its
+// universe carries on from the start of the next one; pixels never straddle
+// two universes, as on most LED controllers.
+struct PixelStrip {
+    uint16_t x{0};
+    uint16_t y{0};
+    int16_t dx{1};
+    int16_t dy{0};
+    uint32_t count{0};
+    uint16_t universe{0};
+    uint16_t channel{0};  // 0-based
+    ColorOrder order{ColorOrder::RGB};
+};
+
+// A pixel map compiled for rendering: strips split at universe boundaries
+// into segments, each writing one contiguous channel range. Segments are
+// packed back to back in the render buffer, and each output run covers one
+// or more neighbouring segments in a universe.
+class PixelMap {
+public:
+    struct Segment {
+        uint32_t source;      // first pixel, as an index into the frame
+        int32_t step;         // pixels between consecutive strip pixels
+        uint32_t offset;      // into the render buffer
+        uint16_t pixels;
+        ColorOrder order;
+    };
+
+    struct Run {
+        uint16_t universe;
+        uint16_t channel;
+        uint16_t count;
+        uint32_t offset;      // into the render buffer
+    };
+
+    // Builds the map for frames of width x height; false (with a log line)
+    // if a strip leaves the frame or runs past the last universe
+    bool compile(uint16_t width, uint16_t height, const std::vector<PixelStrip>& strips,
+                 uint16_t universeCount);
+
+    // JSON: {"width":W,"height":H,"strips":[{"x","y","dx","dy","count",
+    // "universe","channel","order"}]} with dx, dy, channel and order optional
+    bool load(const std::string& path, uint16_t universeCount);
+    bool parse(const std::string& json, uint16_t universeCount);
+
+    uint16_t width() const { return width_; }
+    uint16_t height() const { return height_; }
+    size_t pixelCount() const { return pixelCount_; }
+    size_t channelCount() const { return channelCount_; }
+    size_t universesUsed() const { return universesUsed_; }
+    bool empty() const { return segments_.empty(); }
+
+    const std::vector<Segment>& segments() const { return segments_; }
+    const std::vector<Run>& runs() const { return runs_; }
+
+private:
+    uint16_t width_{0};
+    uint16_t height_{0};
+    size_t pixelCount_{0};
+    size_t channelCount_{0};
+    size_t universesUsed_{0};
+    std::vector<Segment> segments_;
+    std::vector<Run> runs_;
+};
+
+} // namespace photon
@@ -0,0 +1,151 @@
+#include "pixel/PixelMapper.h"
+#include "metrics/Metrics.h"
+#include "metrics/Trace.h"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <utility>
+
+namespace photon {
+
+namespace {
+
+metrics::Counter pixelFrames{"photon_pixel_frames_total", "Pixel frames rendered into the merge buffer"};
+metrics::Counter pixelRejected{"photon_pixel_frames_rejected_total",
+    "Pixel frames dropped because their size didn't match the pixel map"};
+metrics::Histogram pixelRenderSeconds{"photon_pixel_render_seconds",
+    "Time to scatter one pixel frame and write it to the merge buffer",
+    {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025}};
+
+// Where R, G, B and (if any) W land within one output pixel
+struct Layout {
+    int r, g, b, w;
+    int width;
+};
+
+constexpr Layout layoutOf(ColorOrder order) {
+    switch (order) {
+        case ColorOrder::RGB: return {0, 1, 2, -1, 3};
+        case ColorOrder::RBG: return {0, 2, 1, -1, 3};
+        case ColorOrder::GRB: return {1, 0, 2, -1, 3};
+        case ColorOrder::GBR: return {2, 0, 1, -1, 3};
+        case ColorOrder::BRG: return {1, 2, 0, -1, 3};
+        case ColorOrder::BGR: return {2, 1, 0, -1, 3};
+        case ColorOrder::RGBW: return {0, 1, 2, 3, 4};
+        case ColorOrder::GRBW: return {1, 0, 2, 3, 4};
+        default: return {0, 1, 2, -1, 3};
+    }
+}
+
+// c * a / 255, rounded
+inline uint8_t dim(uint8_t c, uint8_t a) {
+    unsigned x = unsigned{c} * a + 128;
+    return static_cast<uint8_t>((x + (x >> 8)) >> 8);
+}
+
+// One kernel per (order, input bytes per pixel, contiguous): with the layout
+// and stride known at compile time the loop has no branches and the compiler
+// turns the shuffle into vector code
+template <ColorOrder Order, int In, bool Contiguous>
+void scatter(const uint8_t* src, int32_t stepBytes, uint8_t* dst, uint16_t pixels) {
+    constexpr Layout L = layoutOf(Order);
+    const int32_t step = Contiguous ? In : stepBytes;
+    for (uint16_t i = 0; i < pixels; ++i, src += step, dst += L.width) {
+        uint8_t r = src[0];
+        uint8_t g = src[1];
+        uint8_t b = src[2];
+        if constexpr (In == 4) {
+            r = dim(r, src[3]);
+            g = dim(g, src[3]);
+            b = dim(b, src[3]);
+        }
+        if constexpr (L.w >= 0) {
+            uint8_t w = std::min({r, g, b});
+            r = static_cast<uint8_t>(r - w);
+            g = static_cast<uint8_t>(g - w);
+            b = static_cast<uint8_t>(b - w);
+            dst[L.w] = w;
+        }
+        dst[L.r] = r;
+        dst[L.g] = g;
+        dst[L.b] = b;
+    }
+}
+
+using Kernel = void (*)(const uint8_t*, int32_t, uint8_t*, uint16_t);
+constexpr size_t ORDER_COUNT = static_cast<size_t>(ColorOrder::COUNT);
+
+template <int In, bool Contiguous, size_t... I>
+constexpr std::array<Kernel, ORDER_COUNT> makeKernels(std::index_sequence<I...>) {
+    return {&scatter<static_cast<ColorOrder>(I), In, Contiguous>...};
+}
+
+// [format == RGBA][contiguous][order]
+constexpr std::array<std::array<Kernel, ORDER_COUNT>, 2> KERNELS[2] = {
+    {makeKernels<3, false>(std::make_index_sequence<ORDER_COUNT>{}),
+     makeKernels<3, true>(std::make_index_sequence<ORDER_COUNT>{})},
+    {makeKernels<4, false>(std::make_index_sequence<ORDER_COUNT>{}),
+     makeKernels<4, true>(std::make_index_sequence<ORDER_COUNT>{})},
+};
+
+} // namespace
+
+PixelMapper::PixelMapper(MergeBuffer& mergeBuffer, SourcePriority priority)
+    : mergeBuffer_(mergeBuffer), priority_(priority) {}
+
+void PixelMapper::setMap(PixelMap map) {
+    std::lock_guard lock(mutex_);
+    map_ = std::move(map);
+    buffer_.assign(map_.channelCount(), 0);
+    runs_.clear();
+    for (const auto& run : map_.runs()) {
+        runs_.push_back({run.universe, run.channel, run.count, buffer_.data() + run.offset, priority_});
+    }
+}
+
+uint16_t PixelMapper::width() const {
+    std::lock_guard lock(mutex_);
+    return map_.width();
+}
+
+uint16_t PixelMapper::height() const {
+    std::lock_guard lock(mutex_);
+    return map_.height();
+}
+
+bool PixelMapper::render(const uint8_t* pixels, uint16_t width, uint16_t height, PixelFormat format) {
+    PHOTON_TRACE_SCOPE("pixel.render");
+    auto start = std::chrono::steady_clock::now();
+    std::lock_guard lock(mutex_);
+    if (map_.empty() || width != map_.width() || height != map_.height()) {
+        if (rejected_.fetch_add(1, std::memory_order_relaxed) == 0) {
+            spdlog::warn("Pixel frame {}x{} doesn't match the {}x{} pixel map", width, height,
+                         map_.width(), map_.height());
+        }
+        pixelRejected.inc();
+        return false;
+    }
+
+    const auto bytes = static_cast<int32_t>(format);
+    const auto& kernels = KERNELS[format == PixelFormat::RGBA];
+    for (const auto& seg : map_.segments()) {
+        auto kernel = kernels[seg.step == 1][static_cast<size_t>(seg.order)];
+        kernel(pixels + size_t{seg.source} * bytes, seg.step * bytes, buffer_.data() + seg.offset, seg.pixels);
+    }
+    mergeBuffer_.setRuns(runs_.data(), runs_.size());
+
+    frames_.fetch_add(1, std::memory_order_relaxed);
+    pixelFrames.inc();
+    pixelRenderSeconds.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    return true;
+}
+
+PixelMapper::Stats PixelMapper::getStats() const {
+    Stats s;
+    s.frames = frames_.load(std::memory_order_relaxed);
+    s.rejected = rejected_.load(std::memory_order_relaxed);
+    return s;
+}
+
+} // namespace photon
@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "engine/InputCoalescer.h"
+#include "engine/MergeBuffer.h"
+#include "engine/SourcePriority.h"
+#include "pixel/PixelMap.h"
+
+namespace photon {
+
+// Bytes per pixel of an incoming frame
+enum class PixelFormat : uint8_t {
+    RGB = 3,
+    RGBA = 4,  // alpha dims the pixel
+};
+
+// Renders video frames onto LED fixtures: every segment of the compiled map
+// is scattered into a packed channel buffer by a kernel specialised for its
+// color order, frame format and stride, and the whole frame is written to one
+// MergeBuffer priority plane under a single lock.
+class PixelMapper {
+public:
+    struct Stats {
+        uint64_t frames{0};
+        uint64_t rejected{0};  // frames whose size didn't match the map
+    };
+
+    explicit PixelMapper(MergeBuffer& mergeBuffer, SourcePriority priority = SourcePriority::Effect);
+
+    void setMap(PixelMap map);
+    uint16_t width() const;
+    uint16_t height() const;
+
+    // `pixels` holds width x height pixels row by row without padding. Safe
+    // to call from several threads; frames are rendered one at a time.
+    bool render(const uint8_t* pixels, uint16_t width, uint16_t height, PixelFormat format);
+
+    Stats getStats() const;
+
+private:
+    MergeBuffer& mergeBuffer_;
+    SourcePriority priority_;
+
+    mutable std::mutex mutex_;
+    PixelMap map_;
+    std::vector<uint8_t> buffer_;
+    std::vector<ChannelRun> runs_;  // values point into buffer_
+
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> rejected_{0};
+};
+
+} // namespace photon
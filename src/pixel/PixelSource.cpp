@@ -0,0 +1,202 @@
+#include "pixel/PixelSource.h"
+#include "metrics/Trace.h"
+#include <spdlog/spdlog.h>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace photon {
+
+PixelSource::PixelSource(PixelMapper& mapper, Clock& clock) : mapper_(mapper), clock_(clock) {}
+
+PixelSource::~PixelSource() {
+    stop();
+}
+
+void PixelSource::stop() {
+    if (!running_.exchange(false)) return;
+    clock_.wake();
+    if (thread_.joinable()) thread_.join();
+}
+
+#ifdef _WIN32
+
+bool PixelSource::startStream(const std::string& path, double) {
+    spdlog::error("Pixel streams are not supported on this platform ({})", path);
+    return false;
+}
+
+bool PixelSource::startSharedMemory(const std::string& name, double) {
+    spdlog::error("Shared-memory pixel frames are not supported on this platform ({})", name);
+    return false;
+}
+
+void PixelSource::runStream() {}
+void PixelSource::runSharedMemory() {}
+
+#else
+
+bool PixelSource::startStream(const std::string& path, double fps) {
+    if (running_.load() || fps <= 0 || mapper_.width() == 0) return false;
+    path_ = path;
+    period_ = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+    running_.store(true);
+    thread_ = std::thread([this] { runStream(); });
+    spdlog::info("Pixel frames from {} ({}x{} RGB)", path, mapper_.width(), mapper_.height());
+    return true;
+}
+
+bool PixelSource::startSharedMemory(const std::string& name, double fps) {
+    if (running_.load() || fps <= 0 || mapper_.width() == 0) return false;
+    path_ = name.starts_with('/') ? name : "/" + name;
+    period_ = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+    running_.store(true);
+    thread_ = std::thread([this] { runSharedMemory(); });
+    spdlog::info("Pixel frames from shared memory {} at {:.0f} Hz", path_, fps);
+    return true;
+}
+
+void PixelSource::runStream() {
+    trace::setThreadName("pixel-source");
+    uint16_t width = mapper_.width();
+    uint16_t height = mapper_.height();
+    size_t frameBytes = size_t{width} * height * 3;
+    std::vector<uint8_t> frame(frameBytes);
+    bool warned = false;
+
+    while (running_.load()) {
+        // Non-blocking, so opening a pipe doesn't wait for a writer and stop() is never stuck
+        int fd = ::open(path_.c_str(), O_RDONLY | O_NONBLOCK);
+        if (fd < 0) {
+            if (!warned) spdlog::error("Pixel source: cannot open {}: {}", path_, std::strerror(errno));
+            warned = true;
+            clock_.sleepFor(std::chrono::seconds(1), running_);
+            continue;
+        }
+        struct stat st{};
+        ::fstat(fd, &st);
+        bool regular = S_ISREG(st.st_mode);
+        if (regular && static_cast<size_t>(st.st_size) < frameBytes) {
+            spdlog::error("Pixel source: {} is shorter than one {}x{} frame", path_, width, height);
+            ::close(fd);
+            return;
+        }
+
+        auto next = clock_.now();
+        size_t filled = 0;
+        bool reopen = false;
+        while (running_.load() && !reopen) {
+            if (!regular) {
+                pollfd p{fd, POLLIN, 0};
+                if (::poll(&p, 1, 100) <= 0) continue;
+                // The writer went away; reopen to wait for the next one
+                if (!(p.revents & POLLIN)) {
+                    reopen = true;
+                    continue;
+                }
+            }
+            auto n = ::read(fd, frame.data() + filled, frameBytes - filled);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EINTR) continue;
+                spdlog::error("Pixel source: reading {}: {}", path_, std::strerror(errno));
+                reopen = true;
+                clock_.sleepFor(std::chrono::seconds(1), running_);
+            } else if (n == 0) {
+                if (!regular) {
+                    reopen = true;
+                } else {
+                    // Loop the file; a partial frame at the end is dropped
+                    ::lseek(fd, 0, SEEK_SET);
+                    filled = 0;
+                }
+            } else if ((filled += static_cast<size_t>(n)) == frameBytes) {
+                filled = 0;
+                mapper_.render(frame.data(), width, height, PixelFormat::RGB);
+                if (regular) {
+                    next += period_;
+                    clock_.sleepUntil(next, running_);
+                }
+            }
+        }
+        ::close(fd);
+    }
+}
+
+void PixelSource::runSharedMemory() {
+    trace::setThreadName("pixel-source");
+    uint16_t width = mapper_.width();
+    uint16_t height = mapper_.height();
+    std::vector<uint8_t> frame;
+    const uint8_t* base = nullptr;
+    size_t size = 0;
+    uint64_t lastSequence = 0;
+    bool warned = false;
+    auto next = clock_.now();
+
+    while (running_.load()) {
+        next += period_;
+        auto now = clock_.now();
+        if (next < now) next = now + period_;
+
+        // The writer may start after us; keep looking for its segment
+        if (!base) {
+            int fd = ::shm_open(path_.c_str(), O_RDONLY, 0);
+            struct stat st{};
+            if (fd >= 0 && ::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= pixelshm::HEADER_SIZE) {
+                void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+                if (p != MAP_FAILED) {
+                    base = static_cast<const uint8_t*>(p);
+                    size = static_cast<size_t>(st.st_size);
+                }
+            }
+            if (fd >= 0) ::close(fd);
+            if (base && std::memcmp(base, pixelshm::MAGIC, sizeof(pixelshm::MAGIC)) != 0) {
+                spdlog::error("Pixel source: {} is not a photon pixel segment", path_);
+                ::munmap(const_cast<uint8_t*>(base), size);
+                return;
+            }
+        }
+
+        if (base) {
+            uint32_t header[3];
+            std::memcpy(header, base + sizeof(pixelshm::MAGIC), sizeof(header));
+            size_t frameBytes = size_t{header[0]} * header[1] * header[2];
+            bool valid = header[0] == width && header[1] == height && (header[2] == 3 || header[2] == 4) &&
+                         size >= pixelshm::HEADER_SIZE + frameBytes;
+            if (!valid && !warned) {
+                spdlog::warn("Pixel source: {} holds {}x{}x{} frames, the map wants {}x{}", path_,
+                             header[0], header[1], header[2], width, height);
+            }
+            warned = !valid;
+
+            auto* sequence = reinterpret_cast<const std::atomic<uint64_t>*>(base + pixelshm::SEQUENCE_OFFSET);
+            uint64_t seq = sequence->load(std::memory_order_acquire);
+            if (valid && seq != lastSequence && seq % 2 == 0) {
+                frame.resize(frameBytes);
+                std::memcpy(frame.data(), base + pixelshm::HEADER_SIZE, frameBytes);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                // Torn if the writer started another frame meanwhile; next poll retries
+                if (sequence->load(std::memory_order_relaxed) == seq) {
+                    lastSequence = seq;
+                    mapper_.render(frame.data(), width, height,
+                                   header[2] == 4 ? PixelFormat::RGBA : PixelFormat::RGB);
+                }
+            }
+        }
+
+        clock_.sleepUntil(next, running_);
+    }
+    if (base) ::munmap(const_cast<uint8_t*>(base), size);
+}
+
+#endif
+
+} // namespace photon
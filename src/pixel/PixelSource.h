@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include "engine/Clock.h"
+#include "pixel/PixelMapper.h"
+
+namespace photon {
+
+namespace pixelshm {
+
+// Shared-memory frame layout (little-endian), followed by the pixels:
+//   char[8] "PHOTPIXL" | u32 width | u32 height | u32 bytes per pixel (3, 4)
+//   | u32 reserved | u64 sequence
+// The writer makes `sequence` odd while it copies a frame in and even once
+// the frame is complete (0 until the first one); readers skip odd values and
+// retry a frame whose sequence changed while they copied it.
+constexpr char MAGIC[8] = {'P', 'H', 'O', 'T', 'P', 'I', 'X', 'L'};
+constexpr size_t HEADER_SIZE = 32;
+constexpr size_t SEQUENCE_OFFSET = 24;
+
+} // namespace pixelshm
+
+// Feeds a PixelMapper from outside the process, on a "pixel-source" thread:
+//  - a raw stream of frames at the map's size, RGB, back to back (what
+//    `ffmpeg -f rawvideo -pix_fmt rgb24` writes). A named pipe is rendered as
+//    fast as the writer sends; a regular file is played at `fps` and loops.
+//  - a POSIX shared-memory segment (see pixelshm), polled at `fps` with each
+//    new frame rendered once.
+class PixelSource {
+public:
+    explicit PixelSource(PixelMapper& mapper, Clock& clock = Clock::system());
+    ~PixelSource();
+
+    bool startStream(const std::string& path, double fps);
+    bool startSharedMemory(const std::string& name, double fps);
+    void stop();
+
+private:
+    void runStream();
+    void runSharedMemory();
+
+    PixelMapper& mapper_;
+    Clock& clock_;
+    std::string path_;
+    Clock::duration period_{};
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+};
+
+} // namespace photon
@@ -1,45 +1,50 @@
 #pragma once
 #include "protocol/OutputDevice.h"
+#include "protocol/UdpTransport.h"
 #include <array>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 
-#ifdef _WIN32
-#include <winsock2.h>
-#include <ws2tcpip.h>
-#else
-#include <netinet/in.h>
-#endif
-
 namespace photon {
 
 class ArtNetSender : public OutputDevice {
 public:
     static constexpr uint16_t ARTNET_PORT = 6454;
+    static constexpr size_t PACKET_SIZE = 530;
 
     explicit ArtNetSender(const std::string& targetIp = "255.255.255.255",
-                          uint16_t port = ARTNET_PORT);
+                          uint16_t port = ARTNET_PORT,
+                          UdpBackend backend = UdpBackend::Socket);
     ~ArtNetSender() override;
 
     bool open() override;
     void close() override;
     bool isOpen() const override;
     void send(uint16_t universe, const std::array<uint8_t, 512>& data) override;
+    void flush() override;
     std::string getTypeName() const override;
     std::string getDescription() const override;
+    DeviceStats getStats() const override;
 
     const std::string& getTargetIp() const { return targetIp_; }
     uint16_t getPort() const { return port_; }
+    UdpBackend getBackend() const { return backend_; }
 
-private:
-    void buildPacket(uint16_t universe, const std::array<uint8_t, 512>& data);
+    // Fills PACKET_SIZE bytes with an ArtDmx packet and advances the sequence
+    void buildPacket(uint16_t universe, const std::array<uint8_t, 512>& data, uint8_t* packet);
 
+private:
     std::string targetIp_;
     uint16_t port_;
-    int socket_{-1};
+    UdpBackend backend_;
+    // close() runs on a web thread while the output thread may be inside
+    // send()/flush(); the io_uring transport frees its buffers on reset, so
+    // every use of transport_ (and sequence_) holds this lock
+    mutable std::mutex mutex_;
+    std::unique_ptr<UdpTransport> transport_;
     uint8_t sequence_{1};
-    std::array<uint8_t, 530> packet_{};
-    struct sockaddr_in destAddr_{};
 };
 
 } // namespace photon
@@ -22,11 +22,15 @@ void DeviceManager::removeDevice(const std::string& id) {
     std::unique_lock lock(mutex_);
     auto it = std::find_if(devices_.begin(), devices_.end(),
                            [&](const DeviceAssignment& d) { return d.id == id; });
-    if (it != devices_.end()) {
-        it->device->close();
-        spdlog::info("Device removed: {}", id);
-        devices_.erase(it);
-    }
+    if (it == devices_.end()) return;
+
+    auto device = std::move(it->device);
+    devices_.erase(it);
+    spdlog::info("Device removed: {}", id);
+    // One sender commonly serves several universes; it stays open for the rest
+    bool shared = std::any_of(devices_.begin(), devices_.end(),
+                              [&](const DeviceAssignment& d) { return d.device == device; });
+    if (!shared) device->close();
 }
 
 std::vector<std::shared_ptr<OutputDevice>> DeviceManager::getDevicesForUniverse(uint16_t universe) const {
@@ -0,0 +1,312 @@
+#include "protocol/IoUringTransport.h"
+#include <spdlog/spdlog.h>
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#endif
+
+namespace photon {
+
+#ifndef __linux__
+
+IoUringTransport::~IoUringTransport() = default;
+bool IoUringTransport::open(const sockaddr_in&) { return false; }
+void IoUringTransport::close() {}
+bool IoUringTransport::isOpen() const { return false; }
+uint8_t* IoUringTransport::acquire(size_t) { return nullptr; }
+void IoUringTransport::commit(size_t) {}
+void IoUringTransport::flush() {}
+bool IoUringTransport::reapCompletions() { return false; }
+void IoUringTransport::queueSend(uint16_t) {}
+void IoUringTransport::clearFixedFlags() {}
+
+#else
+
+namespace {
+
+int sysSetup(unsigned entries, io_uring_params* p) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, p));
+}
+
+int sysEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+int sysRegister(int fd, unsigned opcode, const void* arg, unsigned nrArgs) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs));
+}
+
+template <typename T>
+T* ringPtr(void* base, uint32_t offset) {
+    return reinterpret_cast<T*>(static_cast<uint8_t*>(base) + offset);
+}
+
+bool probeSend(int ringFd) {
+    constexpr unsigned OPS = 256;
+    std::vector<uint8_t> buf(sizeof(io_uring_probe) + OPS * sizeof(io_uring_probe_op), 0);
+    auto* probe = reinterpret_cast<io_uring_probe*>(buf.data());
+    if (sysRegister(ringFd, IORING_REGISTER_PROBE, probe, OPS) < 0) return false;
+    return probe->last_op >= IORING_OP_SEND &&
+           (probe->ops[IORING_OP_SEND].flags & IO_URING_OP_SUPPORTED);
+}
+
+} // namespace
+
+IoUringTransport::~IoUringTransport() {
+    close();
+}
+
+bool IoUringTransport::open(const sockaddr_in& dest) {
+    if (isOpen()) return true;
+
+    socket_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (socket_ < 0) {
+        spdlog::error("io_uring: failed to create UDP socket");
+        return false;
+    }
+    int broadcastEnable = 1;
+    setsockopt(socket_, SOL_SOCKET, SO_BROADCAST, &broadcastEnable, sizeof(broadcastEnable));
+
+    // Connected socket so each SQE is a plain IORING_OP_SEND with no msghdr
+    if (::connect(socket_, reinterpret_cast<const sockaddr*>(&dest), sizeof(dest)) != 0) {
+        spdlog::warn("io_uring: connect failed: {}", std::strerror(errno));
+        close();
+        return false;
+    }
+
+    io_uring_params params{};
+    ringFd_ = sysSetup(SLOT_COUNT, &params);
+    if (ringFd_ < 0) {
+        spdlog::info("io_uring: setup failed: {}", std::strerror(errno));
+        close();
+        return false;
+    }
+
+    sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap) sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+
+    sqRing_ = ::mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     ringFd_, IORING_OFF_SQ_RING);
+    if (sqRing_ == MAP_FAILED) {
+        sqRing_ = nullptr;
+        close();
+        return false;
+    }
+    if (singleMmap) {
+        cqRing_ = sqRing_;
+    } else {
+        cqRing_ = ::mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         ringFd_, IORING_OFF_CQ_RING);
+        if (cqRing_ == MAP_FAILED) {
+            cqRing_ = nullptr;
+            close();
+            return false;
+        }
+    }
+
+    sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ringFd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        close();
+        return false;
+    }
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    sqHead_ = ringPtr<unsigned>(sqRing_, params.sq_off.head);
+    sqTail_ = ringPtr<unsigned>(sqRing_, params.sq_off.tail);
+    sqMask_ = ringPtr<unsigned>(sqRing_, params.sq_off.ring_mask);
+    sqArray_ = ringPtr<unsigned>(sqRing_, params.sq_off.array);
+    cqHead_ = ringPtr<unsigned>(cqRing_, params.cq_off.head);
+    cqTail_ = ringPtr<unsigned>(cqRing_, params.cq_off.tail);
+    cqMask_ = ringPtr<unsigned>(cqRing_, params.cq_off.ring_mask);
+    cqes_ = ringPtr<io_uring_cqe>(cqRing_, params.cq_off.cqes);
+
+    if (!probeSend(ringFd_)) {
+        spdlog::info("io_uring: kernel does not support IORING_OP_SEND");
+        close();
+        return false;
+    }
+
+    slabSize_ = static_cast<size_t>(SLOT_COUNT) * SLOT_SIZE;
+    void* slab = ::mmap(nullptr, slabSize_, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (slab == MAP_FAILED) {
+        close();
+        return false;
+    }
+    slab_ = static_cast<uint8_t*>(slab);
+
+    // Registering pins the slab once instead of on every send. Kernels that
+    // reject fixed-buffer sends get plain sends from the same slab.
+    iovec iov{slab_, slabSize_};
+    bool registered = sysRegister(ringFd_, IORING_REGISTER_BUFFERS, &iov, 1) == 0;
+#ifdef IORING_RECVSEND_FIXED_BUF
+    fixedBuffers_ = registered;
+#else
+    fixedBuffers_ = false;
+#endif
+
+    freeSlots_.clear();
+    for (unsigned i = SLOT_COUNT; i > 0; --i) freeSlots_.push_back(static_cast<uint16_t>(i - 1));
+    slotLength_.assign(SLOT_COUNT, 0);
+    slotFixed_.assign(SLOT_COUNT, false);
+    acquiredSlot_ = -1;
+    pendingSubmit_ = 0;
+
+    spdlog::info("io_uring: transmit ring ready ({} slots{})", SLOT_COUNT,
+                 registered ? ", registered buffers" : "");
+    return true;
+}
+
+void IoUringTransport::close() {
+    // Closing the ring first lets the kernel finish in-flight sends before the
+    // slab they point into goes away
+    if (ringFd_ >= 0) ::close(ringFd_);
+    if (sqes_) ::munmap(sqes_, sqesSize_);
+    if (cqRing_ && cqRing_ != sqRing_) ::munmap(cqRing_, cqRingSize_);
+    if (sqRing_) ::munmap(sqRing_, sqRingSize_);
+    if (slab_) ::munmap(slab_, slabSize_);
+    if (socket_ >= 0) ::close(socket_);
+
+    ringFd_ = -1;
+    socket_ = -1;
+    sqRing_ = cqRing_ = nullptr;
+    sqes_ = nullptr;
+    cqes_ = nullptr;
+    slab_ = nullptr;
+    freeSlots_.clear();
+}
+
+bool IoUringTransport::isOpen() const {
+    return ringFd_ >= 0 && slab_ != nullptr;
+}
+
+uint8_t* IoUringTransport::acquire(size_t size) {
+    if (!isOpen() || size > SLOT_SIZE) return nullptr;
+
+    if (freeSlots_.empty()) reapCompletions();
+    if (freeSlots_.empty()) {
+        errors_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    acquiredSlot_ = freeSlots_.back();
+    freeSlots_.pop_back();
+    return slab_ + static_cast<size_t>(acquiredSlot_) * SLOT_SIZE;
+}
+
+void IoUringTransport::commit(size_t size) {
+    if (acquiredSlot_ < 0) return;
+    auto slot = static_cast<uint16_t>(acquiredSlot_);
+    acquiredSlot_ = -1;
+    slotLength_[slot] = static_cast<uint32_t>(size);
+    queueSend(slot);
+}
+
+void IoUringTransport::queueSend(uint16_t slot) {
+    unsigned tail = *sqTail_;
+    unsigned index = tail & *sqMask_;
+    io_uring_sqe* sqe = &sqes_[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = socket_;
+    sqe->addr = reinterpret_cast<uint64_t>(slab_ + static_cast<size_t>(slot) * SLOT_SIZE);
+    sqe->len = slotLength_[slot];
+    sqe->user_data = slot;
+    slotFixed_[slot] = fixedBuffers_;
+#ifdef IORING_RECVSEND_FIXED_BUF
+    if (fixedBuffers_) {
+        sqe->ioprio = IORING_RECVSEND_FIXED_BUF;
+        sqe->buf_index = 0;
+    }
+#endif
+    sqArray_[index] = index;
+
+    __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+    ++pendingSubmit_;
+}
+
+void IoUringTransport::flush() {
+    if (!isOpen()) return;
+    reapCompletions();
+
+    auto t0 = std::chrono::steady_clock::now();
+    // A second pass only happens when the kernel rejected registered-buffer
+    // sends inline: the batch stops at the first failed SQE, and reaping it
+    // requeues the packet as a plain send so it still goes out this tick
+    for (int pass = 0; pass < 2 && pendingSubmit_ > 0; ++pass) {
+        int ret = sysEnter(ringFd_, pendingSubmit_, 0, 0);
+        if (ret < 0) {
+            // SQEs stay queued and are retried on the next tick
+            errors_.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        pendingSubmit_ -= std::min(pendingSubmit_, static_cast<unsigned>(ret));
+        if (!reapCompletions()) break;
+    }
+    recordSubmit(std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - t0).count());
+}
+
+bool IoUringTransport::reapCompletions() {
+    bool requeued = false;
+    unsigned head = *cqHead_;
+    unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+
+    while (head != tail) {
+        const io_uring_cqe& cqe = cqes_[head & *cqMask_];
+        auto slot = static_cast<uint16_t>(cqe.user_data);
+        ++head;
+        if (slot >= SLOT_COUNT) continue;
+
+        if (cqe.res == -EINVAL && slotFixed_[slot]) {
+            // Kernel rejects fixed buffers for IORING_OP_SEND: switch to plain
+            // sends and requeue the packet, which is still in its slot
+            if (fixedBuffers_) {
+                spdlog::info("io_uring: fixed-buffer sends unsupported, using plain sends");
+                fixedBuffers_ = false;
+                clearFixedFlags();
+            }
+            queueSend(slot);
+            requeued = true;
+            continue;
+        }
+
+        if (cqe.res < 0) {
+            errors_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            packets_.fetch_add(1, std::memory_order_relaxed);
+            bytes_.fetch_add(static_cast<uint64_t>(cqe.res), std::memory_order_relaxed);
+        }
+        freeSlots_.push_back(slot);
+    }
+
+    __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+    return requeued;
+}
+
+void IoUringTransport::clearFixedFlags() {
+    // SQEs the kernel has not consumed yet still carry the fixed-buffer flag
+    unsigned head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+    for (unsigned tail = *sqTail_; head != tail; ++head) {
+        io_uring_sqe& sqe = sqes_[sqArray_[head & *sqMask_]];
+        sqe.ioprio = 0;
+        slotFixed_[static_cast<uint16_t>(sqe.user_data)] = false;
+    }
+}
+
+#endif
+
+} // namespace photon
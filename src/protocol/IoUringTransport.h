@@ -0,0 +1,73 @@
+#pragma once
+#include "protocol/UdpTransport.h"
+#include <cstdint>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace photon {
+
+// io_uring transmit path. Packets are built in place in a registered buffer
+// slab, commit() only fills an SQE, and flush() submits the whole tick with a
+// single io_uring_enter(). Completions are reaped from the CQ ring without a
+// syscall on the next acquire/flush. Uses the raw syscalls, so no liburing
+// dependency; open() fails cleanly on kernels (or sandboxes) without io_uring.
+class IoUringTransport : public UdpTransport {
+public:
+    static constexpr unsigned SLOT_COUNT = 1024;
+    static constexpr size_t SLOT_SIZE = 640;
+
+    IoUringTransport() = default;
+    ~IoUringTransport() override;
+
+    bool open(const sockaddr_in& dest) override;
+    void close() override;
+    bool isOpen() const override;
+
+    uint8_t* acquire(size_t size) override;
+    void commit(size_t size) override;
+    void flush() override;
+
+    UdpBackend getBackend() const override { return UdpBackend::IoUring; }
+
+private:
+    // Returns true if any completion was requeued for another submit.
+    bool reapCompletions();
+    void queueSend(uint16_t slot);
+    void clearFixedFlags();
+
+    int ringFd_{-1};
+    int socket_{-1};
+
+    // SQ ring
+    void* sqRing_{nullptr};
+    size_t sqRingSize_{0};
+    unsigned* sqHead_{nullptr};
+    unsigned* sqTail_{nullptr};
+    unsigned* sqMask_{nullptr};
+    unsigned* sqArray_{nullptr};
+    struct io_uring_sqe* sqes_{nullptr};
+    size_t sqesSize_{0};
+
+    // CQ ring (may share the SQ mapping)
+    void* cqRing_{nullptr};
+    size_t cqRingSize_{0};
+    unsigned* cqHead_{nullptr};
+    unsigned* cqTail_{nullptr};
+    unsigned* cqMask_{nullptr};
+    struct io_uring_cqe* cqes_{nullptr};
+
+    // Registered packet slab
+    uint8_t* slab_{nullptr};
+    size_t slabSize_{0};
+    std::vector<uint16_t> freeSlots_;
+    std::vector<uint32_t> slotLength_;
+    std::vector<bool> slotFixed_;
+    int acquiredSlot_{-1};
+    bool fixedBuffers_{false};
+
+    unsigned pendingSubmit_{0};
+};
+
+} // namespace photon
@@ -5,6 +5,16 @@
 
 namespace photon {
 
+struct DeviceStats {
+    const char* transport{""};
+    uint64_t packets{0};
+    uint64_t bytes{0};
+    uint64_t errors{0};
+    uint64_t flushes{0};
+    double lastSubmitUs{0};  // time spent submitting the last tick
+    double maxSubmitUs{0};
+};
+
 class OutputDevice {
 public:
     virtual ~OutputDevice() = default;
@@ -12,8 +22,11 @@ public:
     virtual void close() = 0;
     virtual bool isOpen() const = 0;
     virtual void send(uint16_t universe, const std::array<uint8_t, 512>& data) = 0;
+    // Called once per output tick after all send() calls for that tick
+    virtual void flush() {}
     virtual std::string getTypeName() const = 0;
     virtual std::string getDescription() const = 0;
+    virtual DeviceStats getStats() const { return {}; }
 };
 
 } // namespace photon
@@ -0,0 +1,130 @@
+#include "protocol/UdpTransport.h"
+#include "protocol/IoUringTransport.h"
+#include <spdlog/spdlog.h>
+#include <chrono>
+
+#ifdef _WIN32
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+
+namespace photon {
+
+UdpBackend parseUdpBackend(const std::string& name) {
+    if (name == "io_uring" || name == "iouring" || name == "uring") return UdpBackend::IoUring;
+    return UdpBackend::Socket;
+}
+
+const char* udpBackendName(UdpBackend backend) {
+    switch (backend) {
+        case UdpBackend::IoUring: return "io_uring";
+        case UdpBackend::Socket: break;
+    }
+    return "socket";
+}
+
+DeviceStats UdpTransport::getStats() const {
+    DeviceStats s;
+    s.transport = udpBackendName(getBackend());
+    s.packets = packets_.load(std::memory_order_relaxed);
+    s.bytes = bytes_.load(std::memory_order_relaxed);
+    s.errors = errors_.load(std::memory_order_relaxed);
+    s.flushes = flushes_.load(std::memory_order_relaxed);
+    s.lastSubmitUs = lastSubmitUs_.load(std::memory_order_relaxed);
+    s.maxSubmitUs = maxSubmitUs_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void UdpTransport::recordSubmit(double us) {
+    flushes_.fetch_add(1, std::memory_order_relaxed);
+    lastSubmitUs_.store(us, std::memory_order_relaxed);
+    if (us > maxSubmitUs_.load(std::memory_order_relaxed)) {
+        maxSubmitUs_.store(us, std::memory_order_relaxed);
+    }
+}
+
+std::unique_ptr<UdpTransport> UdpTransport::create(UdpBackend backend, const sockaddr_in& dest) {
+    if (backend == UdpBackend::IoUring) {
+        auto uring = std::make_unique<IoUringTransport>();
+        if (uring->open(dest)) return uring;
+        spdlog::warn("io_uring transport unavailable, falling back to sockets");
+    }
+
+    auto sock = std::make_unique<SocketTransport>();
+    if (!sock->open(dest)) return nullptr;
+    return sock;
+}
+
+// ── SocketTransport ─────────────────────────────────────────────
+
+SocketTransport::~SocketTransport() {
+    close();
+}
+
+bool SocketTransport::open(const sockaddr_in& dest) {
+    if (socket_ >= 0) return true;
+
+    socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket_ < 0) {
+        spdlog::error("UDP: failed to create socket");
+        return false;
+    }
+
+    int broadcastEnable = 1;
+    setsockopt(socket_, SOL_SOCKET, SO_BROADCAST,
+               reinterpret_cast<const char*>(&broadcastEnable),
+               sizeof(broadcastEnable));
+
+    destAddr_ = dest;
+    return true;
+}
+
+void SocketTransport::close() {
+    if (socket_ >= 0) {
+#ifdef _WIN32
+        closesocket(socket_);
+#else
+        ::close(socket_);
+#endif
+        socket_ = -1;
+    }
+}
+
+bool SocketTransport::isOpen() const {
+    return socket_ >= 0;
+}
+
+uint8_t* SocketTransport::acquire(size_t size) {
+    if (socket_ < 0 || size > MAX_PACKET) return nullptr;
+    return buffer_;
+}
+
+void SocketTransport::commit(size_t size) {
+    auto t0 = std::chrono::steady_clock::now();
+    auto sent = ::sendto(socket_,
+                         reinterpret_cast<const char*>(buffer_),
+                         static_cast<int>(size),
+                         0,
+                         reinterpret_cast<const struct sockaddr*>(&destAddr_),
+                         sizeof(destAddr_));
+    tickSubmitUs_ += std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - t0).count();
+
+    if (sent < 0) {
+        errors_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    packets_.fetch_add(1, std::memory_order_relaxed);
+    bytes_.fetch_add(size, std::memory_order_relaxed);
+}
+
+void SocketTransport::flush() {
+    // Packets already went out on commit; report the time spent in sendto
+    recordSubmit(tickSubmitUs_);
+    tickSubmitUs_ = 0;
+}
+
+} // namespace photon
@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "protocol/OutputDevice.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netinet/in.h>
+#endif
+
+namespace photon {
+
+enum class UdpBackend : uint8_t {
+    Socket,   // sendto() per packet
+    IoUring,  // one io_uring submission per tick (Linux only)
+};
+
+UdpBackend parseUdpBackend(const std::string& name);
+const char* udpBackendName(UdpBackend backend);
+
+// Transmit path for UDP output devices. A device fills a transport-owned
+// packet buffer (acquire/commit) for every packet of a tick, and the output
+// scheduler calls flush() once per tick. Transports may send on commit or
+// defer everything to flush().
+class UdpTransport {
+public:
+    virtual ~UdpTransport() = default;
+
+    virtual bool open(const sockaddr_in& dest) = 0;
+    virtual void close() = 0;
+    virtual bool isOpen() const = 0;
+
+    // Returns a buffer of at least `size` bytes, or nullptr if none is free.
+    virtual uint8_t* acquire(size_t size) = 0;
+    virtual void commit(size_t size) = 0;
+    virtual void flush() = 0;
+
+    virtual UdpBackend getBackend() const = 0;
+
+    DeviceStats getStats() const;
+
+    // Creates a transport for `backend`, falling back to plain sockets when
+    // the requested backend is unavailable on this system.
+    static std::unique_ptr<UdpTransport> create(UdpBackend backend, const sockaddr_in& dest);
+
+protected:
+    void recordSubmit(double us);
+
+    std::atomic<uint64_t> packets_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> errors_{0};
+    std::atomic<uint64_t> flushes_{0};
+    std::atomic<double> lastSubmitUs_{0};
+    std::atomic<double> maxSubmitUs_{0};
+};
+
+class SocketTransport : public UdpTransport {
+public:
+    SocketTransport() = default;
+    ~SocketTransport() override;
+
+    bool open(const sockaddr_in& dest) override;
+    void close() override;
+    bool isOpen() const override;
+
+    uint8_t* acquire(size_t size) override;
+    void commit(size_t size) override;
+    void flush() override;
+
+    UdpBackend getBackend() const override { return UdpBackend::Socket; }
+
+private:
+    static constexpr size_t MAX_PACKET = 1472;
+
+    int socket_{-1};
+    struct sockaddr_in destAddr_{};
+    uint8_t buffer_[MAX_PACKET]{};
+    double tickSubmitUs_{0};
+};
+
+} // namespace photon
@@ -0,0 +1,40 @@
+#include "relay/DeltaEncoder.h"
+#include "web/WsProtocol.h"
+#include <cstring>
+
+namespace photon {
+
+DeltaEncoder::DeltaEncoder(Clock::duration keyframeInterval)
+    : keyframeInterval_(keyframeInterval) {}
+
+std::string DeltaEncoder::encode(uint16_t universe, const uint8_t* channels, Clock::time_point now) {
+    if (universe >= universes_.size()) universes_.resize(universe + 1);
+    auto& state = universes_[universe];
+
+    std::string frame;
+    bool keyframe = !state.valid || now - state.lastKeyframe >= keyframeInterval_;
+    if (!keyframe) {
+        if (std::memcmp(state.sent.data(), channels, 512) == 0) return {};
+        frame = wsproto::encodeDmxDelta(universe, state.seq + 1, state.sent.data(), channels);
+        keyframe = frame.size() >= wsproto::DMX_STATE_SIZE;
+    }
+
+    ++state.seq;
+    if (keyframe) {
+        frame = wsproto::encodeDmxState(universe, state.seq, channels);
+        state.valid = true;
+        state.lastKeyframe = now;
+        ++stats_.keyframes;
+    } else {
+        ++stats_.deltas;
+    }
+    std::memcpy(state.sent.data(), channels, 512);
+    stats_.bytes += frame.size();
+    return frame;
+}
+
+void DeltaEncoder::reset() {
+    for (auto& state : universes_) state.valid = false;
+}
+
+} // namespace photon
@@ -0,0 +1,47 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace photon {
+
+// Turns each universe's latest channels into the relay uplink's binary
+// frames: a DmxState keyframe when there is no base to diff against, when the
+// keyframe interval has passed, or when a delta would be no smaller, and a
+// DmxDelta against the previously sent frame otherwise. The uplink is one
+// ordered connection, so the previous frame is the receiver's state; reset()
+// after a reconnect forces keyframes again.
+class DeltaEncoder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit DeltaEncoder(Clock::duration keyframeInterval = std::chrono::seconds(2));
+
+    // Empty when nothing changed and no keyframe is due
+    std::string encode(uint16_t universe, const uint8_t* channels, Clock::time_point now);
+
+    void reset();
+
+    struct Stats {
+        uint64_t keyframes{0};
+        uint64_t deltas{0};
+        uint64_t bytes{0};
+    };
+    Stats getStats() const { return stats_; }
+
+private:
+    struct UniverseState {
+        bool valid{false};
+        uint32_t seq{0};
+        Clock::time_point lastKeyframe;
+        std::array<uint8_t, 512> sent{};
+    };
+
+    Clock::duration keyframeInterval_;
+    std::vector<UniverseState> universes_;
+    Stats stats_;
+};
+
+} // namespace photon
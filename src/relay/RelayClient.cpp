@@ -1,4 +1,9 @@
 #include "relay/RelayClient.h"
+#include "engine/CommandParser.h"
+#include "web/WsProtocol.h"
+#include "metrics/Metrics.h"
+#include "metrics/Trace.h"
+#include "engine/ThreadPlacement.h"
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 #include <chrono>
@@ -7,9 +12,25 @@ namespace photon {
 
 using json = nlohmann::json;
 
+namespace {
+
+// Past this much unsent data the send thread skips ticks, letting newer
+// states replace the ones it would have queued
+constexpr size_t BACKLOG_LIMIT = 64 * 1024;
+
+metrics::Counter relaySentBytes{"photon_relay_sent_bytes_total",
+    "DMX frame bytes sent on the relay uplink"};
+metrics::Counter relaySuperseded{"photon_relay_states_superseded_total",
+    "Universe states replaced by a newer one before the relay sent them"};
+metrics::Counter relayThrottled{"photon_relay_throttled_ticks_total",
+    "Relay send ticks skipped because the uplink backlog was over the limit"};
+
+} // namespace
+
 RelayClient::RelayClient(const std::string& relayUrl, const std::string& relayToken,
-                         ActionQueue<Action>& actionQueue)
-    : relayUrl_(relayUrl), relayToken_(relayToken), actionQueue_(actionQueue) {}
+                         InputCoalescer& input, double rateHz, Clock& clock)
+    : relayUrl_(relayUrl), relayToken_(relayToken), input_(input),
+      rateHz_(rateHz > 0 ? rateHz : 15.0), clock_(clock), batchRuns_(wsproto::MAX_BATCH_RUNS) {}
 
 RelayClient::~RelayClient() {
     stop();
@@ -19,6 +40,8 @@ void RelayClient::start() {
     if (running_.exchange(true)) return;
 
     ws_.setUrl(relayUrl_);
+    // DMX deltas are small but repetitive; compression roughly halves them again
+    ws_.setPerMessageDeflateOptions(ix::WebSocketPerMessageDeflateOptions(true));
     ws_.setOnMessageCallback([this](const ix::WebSocketMessagePtr& msg) {
         onMessage(msg);
     });
@@ -28,14 +51,16 @@ void RelayClient::start() {
     ws_.setMinWaitBetweenReconnectionRetries(1000);
     ws_.setMaxWaitBetweenReconnectionRetries(30000);
 
-    ws_.start();
-    spdlog::info("Relay client connecting to {}", relayUrl_);
+    sendThread_ = std::thread([this] { sendLoop(); });
+    spdlog::info("Relay client connecting to {} (uplink {:.0f} Hz)", relayUrl_, rateHz_);
 }
 
 void RelayClient::stop() {
     if (!running_.exchange(false)) return;
 
     stopHeartbeat();
+    clock_.wake();
+    if (sendThread_.joinable()) sendThread_.join();
     ws_.stop();
     spdlog::info("Relay client stopped");
 }
@@ -46,6 +71,13 @@ void RelayClient::onMessage(const ix::WebSocketMessagePtr& msg) {
         authenticated_.store(false);
         sendAuth();
     } else if (msg->type == ix::WebSocketMessageType::Message) {
+        if (msg->binary) {
+            handleBatch(msg->str);
+            return;
+        }
+        // Commands are the bulk of relay traffic; skip the DOM for them
+        if (command::parseRelayCommand(msg->str, input_) != command::Type::None) return;
+
         json data;
         try {
             data = json::parse(msg->str);
@@ -56,6 +88,7 @@ void RelayClient::onMessage(const ix::WebSocketMessagePtr& msg) {
         auto type = data.value("type", "");
 
         if (type == "auth_ack") {
+            resync_.store(true);
             authenticated_.store(true);
             spdlog::info("Relay authenticated (instance: {})",
                          data.value("instanceId", "unknown"));
@@ -63,7 +96,7 @@ void RelayClient::onMessage(const ix::WebSocketMessagePtr& msg) {
         } else if (type == "command") {
             // Command from browser client via relay
             if (data.contains("data")) {
-                handleCommand(data["data"].dump());
+                handleCommand(data["data"]);
             }
         } else if (type == "heartbeat_ack") {
             // Heartbeat acknowledged
@@ -78,14 +111,8 @@ void RelayClient::onMessage(const ix::WebSocketMessagePtr& msg) {
     }
 }
 
-void RelayClient::handleCommand(const std::string& data) {
-    json cmd;
-    try {
-        cmd = json::parse(data);
-    } catch (...) {
-        return;
-    }
-
+void RelayClient::handleCommand(const json& cmd) {
+    if (!cmd.is_object()) return;
     auto type = cmd.value("type", "");
 
     if (type == "set_channel") {
@@ -93,15 +120,40 @@ void RelayClient::handleCommand(const std::string& data) {
         auto channel = cmd.value("channel", -1);
         auto value = cmd.value("value", -1);
         if (universe >= 0 && channel >= 0 && value >= 0) {
-            actionQueue_.push(action::SetChannel{
+            input_.push(action::SetChannel{
                 static_cast<uint16_t>(universe),
                 static_cast<uint16_t>(channel),
                 static_cast<uint8_t>(value)
             });
         }
     } else if (type == "blackout") {
-        actionQueue_.push(action::Blackout{});
+        input_.push(action::Blackout{});
+    }
+}
+
+void RelayClient::handleBatch(const std::string& data) {
+    wsproto::Header header{};
+    size_t count = 0;
+    bool blackout = false;
+    if (!wsproto::decodeCommandBatch(data, header, batchRuns_.data(), count, blackout)) {
+        spdlog::warn("Invalid command batch from relay ({} bytes)", data.size());
+        return;
+    }
+    input_.pushRuns(batchRuns_.data(), count, blackout);
+    if (blackout) spdlog::info("Blackout triggered via relay");
+
+    std::lock_guard lock(ackMutex_);
+    pendingAcks_[header.universe] = header.seq;
+}
+
+void RelayClient::sendAcks() {
+    {
+        std::lock_guard lock(ackMutex_);
+        if (pendingAcks_.empty()) return;
+        sendingAcks_.swap(pendingAcks_);
     }
+    for (const auto& [client, seq] : sendingAcks_) ws_.send(wsproto::batchAck(client, seq));
+    sendingAcks_.clear();
 }
 
 void RelayClient::sendAuth() {
@@ -115,9 +167,11 @@ void RelayClient::startHeartbeat() {
     stopHeartbeat();
     heartbeatRunning_.store(true);
     heartbeatThread_ = std::thread([this] {
+        // Skips beats while disconnected rather than exiting, so the thread
+        // always ends through stopHeartbeat()
         while (heartbeatRunning_.load()) {
-            std::this_thread::sleep_for(std::chrono::seconds(15));
-            if (!heartbeatRunning_.load() || !authenticated_.load()) break;
+            clock_.sleepFor(std::chrono::seconds(15), heartbeatRunning_);
+            if (!heartbeatRunning_.load() || !authenticated_.load()) continue;
             json hb;
             hb["type"] = "heartbeat";
             ws_.send(hb.dump());
@@ -127,13 +181,89 @@ void RelayClient::startHeartbeat() {
 
 void RelayClient::stopHeartbeat() {
     heartbeatRunning_.store(false);
+    clock_.wake();
     if (heartbeatThread_.joinable()) heartbeatThread_.join();
 }
 
-// BroadcastObserver — forward DMX state to relay
-void RelayClient::onDmxState(uint16_t /*universe*/, const std::string& jsonPayload) {
-    if (!authenticated_.load()) return;
-    ws_.send(jsonPayload);
+// BroadcastObserver — keep the latest state for the send thread. Runs on the
+// broadcaster thread, so it never touches the socket.
+void RelayClient::onDmxState(uint16_t universe, const uint8_t* channels) {
+    std::lock_guard lock(slotMutex_);
+    if (universe >= slots_.size()) slots_.resize(universe + 1);
+    auto& slot = slots_[universe];
+    std::copy(channels, channels + 512, slot.channels.begin());
+    slot.valid = true;
+    if (slot.dirty) {
+        relaySuperseded.inc();
+    } else {
+        slot.dirty = true;
+        dirty_.push_back(universe);
+    }
+}
+
+void RelayClient::sendLoop() {
+    trace::setThreadName("relay-send");
+    placement::apply(placement::Role::Relay, "relay-send");
+    // Started here so ixwebsocket's threads inherit the relay placement
+    ws_.start();
+    auto interval = std::chrono::microseconds(static_cast<long>(1'000'000.0 / rateHz_));
+    auto nextTick = clock_.now();
+
+    std::vector<uint16_t> universes;
+    std::vector<std::array<uint8_t, 512>> states;
+
+    while (running_.load()) {
+        nextTick += interval;
+        auto now = clock_.now();
+        if (nextTick < now) nextTick = now + interval;
+
+        if (!authenticated_.load()) {
+            clock_.sleepUntil(nextTick, running_);
+            continue;
+        }
+        // Acks are tiny and let remote clients keep commands in flight, so
+        // they go out even when state updates are being throttled
+        sendAcks();
+        if (ws_.bufferedAmount() > BACKLOG_LIMIT) {
+            relayThrottled.inc();
+            clock_.sleepUntil(nextTick, running_);
+            continue;
+        }
+
+        {
+            PHOTON_TRACE_SCOPE("relay.send");
+            bool resync = resync_.exchange(false);
+            universes.clear();
+            states.clear();
+            {
+                std::lock_guard lock(slotMutex_);
+                if (resync) {
+                    // A new relay session knows nothing: send every universe
+                    dirty_.clear();
+                    for (uint16_t u = 0; u < slots_.size(); ++u) {
+                        slots_[u].dirty = slots_[u].valid;
+                        if (slots_[u].valid) dirty_.push_back(u);
+                    }
+                }
+                for (auto u : dirty_) {
+                    universes.push_back(u);
+                    states.push_back(slots_[u].channels);
+                    slots_[u].dirty = false;
+                }
+                dirty_.clear();
+            }
+
+            if (resync) encoder_.reset();
+            for (size_t i = 0; i < universes.size(); ++i) {
+                auto frame = encoder_.encode(universes[i], states[i].data(), now);
+                if (frame.empty()) continue;
+                ws_.sendBinary(frame);
+                relaySentBytes.inc(frame.size());
+            }
+        }
+
+        clock_.sleepUntil(nextTick, running_);
+    }
 }
 
 void RelayClient::onUniverseCount(uint16_t count) {
@@ -144,4 +274,8 @@ void RelayClient::onUniverseCount(uint16_t count) {
     ws_.send(msg.dump());
 }
 
+size_t RelayClient::bufferedBytes() const {
+    return ws_.bufferedAmount();
+}
+
 } // namespace photon
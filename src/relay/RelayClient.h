@@ -1,42 +1,82 @@
 #pragma once
+#include <array>
 #include <atomic>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <functional>
+#include <unordered_map>
+#include <vector>
 #include <ixwebsocket/IXWebSocket.h>
+#include <nlohmann/json.hpp>
+#include "engine/Clock.h"
 #include "web/BroadcastObserver.h"
-#include "engine/ActionQueue.h"
+#include "engine/InputCoalescer.h"
+#include "relay/DeltaEncoder.h"
 
 namespace photon {
 
 class RelayClient : public BroadcastObserver {
 public:
     RelayClient(const std::string& relayUrl, const std::string& relayToken,
-                ActionQueue<Action>& actionQueue);
+                InputCoalescer& input, double rateHz = 15.0, Clock& clock = Clock::system());
     ~RelayClient();
 
     void start();
     void stop();
 
-    // BroadcastObserver interface
-    void onDmxState(uint16_t universe, const std::string& jsonPayload) override;
+    // BroadcastObserver interface. onDmxState only stores the latest state;
+    // the send thread forwards it at the relay's own rate.
+    void onDmxState(uint16_t universe, const uint8_t* channels) override;
     void onUniverseCount(uint16_t count) override;
 
+    // Bytes ixwebsocket has yet to write to the relay
+    size_t bufferedBytes() const;
+
 private:
     void onMessage(const ix::WebSocketMessagePtr& msg);
-    void handleCommand(const std::string& data);
+    void handleCommand(const nlohmann::json& cmd);
+    void handleBatch(const std::string& data);
+    void sendAcks();
     void sendAuth();
     void startHeartbeat();
     void stopHeartbeat();
+    void sendLoop();
 
     std::string relayUrl_;
     std::string relayToken_;
-    ActionQueue<Action>& actionQueue_;
+    InputCoalescer& input_;
+    double rateHz_;
+    Clock& clock_;
 
     ix::WebSocket ws_;
     std::atomic<bool> running_{false};
     std::atomic<bool> authenticated_{false};
 
+    // Latest channels per universe, written by the broadcaster and taken by
+    // the send thread; a state that was never sent is simply overwritten
+    struct Slot {
+        std::array<uint8_t, 512> channels{};
+        bool valid{false};
+        bool dirty{false};
+    };
+    std::mutex slotMutex_;
+    std::vector<Slot> slots_;
+    std::vector<uint16_t> dirty_;
+
+    // Owned by the send thread; resync_ asks it to resend every universe as a
+    // keyframe after the connection is re-established
+    DeltaEncoder encoder_;
+    std::atomic<bool> resync_{true};
+    std::thread sendThread_;
+
+    // Command batches: decoded on the ixwebsocket thread, acknowledged by the
+    // send thread once per tick with the latest seq from each relay client
+    std::vector<ChannelRun> batchRuns_;
+    std::mutex ackMutex_;
+    std::unordered_map<uint16_t, uint32_t> pendingAcks_;
+    std::unordered_map<uint16_t, uint32_t> sendingAcks_;
+
     std::thread heartbeatThread_;
     std::atomic<bool> heartbeatRunning_{false};
 };
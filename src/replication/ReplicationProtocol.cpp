@@ -0,0 +1,65 @@
+#include "replication/ReplicationProtocol.h"
+#include <cstring>
+
+namespace photon::replication {
+
+namespace {
+
+std::string encodeHeader(PacketType type, uint32_t session, uint32_t seq, uint64_t mergeVersion,
+                         uint16_t universe, size_t payloadSize) {
+    PacketHeader header{MAGIC, VERSION, static_cast<uint8_t>(type), universe, session, seq, mergeVersion};
+    std::string out;
+    out.reserve(sizeof(header) + payloadSize);
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    return out;
+}
+
+} // namespace
+
+std::string encodeHeartbeat(uint32_t session, uint32_t seq, uint64_t mergeVersion,
+                            uint16_t universeCount) {
+    auto out = encodeHeader(PacketType::Heartbeat, session, seq, mergeVersion, 0, sizeof(universeCount));
+    out.append(reinterpret_cast<const char*>(&universeCount), sizeof(universeCount));
+    return out;
+}
+
+std::string encodeUniverse(uint32_t session, uint32_t seq, uint64_t mergeVersion,
+                           uint16_t universe, const Universe::Planes& planes) {
+    uint8_t mask = planecodec::planeMask(planes);
+    size_t planeBytes = planecodec::encodedSize(mask);
+    auto out = encodeHeader(PacketType::Universe, session, seq, mergeVersion, universe, 2 + planeBytes);
+    out.push_back(static_cast<char>(mask));
+    out.push_back(0);
+    size_t at = out.size();
+    out.resize(at + planeBytes);
+    planecodec::encode(planes, mask, reinterpret_cast<uint8_t*>(out.data() + at));
+    return out;
+}
+
+std::string encodeResyncRequest(uint32_t session) {
+    return encodeHeader(PacketType::ResyncRequest, session, 0, 0, 0, 0);
+}
+
+bool decodeHeader(const uint8_t* data, size_t size, PacketHeader& header) {
+    if (size < sizeof(PacketHeader) || size > MAX_PACKET_SIZE) return false;
+    std::memcpy(&header, data, sizeof(header));
+    return header.magic == MAGIC && header.version == VERSION;
+}
+
+bool decodeHeartbeat(const uint8_t* data, size_t size, uint16_t& universeCount) {
+    if (size < sizeof(PacketHeader) + sizeof(universeCount)) return false;
+    std::memcpy(&universeCount, data + sizeof(PacketHeader), sizeof(universeCount));
+    return true;
+}
+
+bool decodeUniverse(const uint8_t* data, size_t size, Universe::Planes& planes) {
+    if (size < sizeof(PacketHeader) + 2) return false;
+    const uint8_t* p = data + sizeof(PacketHeader);
+    const uint8_t* end = data + size;
+    uint8_t mask = p[0];
+
+    planes = Universe::Planes{};
+    return planecodec::decode(p + 2, end, mask, planes) == end;
+}
+
+} // namespace photon::replication
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "engine/PlaneCodec.h"
+#include "engine/Universe.h"
+
+// Datagrams between a primary engine and its hot standby (host byte order;
+// both ends run the same build):
+//
+//   Heartbeat      primary -> standby   every tick; u16 universe count
+//   Universe       primary -> standby   one universe's priority planes: u8
+//                                       plane mask, u8 reserved, then the
+//                                       planes (see engine/PlaneCodec.h)
+//   ResyncRequest  standby -> primary   after a sequence gap; the primary
+//                                       resends every universe
+//
+// Universe packets carry absolute state, so the standby never needs the
+// packets it missed, only a fresh copy of the universes they covered.
+namespace photon::replication {
+
+inline constexpr uint32_t MAGIC = 0x50524850; // "PHRP"
+inline constexpr uint8_t VERSION = 1;
+
+enum class PacketType : uint8_t {
+    Heartbeat = 1,
+    Universe = 2,
+    ResyncRequest = 3,
+};
+
+struct PacketHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t type;
+    uint16_t universe;      // Universe packets
+    uint32_t session;       // random per primary process; a change means a new stream
+    uint32_t seq;           // per datagram, across all types
+    uint64_t mergeVersion;  // primary's MergeBuffer version when captured
+};
+
+inline constexpr size_t MAX_PACKET_SIZE = sizeof(PacketHeader) + 2 + planecodec::MAX_SIZE;
+
+std::string encodeHeartbeat(uint32_t session, uint32_t seq, uint64_t mergeVersion,
+                            uint16_t universeCount);
+std::string encodeUniverse(uint32_t session, uint32_t seq, uint64_t mergeVersion,
+                           uint16_t universe, const Universe::Planes& planes);
+std::string encodeResyncRequest(uint32_t session);
+
+// Validates magic, version and size; false for anything else.
+bool decodeHeader(const uint8_t* data, size_t size, PacketHeader& header);
+bool decodeHeartbeat(const uint8_t* data, size_t size, uint16_t& universeCount);
+bool decodeUniverse(const uint8_t* data, size_t size, Universe::Planes& planes);
+
+} // namespace photon::replication
@@ -0,0 +1,249 @@
+#include "replication/ReplicationReceiver.h"
+#include "replication/ReplicationProtocol.h"
+#include "metrics/Metrics.h"
+#include "metrics/Trace.h"
+#include <spdlog/spdlog.h>
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace photon {
+
+namespace {
+
+// Gaps closer together than this share one resend
+constexpr auto RESYNC_HOLDOFF = std::chrono::milliseconds(200);
+
+metrics::Counter standbyLost{"photon_replication_lost_packets_total",
+    "Replication packets the hot standby never received"};
+metrics::Counter standbyTakeovers{"photon_replication_takeovers_total",
+    "Times the hot standby took over output from a silent primary"};
+metrics::Gauge standbyActive{"photon_replication_standby_active",
+    "1 while the hot standby is driving output"};
+
+} // namespace
+
+ReplicationReceiver::ReplicationReceiver(MergeBuffer& mergeBuffer, RoleHandler onRoleChange)
+    : mergeBuffer_(mergeBuffer), onRoleChange_(std::move(onRoleChange)) {}
+
+ReplicationReceiver::~ReplicationReceiver() {
+    stop();
+}
+
+uint16_t ReplicationReceiver::getPort() const {
+    return port_;
+}
+
+bool ReplicationReceiver::isActive() const {
+    return active_.load();
+}
+
+bool ReplicationReceiver::handBack() {
+    if (!active_.load()) return false;
+    handbackRequested_.store(true);
+    return true;
+}
+
+ReplicationReceiver::Stats ReplicationReceiver::getStats() const {
+    Stats s;
+    s.packets = packets_.load(std::memory_order_relaxed);
+    s.universesApplied = universesApplied_.load(std::memory_order_relaxed);
+    s.lostPackets = lostPackets_.load(std::memory_order_relaxed);
+    s.resyncRequests = resyncRequests_.load(std::memory_order_relaxed);
+    s.takeovers = takeovers_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void ReplicationReceiver::setActive(bool active) {
+    if (active_.exchange(active) == active) return;
+    standbyActive.set(active ? 1 : 0);
+    if (onRoleChange_) onRoleChange_(active);
+}
+
+#ifdef _WIN32
+
+bool ReplicationReceiver::start(uint16_t port, std::chrono::milliseconds) {
+    spdlog::error("Replication is not supported on this platform (port {})", port);
+    return false;
+}
+
+void ReplicationReceiver::stop() {}
+void ReplicationReceiver::run() {}
+void ReplicationReceiver::handlePacket(const uint8_t*, size_t, const sockaddr_in&, Clock::time_point) {}
+void ReplicationReceiver::requestResync(const sockaddr_in&, Clock::time_point) {}
+void ReplicationReceiver::releaseOutput(Clock::time_point) {}
+
+#else
+
+bool ReplicationReceiver::start(uint16_t port, std::chrono::milliseconds failoverTimeout) {
+    if (running_.load()) return false;
+
+    socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket_ < 0) {
+        spdlog::error("Standby: failed to create socket: {}", std::strerror(errno));
+        return false;
+    }
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (::bind(socket_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        spdlog::error("Standby: cannot bind UDP port {}: {}", port, std::strerror(errno));
+        ::close(socket_);
+        socket_ = -1;
+        return false;
+    }
+    socklen_t len = sizeof(addr);
+    ::getsockname(socket_, reinterpret_cast<sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+
+    // Wake regularly to check the failover timeout while nothing arrives
+    timeval timeout{0, 20'000};
+    ::setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    failoverTimeout_ = failoverTimeout;
+    haveSession_ = false;
+    haveTakeoverSession_ = false;
+    lastHeard_ = Clock::now();
+    active_.store(false);
+    handbackRequested_.store(false);
+    standbyActive.set(0);
+    running_.store(true);
+    thread_ = std::thread([this] { run(); });
+    spdlog::info("Hot standby listening on UDP port {} (failover after {} ms)", port_,
+                 failoverTimeout.count());
+    return true;
+}
+
+void ReplicationReceiver::stop() {
+    if (!running_.exchange(false)) return;
+    if (thread_.joinable()) thread_.join();
+    ::close(socket_);
+    socket_ = -1;
+}
+
+void ReplicationReceiver::run() {
+    trace::setThreadName("standby");
+    std::vector<uint8_t> buffer(replication::MAX_PACKET_SIZE);
+
+    while (running_.load()) {
+        sockaddr_in from{};
+        socklen_t fromLen = sizeof(from);
+        auto n = ::recvfrom(socket_, buffer.data(), buffer.size(), 0,
+                            reinterpret_cast<sockaddr*>(&from), &fromLen);
+        auto now = Clock::now();
+        if (n > 0) handlePacket(buffer.data(), static_cast<size_t>(n), from, now);
+
+        if (!active_.load() && now - lastHeard_ >= failoverTimeout_) {
+            spdlog::warn("Standby: no primary heard for {} ms, taking over output",
+                         failoverTimeout_.count());
+            takeovers_.fetch_add(1, std::memory_order_relaxed);
+            standbyTakeovers.inc();
+            haveTakeoverSession_ = haveSession_;
+            takeoverSession_ = session_;
+            warnedNewSession_ = false;
+            setActive(true);
+        }
+
+        if (handbackRequested_.exchange(false) && active_.load()) {
+            if (haveSession_ && now - lastHeard_ < failoverTimeout_) {
+                spdlog::info("Standby: handing output back to the primary on request");
+                releaseOutput(now);
+            } else {
+                spdlog::warn("Standby: handback requested but no primary is streaming");
+            }
+        }
+    }
+}
+
+void ReplicationReceiver::handlePacket(const uint8_t* data, size_t size, const sockaddr_in& from,
+                                       Clock::time_point now) {
+    replication::PacketHeader header{};
+    if (!replication::decodeHeader(data, size, header)) return;
+    auto type = static_cast<replication::PacketType>(header.type);
+    if (type != replication::PacketType::Heartbeat && type != replication::PacketType::Universe) return;
+
+    packets_.fetch_add(1, std::memory_order_relaxed);
+    lastHeard_ = now;
+    primary_ = from;
+
+    if (!haveSession_ || header.session != session_) {
+        char host[INET_ADDRSTRLEN] = {};
+        ::inet_ntop(AF_INET, &from.sin_addr, host, sizeof(host));
+        spdlog::info("Standby: replicating from primary {}:{}", host, ntohs(from.sin_port));
+        haveSession_ = true;
+        session_ = header.session;
+        lastSeq_ = header.seq - 1;
+        appliedSeq_.assign(mergeBuffer_.getUniverseCount(), 0);
+        // Don't wait for the next keyframe to catch up with a new primary
+        requestResync(from, now);
+    }
+    if (active_.load()) {
+        if (!haveTakeoverSession_ || header.session != takeoverSession_) {
+            if (!warnedNewSession_) {
+                spdlog::warn("Standby: a new primary session is streaming while this standby drives "
+                             "output; keeping output until POST /api/standby/handback");
+                warnedNewSession_ = true;
+            }
+            lastSeq_ = header.seq;
+            return;
+        }
+        spdlog::info("Standby: primary is back, handing output back");
+        releaseOutput(now);
+    }
+
+    // Sequence numbers count every datagram, so any skip means lost state
+    int32_t delta = static_cast<int32_t>(header.seq - lastSeq_);
+    if (delta > 1) {
+        lostPackets_.fetch_add(static_cast<uint64_t>(delta - 1), std::memory_order_relaxed);
+        standbyLost.inc(static_cast<uint64_t>(delta - 1));
+        requestResync(from, now);
+    }
+    if (delta > 0) lastSeq_ = header.seq;
+
+    if (type == replication::PacketType::Heartbeat) {
+        uint16_t universeCount = 0;
+        if (replication::decodeHeartbeat(data, size, universeCount) &&
+            universeCount != mergeBuffer_.getUniverseCount() && !warnedUniverseCount_) {
+            spdlog::warn("Standby: primary has {} universes, this engine has {}",
+                         universeCount, mergeBuffer_.getUniverseCount());
+            warnedUniverseCount_ = true;
+        }
+        return;
+    }
+
+    // A reordered packet older than the state already applied is stale
+    if (header.universe >= appliedSeq_.size()) return;
+    auto& applied = appliedSeq_[header.universe];
+    if (applied != 0 && static_cast<int32_t>(header.seq - applied) <= 0) return;
+    if (!replication::decodeUniverse(data, size, planes_)) return;
+    PHOTON_TRACE_SCOPE_ARG("standby.apply", "universe", header.universe);
+    mergeBuffer_.setPlanes(header.universe, planes_);
+    applied = header.seq;
+    universesApplied_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ReplicationReceiver::releaseOutput(Clock::time_point now) {
+    setActive(false);
+    // Everything the primary sent while we ignored it is missing
+    lastResync_ = {};
+    requestResync(primary_, now);
+}
+
+void ReplicationReceiver::requestResync(const sockaddr_in& to, Clock::time_point now) {
+    if (now - lastResync_ < RESYNC_HOLDOFF) return;
+    lastResync_ = now;
+    auto packet = replication::encodeResyncRequest(session_);
+    ::sendto(socket_, packet.data(), packet.size(), 0, reinterpret_cast<const sockaddr*>(&to), sizeof(to));
+    resyncRequests_.fetch_add(1, std::memory_order_relaxed);
+}
+
+#endif
+
+} // namespace photon
@@ -0,0 +1,96 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "engine/MergeBuffer.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netinet/in.h>
+#endif
+
+namespace photon {
+
+// Standby side of hot-standby replication. Applies the primary's universe
+// packets to the local MergeBuffer and asks for a resend whenever the
+// sequence skips. When nothing has been heard from the primary for the
+// failover timeout, it takes over output. If the same primary session is
+// heard again (a network blip) it hands output back at once. A new session,
+// such as a restarted primary, may not hold the show state the standby has
+// been driving, so its packets are ignored until handBack() is called.
+class ReplicationReceiver {
+public:
+    // Called on the receiver thread with true on takeover, false on handback
+    using RoleHandler = std::function<void(bool outputActive)>;
+
+    ReplicationReceiver(MergeBuffer& mergeBuffer, RoleHandler onRoleChange);
+    ~ReplicationReceiver();
+
+    // Port 0 picks a free port (see getPort)
+    bool start(uint16_t port, std::chrono::milliseconds failoverTimeout);
+    void stop();
+    uint16_t getPort() const;
+    bool isActive() const;
+
+    // Hands output back to whichever primary is streaming, once it has been
+    // heard within the failover timeout; its state then replaces ours.
+    // False if the standby is not driving output.
+    bool handBack();
+
+    struct Stats {
+        uint64_t packets{0};
+        uint64_t universesApplied{0};
+        uint64_t lostPackets{0};
+        uint64_t resyncRequests{0};
+        uint64_t takeovers{0};
+    };
+    Stats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void run();
+    void handlePacket(const uint8_t* data, size_t size, const sockaddr_in& from, Clock::time_point now);
+    void requestResync(const sockaddr_in& to, Clock::time_point now);
+    void setActive(bool active);
+    void releaseOutput(Clock::time_point now);
+
+    MergeBuffer& mergeBuffer_;
+    RoleHandler onRoleChange_;
+    int socket_{-1};
+    uint16_t port_{0};
+    std::chrono::milliseconds failoverTimeout_{1000};
+
+    std::atomic<bool> running_{false};
+    std::atomic<bool> active_{false};
+    std::atomic<bool> handbackRequested_{false};
+    std::thread thread_;
+
+    // Receiver thread state
+    bool haveSession_{false};
+    uint32_t session_{0};
+    uint32_t lastSeq_{0};
+    sockaddr_in primary_{};
+    // Session we were following when we took over, if any
+    bool haveTakeoverSession_{false};
+    uint32_t takeoverSession_{0};
+    bool warnedNewSession_{false};
+    std::vector<uint32_t> appliedSeq_;
+    Universe::Planes planes_;
+    Clock::time_point lastHeard_;
+    Clock::time_point lastResync_;
+    bool warnedUniverseCount_{false};
+
+    std::atomic<uint64_t> packets_{0};
+    std::atomic<uint64_t> universesApplied_{0};
+    std::atomic<uint64_t> lostPackets_{0};
+    std::atomic<uint64_t> resyncRequests_{0};
+    std::atomic<uint64_t> takeovers_{0};
+};
+
+} // namespace photon
@@ -0,0 +1,179 @@
+#include "replication/ReplicationSender.h"
+#include "replication/ReplicationProtocol.h"
+#include "metrics/Metrics.h"
+#include "metrics/Trace.h"
+#include <spdlog/spdlog.h>
+#include <cerrno>
+#include <cstring>
+#include <numeric>
+#include <random>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace photon {
+
+namespace {
+
+metrics::Counter replicationBytes{"photon_replication_sent_bytes_total",
+    "Bytes sent to the hot standby"};
+metrics::Counter replicationResyncs{"photon_replication_resyncs_total",
+    "Full resends requested by the hot standby after a sequence gap"};
+
+#ifndef _WIN32
+bool resolveTarget(const std::string& target, sockaddr_in& out) {
+    auto colon = target.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 == target.size()) return false;
+    auto host = target.substr(0, colon);
+    auto port = target.substr(colon + 1);
+
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* result = nullptr;
+    if (::getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0 || !result) return false;
+    std::memcpy(&out, result->ai_addr, sizeof(out));
+    ::freeaddrinfo(result);
+    return true;
+}
+#endif
+
+} // namespace
+
+ReplicationSender::ReplicationSender(MergeBuffer& mergeBuffer)
+    : mergeBuffer_(mergeBuffer) {}
+
+ReplicationSender::~ReplicationSender() {
+    stop();
+}
+
+#ifdef _WIN32
+
+bool ReplicationSender::start(const std::string& target, double) {
+    spdlog::error("Replication is not supported on this platform ({})", target);
+    return false;
+}
+
+void ReplicationSender::stop() {}
+void ReplicationSender::run() {}
+void ReplicationSender::send(const std::string&) {}
+bool ReplicationSender::pollResyncRequests() { return false; }
+
+#else
+
+bool ReplicationSender::start(const std::string& target, double hz) {
+    if (running_.load()) return false;
+    if (!resolveTarget(target, target_)) {
+        spdlog::error("Replication: cannot resolve standby address '{}' (expected HOST:PORT)", target);
+        return false;
+    }
+    socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket_ < 0) {
+        spdlog::error("Replication: failed to create socket: {}", std::strerror(errno));
+        return false;
+    }
+
+    hz_ = hz > 0 ? hz : 44.0;
+    session_ = std::random_device{}();
+    seq_ = 0;
+    version_ = 0;
+    running_.store(true);
+    thread_ = std::thread([this] { run(); });
+    spdlog::info("Replicating to hot standby at {} ({:.0f} Hz)", target, hz_);
+    return true;
+}
+
+void ReplicationSender::stop() {
+    if (!running_.exchange(false)) return;
+    if (thread_.joinable()) thread_.join();
+    ::close(socket_);
+    socket_ = -1;
+}
+
+void ReplicationSender::send(const std::string& packet) {
+    auto sent = ::sendto(socket_, packet.data(), packet.size(), 0,
+                         reinterpret_cast<const sockaddr*>(&target_), sizeof(target_));
+    if (sent < 0) return;
+    packets_.fetch_add(1, std::memory_order_relaxed);
+    bytes_.fetch_add(packet.size(), std::memory_order_relaxed);
+    replicationBytes.inc(packet.size());
+}
+
+bool ReplicationSender::pollResyncRequests() {
+    bool requested = false;
+    uint8_t buffer[sizeof(replication::PacketHeader)];
+    replication::PacketHeader header{};
+    for (;;) {
+        auto n = ::recv(socket_, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (n <= 0) break;
+        if (replication::decodeHeader(buffer, static_cast<size_t>(n), header) &&
+            header.type == static_cast<uint8_t>(replication::PacketType::ResyncRequest) &&
+            header.session == session_) {
+            requested = true;
+        }
+    }
+    return requested;
+}
+
+void ReplicationSender::run() {
+    trace::setThreadName("replication");
+    using Clock = std::chrono::steady_clock;
+    auto interval = std::chrono::microseconds(static_cast<long>(1'000'000.0 / hz_));
+    auto nextTick = Clock::now();
+    auto lastKeyframe = Clock::time_point{};
+
+    while (running_.load()) {
+        nextTick += interval;
+        {
+            PHOTON_TRACE_SCOPE("replication.tick");
+            auto now = Clock::now();
+            bool resync = pollResyncRequests();
+            if (resync) {
+                resyncRequests_.fetch_add(1, std::memory_order_relaxed);
+                replicationResyncs.inc();
+            }
+            bool keyframe = resync || now - lastKeyframe >= KEYFRAME_INTERVAL;
+            if (keyframe) {
+                lastKeyframe = now;
+                keyframes_.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            // planes_ is always current; a keyframe sends all of it, other
+            // ticks only what was written since the last capture
+            version_ = mergeBuffer_.capturePlanes(planes_, version_, &changed_);
+            if (keyframe) {
+                changed_.resize(planes_.size());
+                std::iota(changed_.begin(), changed_.end(), uint16_t{0});
+            }
+            for (uint16_t u : changed_) {
+                send(replication::encodeUniverse(session_, ++seq_, version_, u, planes_[u]));
+            }
+            universes_.fetch_add(changed_.size(), std::memory_order_relaxed);
+            send(replication::encodeHeartbeat(session_, ++seq_, version_,
+                                              static_cast<uint16_t>(planes_.size())));
+        }
+        std::this_thread::sleep_until(nextTick);
+    }
+}
+
+#endif
+
+bool ReplicationSender::isRunning() const {
+    return running_.load();
+}
+
+ReplicationSender::Stats ReplicationSender::getStats() const {
+    Stats s;
+    s.packets = packets_.load(std::memory_order_relaxed);
+    s.bytes = bytes_.load(std::memory_order_relaxed);
+    s.universes = universes_.load(std::memory_order_relaxed);
+    s.keyframes = keyframes_.load(std::memory_order_relaxed);
+    s.resyncRequests = resyncRequests_.load(std::memory_order_relaxed);
+    return s;
+}
+
+} // namespace photon
@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "engine/MergeBuffer.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netinet/in.h>
+#endif
+
+namespace photon {
+
+// Primary side of hot-standby replication. Every tick it captures the
+// universes written since the previous tick and sends each one's priority
+// planes to the standby, followed by a heartbeat. Every universe is resent
+// once a second, and at once when the standby reports a sequence gap.
+class ReplicationSender {
+public:
+    static constexpr std::chrono::seconds KEYFRAME_INTERVAL{1};
+
+    explicit ReplicationSender(MergeBuffer& mergeBuffer);
+    ~ReplicationSender();
+
+    // `target` is HOST:PORT of the standby
+    bool start(const std::string& target, double hz);
+    void stop();
+    bool isRunning() const;
+
+    struct Stats {
+        uint64_t packets{0};
+        uint64_t bytes{0};
+        uint64_t universes{0};
+        uint64_t keyframes{0};
+        uint64_t resyncRequests{0};
+    };
+    Stats getStats() const;
+
+private:
+    void run();
+    void send(const std::string& packet);
+    bool pollResyncRequests();
+
+    MergeBuffer& mergeBuffer_;
+    int socket_{-1};
+    sockaddr_in target_{};
+    double hz_{44.0};
+    uint32_t session_{0};
+    uint32_t seq_{0};
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+
+    // Replication thread state
+    std::vector<Universe::Planes> planes_;
+    std::vector<uint16_t> changed_;
+    uint64_t version_{0};
+
+    std::atomic<uint64_t> packets_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> universes_{0};
+    std::atomic<uint64_t> keyframes_{0};
+    std::atomic<uint64_t> resyncRequests_{0};
+};
+
+} // namespace photon
@@ -0,0 +1,276 @@
+#include "show/FrameLog.h"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace photon {
+
+using namespace framelog;
+
+namespace {
+constexpr size_t GROW_CHUNK = 16 * 1024 * 1024;
+}
+
+// ── FrameLogWriter ──────────────────────────────────────────────
+
+FrameLogWriter::~FrameLogWriter() {
+    close();
+}
+
+FrameLogHeader* FrameLogWriter::header() const {
+    return reinterpret_cast<FrameLogHeader*>(base_);
+}
+
+#ifdef _WIN32
+
+bool FrameLogWriter::open(const std::string& path, uint16_t, uint32_t) {
+    spdlog::error("Show recording is not supported on this platform ({})", path);
+    return false;
+}
+
+void FrameLogWriter::close() {}
+
+bool FrameLogWriter::append(const uint8_t*, size_t) {
+    return false;
+}
+
+bool FrameLogWriter::ensureCapacity(size_t) {
+    return false;
+}
+
+#else
+
+bool FrameLogWriter::open(const std::string& path, uint16_t universeCount, uint32_t keyframeInterval) {
+    if (isOpen()) return false;
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        spdlog::error("Recorder: cannot create {}: {}", path, std::strerror(errno));
+        return false;
+    }
+
+    dataEnd_ = sizeof(FrameLogHeader);
+    lastTimestampUs_ = 0;
+    index_.clear();
+    if (!ensureCapacity(0)) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    auto* h = header();
+    std::memcpy(h->magic, MAGIC, sizeof(MAGIC));
+    h->version = VERSION;
+    h->headerSize = sizeof(FrameLogHeader);
+    h->universeCount = universeCount;
+    h->keyframeInterval = keyframeInterval;
+    h->dataEnd = dataEnd_;
+    return true;
+}
+
+bool FrameLogWriter::ensureCapacity(size_t needed) {
+    if (base_ && dataEnd_ + needed <= mappedSize_) return true;
+
+    size_t newSize = std::max(mappedSize_ + GROW_CHUNK, dataEnd_ + needed + GROW_CHUNK);
+    if (::ftruncate(fd_, static_cast<off_t>(newSize)) != 0) {
+        spdlog::error("Recorder: cannot grow file: {}", std::strerror(errno));
+        return false;
+    }
+
+    if (base_) ::munmap(base_, mappedSize_);
+    void* p = ::mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (p == MAP_FAILED) {
+        spdlog::error("Recorder: mmap failed: {}", std::strerror(errno));
+        base_ = nullptr;
+        mappedSize_ = 0;
+        return false;
+    }
+    base_ = static_cast<uint8_t*>(p);
+    mappedSize_ = newSize;
+    return true;
+}
+
+bool FrameLogWriter::append(const uint8_t* record, size_t size) {
+    if (!isOpen() || size < sizeof(TickHeader)) return false;
+    if (!ensureCapacity(size)) return false;
+
+    auto* tick = reinterpret_cast<const TickHeader*>(record);
+    if (tick->flags & FLAG_KEYFRAME) {
+        index_.push_back({tick->timestampUs, dataEnd_});
+    }
+    lastTimestampUs_ = tick->timestampUs;
+
+    std::memcpy(base_ + dataEnd_, record, size);
+    dataEnd_ += size;
+
+    auto* h = header();
+    h->dataEnd = dataEnd_;
+    h->durationUs = lastTimestampUs_;
+    return true;
+}
+
+void FrameLogWriter::close() {
+    if (!isOpen()) return;
+
+    size_t indexBytes = index_.size() * sizeof(IndexEntry);
+    size_t indexOffset = dataEnd_;
+    if (ensureCapacity(indexBytes)) {
+        std::memcpy(base_ + indexOffset, index_.data(), indexBytes);
+        auto* h = header();
+        h->indexOffset = indexOffset;
+        h->indexCount = index_.size();
+    }
+
+    ::msync(base_, mappedSize_, MS_SYNC);
+    ::munmap(base_, mappedSize_);
+    if (::ftruncate(fd_, static_cast<off_t>(indexOffset + indexBytes)) != 0) {
+        spdlog::warn("Recorder: could not trim recording: {}", std::strerror(errno));
+    }
+    ::close(fd_);
+
+    base_ = nullptr;
+    mappedSize_ = 0;
+    fd_ = -1;
+    index_.clear();
+}
+
+#endif
+
+// ── FrameLogReader ──────────────────────────────────────────────
+
+FrameLogReader::~FrameLogReader() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool FrameLogReader::open(const std::string& path) {
+    spdlog::error("Show playback is not supported on this platform ({})", path);
+    return false;
+}
+
+void FrameLogReader::close() {}
+
+#else
+
+bool FrameLogReader::open(const std::string& path) {
+    if (isOpen()) close();
+
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        spdlog::error("Playback: cannot open {}: {}", path, std::strerror(errno));
+        return false;
+    }
+
+    struct stat st{};
+    if (::fstat(fd_, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(FrameLogHeader)) {
+        spdlog::error("Playback: {} is not a show recording", path);
+        close();
+        return false;
+    }
+
+    mappedSize_ = static_cast<size_t>(st.st_size);
+    void* p = ::mmap(nullptr, mappedSize_, PROT_READ, MAP_SHARED, fd_, 0);
+    if (p == MAP_FAILED) {
+        spdlog::error("Playback: mmap failed: {}", std::strerror(errno));
+        mappedSize_ = 0;
+        close();
+        return false;
+    }
+    base_ = static_cast<const uint8_t*>(p);
+    ::madvise(p, mappedSize_, MADV_SEQUENTIAL);
+
+    auto* h = reinterpret_cast<const FrameLogHeader*>(base_);
+    if (std::memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0 || h->version != VERSION) {
+        spdlog::error("Playback: {} has an unsupported format", path);
+        close();
+        return false;
+    }
+
+    universeCount_ = h->universeCount;
+    durationUs_ = h->durationUs;
+    dataStart_ = h->headerSize;
+    dataEnd_ = std::min<size_t>(h->dataEnd, mappedSize_);
+
+    // Checked without adding to indexOffset, so a corrupt count can't wrap
+    if (h->indexOffset != 0 && h->indexOffset <= mappedSize_ &&
+        h->indexCount <= (mappedSize_ - h->indexOffset) / sizeof(IndexEntry)) {
+        index_ = reinterpret_cast<const IndexEntry*>(base_ + h->indexOffset);
+        indexCount_ = h->indexCount;
+    } else {
+        // Recording was not closed cleanly — rebuild the index by scanning
+        spdlog::warn("Playback: {} has no index, scanning", path);
+        buildIndex();
+    }
+
+    spdlog::info("Playback: opened {} ({} universes, {:.1f} s, {} keyframes)",
+                 path, universeCount_, durationUs_ / 1e6, indexCount_);
+    return true;
+}
+
+void FrameLogReader::close() {
+    if (base_) ::munmap(const_cast<uint8_t*>(base_), mappedSize_);
+    if (fd_ >= 0) ::close(fd_);
+    base_ = nullptr;
+    mappedSize_ = 0;
+    fd_ = -1;
+    index_ = nullptr;
+    indexCount_ = 0;
+    scannedIndex_.clear();
+}
+
+#endif
+
+void FrameLogReader::buildIndex() {
+    scannedIndex_.clear();
+    for (size_t off = firstTick(); auto* tick = tickAt(off); off = nextTick(off)) {
+        if (tick->flags & FLAG_KEYFRAME) scannedIndex_.push_back({tick->timestampUs, off});
+        durationUs_ = tick->timestampUs;
+    }
+    index_ = scannedIndex_.data();
+    indexCount_ = scannedIndex_.size();
+}
+
+size_t FrameLogReader::firstTick() const {
+    return dataStart_;
+}
+
+size_t FrameLogReader::seekKeyframe(uint64_t timestampUs) const {
+    auto* end = index_ + indexCount_;
+    auto* it = std::upper_bound(index_, end, timestampUs,
+                                [](uint64_t t, const IndexEntry& e) { return t < e.timestampUs; });
+    if (it == index_) return firstTick();
+    return static_cast<size_t>((it - 1)->offset);
+}
+
+const TickHeader* FrameLogReader::tickAt(size_t offset) const {
+    if (!base_ || offset + sizeof(TickHeader) > dataEnd_) return nullptr;
+    auto* tick = reinterpret_cast<const TickHeader*>(base_ + offset);
+    if (tick->magic != TICK_MAGIC || tick->size < sizeof(TickHeader) ||
+        offset + tick->size > dataEnd_) {
+        return nullptr;
+    }
+    return tick;
+}
+
+size_t FrameLogReader::nextTick(size_t offset) const {
+    auto* tick = tickAt(offset);
+    return tick ? offset + tick->size : dataEnd_;
+}
+
+void FrameLogReader::applyTick(const TickHeader* tick,
+                               std::vector<std::array<uint8_t, 512>>& frames) const {
+    forEachRun(tick, [&](uint16_t universe, const Run& run) {
+        if (universe >= frames.size()) return;
+        std::memcpy(frames[universe].data() + run.start, run.data, run.length);
+    });
+}
+
+} // namespace photon
@@ -0,0 +1,184 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace photon {
+
+// On-disk layout of a show recording (host byte order):
+//
+//   FrameLogHeader
+//   tick record*      TickHeader followed by `universeCount` universe records,
+//                     each a UniverseHeader followed by `runCount` runs
+//                     (RunHeader + `length` channel bytes, padded to even)
+//   IndexEntry*       one per keyframe tick, written when the log is closed
+//
+// Delta ticks carry only the channel runs that changed since the previous
+// tick; keyframe ticks carry every universe in full so playback can start
+// from any indexed position.
+namespace framelog {
+
+inline constexpr char MAGIC[8] = {'P', 'H', 'O', 'T', 'R', 'E', 'C', '1'};
+inline constexpr uint32_t VERSION = 1;
+inline constexpr uint32_t TICK_MAGIC = 0x4B434954; // "TICK"
+inline constexpr uint8_t FLAG_KEYFRAME = 0x01;
+
+struct FrameLogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint16_t universeCount;
+    uint16_t reserved;
+    uint32_t keyframeInterval;
+    uint64_t dataEnd;      // offset one past the last committed tick record
+    uint64_t indexOffset;  // 0 until the log is closed cleanly
+    uint64_t indexCount;
+    uint64_t durationUs;
+};
+
+struct TickHeader {
+    uint32_t magic;
+    uint32_t size;         // whole record including this header
+    uint64_t timestampUs;  // relative to the start of the recording
+    uint16_t universeCount;
+    uint8_t flags;
+    uint8_t reserved;
+    uint32_t padding;
+};
+
+struct UniverseHeader {
+    uint16_t universe;
+    uint16_t runCount;
+};
+
+struct RunHeader {
+    uint16_t start;
+    uint16_t length;
+};
+
+// Run payloads are padded to keep the following headers 2-byte aligned, and
+// tick records are padded to 8 bytes.
+inline constexpr size_t paddedRunLength(size_t length) { return (length + 1) & ~size_t{1}; }
+inline constexpr size_t paddedTickSize(size_t size) { return (size + 7) & ~size_t{7}; }
+
+struct IndexEntry {
+    uint64_t timestampUs;
+    uint64_t offset;
+};
+
+} // namespace framelog
+
+// Appends encoded tick records to an mmap-backed file. The mapping grows in
+// large chunks so appends are plain memcpy; the header's dataEnd is advanced
+// after every record so a crash leaves a readable prefix.
+class FrameLogWriter {
+public:
+    FrameLogWriter() = default;
+    ~FrameLogWriter();
+
+    FrameLogWriter(const FrameLogWriter&) = delete;
+    FrameLogWriter& operator=(const FrameLogWriter&) = delete;
+
+    bool open(const std::string& path, uint16_t universeCount, uint32_t keyframeInterval);
+    void close();
+    bool isOpen() const { return base_ != nullptr; }
+
+    // `record` must be a complete tick record starting with a TickHeader.
+    bool append(const uint8_t* record, size_t size);
+
+    uint64_t bytesWritten() const { return dataEnd_; }
+
+private:
+    bool ensureCapacity(size_t needed);
+    framelog::FrameLogHeader* header() const;
+
+    int fd_{-1};
+    uint8_t* base_{nullptr};
+    size_t mappedSize_{0};
+    size_t dataEnd_{0};
+    uint64_t lastTimestampUs_{0};
+    std::vector<framelog::IndexEntry> index_;
+};
+
+// Read-only view of a recording. Nothing is copied out of the mapping: tick
+// and run accessors return pointers into it, and the kernel pages data in on
+// demand.
+class FrameLogReader {
+public:
+    struct Run {
+        uint16_t start;
+        uint16_t length;
+        const uint8_t* data;
+    };
+
+    FrameLogReader() = default;
+    ~FrameLogReader();
+
+    FrameLogReader(const FrameLogReader&) = delete;
+    FrameLogReader& operator=(const FrameLogReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return base_ != nullptr; }
+
+    uint16_t getUniverseCount() const { return universeCount_; }
+    uint64_t getDurationUs() const { return durationUs_; }
+    size_t getKeyframeCount() const { return indexCount_; }
+
+    // Offset of the first tick record, or of the latest keyframe at or
+    // before `timestampUs`.
+    size_t firstTick() const;
+    size_t seekKeyframe(uint64_t timestampUs) const;
+
+    // Returns nullptr once `offset` reaches the end of the data.
+    const framelog::TickHeader* tickAt(size_t offset) const;
+    size_t nextTick(size_t offset) const;
+
+    // Calls fn(universe, run) for every run in the tick.
+    template <typename Fn>
+    void forEachRun(const framelog::TickHeader* tick, Fn&& fn) const;
+
+    // Applies one tick to a set of reconstructed frames.
+    void applyTick(const framelog::TickHeader* tick,
+                   std::vector<std::array<uint8_t, 512>>& frames) const;
+
+private:
+    void buildIndex();
+
+    int fd_{-1};
+    const uint8_t* base_{nullptr};
+    size_t mappedSize_{0};
+    size_t dataStart_{0};
+    size_t dataEnd_{0};
+    uint16_t universeCount_{0};
+    uint64_t durationUs_{0};
+
+    const framelog::IndexEntry* index_{nullptr};
+    size_t indexCount_{0};
+    std::vector<framelog::IndexEntry> scannedIndex_;
+};
+
+template <typename Fn>
+void FrameLogReader::forEachRun(const framelog::TickHeader* tick, Fn&& fn) const {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(tick) + sizeof(framelog::TickHeader);
+    const uint8_t* end = reinterpret_cast<const uint8_t*>(tick) + tick->size;
+
+    for (uint16_t i = 0; i < tick->universeCount; ++i) {
+        if (p + sizeof(framelog::UniverseHeader) > end) return;
+        auto* uh = reinterpret_cast<const framelog::UniverseHeader*>(p);
+        p += sizeof(framelog::UniverseHeader);
+
+        for (uint16_t r = 0; r < uh->runCount; ++r) {
+            if (p + sizeof(framelog::RunHeader) > end) return;
+            auto* rh = reinterpret_cast<const framelog::RunHeader*>(p);
+            p += sizeof(framelog::RunHeader);
+            if (p + rh->length > end || rh->start + rh->length > 512) return;
+            fn(uh->universe, Run{rh->start, rh->length, p});
+            p += framelog::paddedRunLength(rh->length);
+        }
+    }
+}
+
+} // namespace photon
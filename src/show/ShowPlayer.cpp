@@ -0,0 +1,131 @@
+#include "show/ShowPlayer.h"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <chrono>
+
+namespace photon {
+
+using namespace framelog;
+
+ShowPlayer::ShowPlayer(MergeBuffer& mergeBuffer, SourcePriority priority, Clock& clock)
+    : mergeBuffer_(mergeBuffer), priority_(priority), clock_(clock) {}
+
+ShowPlayer::~ShowPlayer() {
+    stop();
+}
+
+bool ShowPlayer::open(const std::string& path) {
+    stop();
+    if (!reader_.open(path)) return false;
+    startOffset_ = reader_.firstTick();
+    positionUs_.store(0);
+    if (reader_.getUniverseCount() != mergeBuffer_.getUniverseCount()) {
+        spdlog::warn("Playback: recording has {} universes, engine has {}",
+                     reader_.getUniverseCount(), mergeBuffer_.getUniverseCount());
+    }
+    return true;
+}
+
+void ShowPlayer::close() {
+    stop();
+    reader_.close();
+}
+
+void ShowPlayer::start(bool loop) {
+    if (!reader_.isOpen()) return;
+    if (running_.exchange(true)) return;
+    if (thread_.joinable()) thread_.join();
+    thread_ = std::thread([this, loop] { run(loop); });
+    spdlog::info("Playback started{}", loop ? " (looping)" : "");
+}
+
+void ShowPlayer::stop() {
+    running_.store(false);
+    clock_.wake();
+    if (thread_.joinable()) {
+        thread_.join();
+        for (uint16_t u = 0; u < mergeBuffer_.getUniverseCount(); ++u) {
+            mergeBuffer_.clearPriority(u, priority_);
+        }
+        spdlog::info("Playback stopped");
+    }
+}
+
+bool ShowPlayer::isPlaying() const {
+    return running_.load();
+}
+
+uint64_t ShowPlayer::getPositionUs() const {
+    return positionUs_.load();
+}
+
+uint64_t ShowPlayer::getDurationUs() const {
+    return reader_.getDurationUs();
+}
+
+void ShowPlayer::seek(uint64_t timestampUs) {
+    if (running_.load() || !reader_.isOpen()) return;
+
+    // Rebuild the frames from the nearest keyframe, then write them all at once
+    std::vector<std::array<uint8_t, 512>> frames(reader_.getUniverseCount());
+    size_t off = reader_.seekKeyframe(timestampUs);
+    for (auto* tick = reader_.tickAt(off); tick && tick->timestampUs <= timestampUs;
+         tick = reader_.tickAt(off)) {
+        reader_.applyTick(tick, frames);
+        off = reader_.nextTick(off);
+    }
+
+    uint16_t count = std::min<uint16_t>(static_cast<uint16_t>(frames.size()),
+                                        mergeBuffer_.getUniverseCount());
+    runs_.clear();
+    for (uint16_t u = 0; u < count; ++u) {
+        runs_.push_back(ChannelRun{u, 0, 512, frames[u].data(), priority_});
+    }
+    mergeBuffer_.setRuns(runs_.data(), runs_.size());
+
+    startOffset_ = off;
+    positionUs_.store(timestampUs);
+}
+
+void ShowPlayer::applyTick(const TickHeader* tick) {
+    runs_.clear();
+    reader_.forEachRun(tick, [this](uint16_t universe, const FrameLogReader::Run& run) {
+        runs_.push_back(ChannelRun{universe, run.start, run.length, run.data, priority_});
+    });
+    mergeBuffer_.setRuns(runs_.data(), runs_.size());
+}
+
+void ShowPlayer::run(bool loop) {
+    // Sleeps are capped so a long gap in the recording never holds up stop()
+    constexpr auto POLL = std::chrono::milliseconds(50);
+
+    size_t off = startOffset_;
+    auto startTime = clock_.now() - std::chrono::microseconds(positionUs_.load());
+
+    while (running_.load()) {
+        auto* tick = reader_.tickAt(off);
+        if (!tick) {
+            if (!loop) break;
+            off = reader_.firstTick();
+            startTime = clock_.now();
+            continue;
+        }
+
+        auto due = startTime + std::chrono::microseconds(tick->timestampUs);
+        while (running_.load() && clock_.now() < due) {
+            clock_.sleepUntil(std::min(due, clock_.now() + POLL), running_);
+        }
+        if (!running_.load()) break;
+
+        applyTick(tick);
+        positionUs_.store(tick->timestampUs, std::memory_order_relaxed);
+        off = reader_.nextTick(off);
+    }
+
+    startOffset_ = reader_.tickAt(off) ? off : reader_.firstTick();
+    running_.store(false);
+    // Lets a simulated clock's step finish without this thread
+    clock_.sleepUntil(clock_.now(), running_);
+}
+
+} // namespace photon
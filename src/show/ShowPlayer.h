@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "engine/Clock.h"
+#include "engine/InputCoalescer.h"
+#include "engine/MergeBuffer.h"
+#include "engine/SourcePriority.h"
+#include "show/FrameLog.h"
+
+namespace photon {
+
+// Streams a FrameLog back into one MergeBuffer priority plane at the recorded
+// timing. Channel runs are written straight from the read-only mapping, one
+// MergeBuffer write per tick so a recorded tick never spans two output frames.
+class ShowPlayer {
+public:
+    explicit ShowPlayer(MergeBuffer& mergeBuffer,
+                        SourcePriority priority = SourcePriority::CuePlayback,
+                        Clock& clock = Clock::system());
+    ~ShowPlayer();
+
+    bool open(const std::string& path);
+    void close();
+
+    void start(bool loop = false);
+    void stop();
+    bool isPlaying() const;
+
+    // Applies the recorded state at `timestampUs` and resumes playback from
+    // there on the next start(). Only valid while stopped.
+    void seek(uint64_t timestampUs);
+
+    uint64_t getPositionUs() const;
+    uint64_t getDurationUs() const;
+
+private:
+    void run(bool loop);
+    void applyTick(const framelog::TickHeader* tick);
+
+    MergeBuffer& mergeBuffer_;
+    SourcePriority priority_;
+    Clock& clock_;
+    FrameLogReader reader_;
+    std::vector<ChannelRun> runs_; // reused by applyTick()
+
+    size_t startOffset_{0};
+    std::atomic<uint64_t> positionUs_{0};
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+};
+
+} // namespace photon
@@ -0,0 +1,216 @@
+#include "show/ShowRecorder.h"
+#include <spdlog/spdlog.h>
+#include <cstring>
+
+namespace photon {
+
+using namespace framelog;
+
+namespace {
+
+// Unchanged gaps shorter than a run header are cheaper to store than to split
+constexpr size_t RUN_MERGE_GAP = sizeof(RunHeader);
+
+template <typename T>
+void appendPod(std::vector<uint8_t>& out, const T& value) {
+    auto* p = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+} // namespace
+
+ShowRecorder::~ShowRecorder() {
+    stop();
+}
+
+bool ShowRecorder::start(const std::string& path, uint16_t universeCount, uint32_t keyframeInterval) {
+    if (recording_.load()) return false;
+    if (!writer_.open(path, universeCount, keyframeInterval)) return false;
+
+    previous_.assign(universeCount, std::array<uint8_t, 512>{});
+    encoded_.clear();
+    encoded_.reserve(universeCount * (512 + 64) + sizeof(TickHeader));
+    keyframeInterval_ = keyframeInterval > 0 ? keyframeInterval : DEFAULT_KEYFRAME_INTERVAL;
+    ticksSinceKeyframe_ = 0;
+    firstTick_ = true;
+    keyframeDue_ = true;
+    tickCount_.store(0);
+    bytesWritten_.store(0);
+    droppedTicks_.store(0);
+
+    // The writer swaps this with its own batch, so reserve both: the output
+    // thread then never allocates
+    pendingLimit_ = MAX_PENDING_TICKS * encoded_.capacity();
+    pending_.clear();
+    pending_.reserve(pendingLimit_);
+
+    recording_.store(true);
+    writerThread_ = std::thread([this] { writerLoop(); });
+    spdlog::info("Recording show to {}", path);
+    return true;
+}
+
+void ShowRecorder::stop() {
+    if (!recording_.exchange(false)) return;
+
+    pendingCv_.notify_all();
+    if (writerThread_.joinable()) writerThread_.join();
+    writer_.close();
+    spdlog::info("Recording stopped ({} ticks, {} bytes)", tickCount_.load(), bytesWritten_.load());
+    if (auto dropped = droppedTicks_.load()) {
+        spdlog::warn("Recorder: {} ticks dropped while the writer fell behind", dropped);
+    }
+}
+
+bool ShowRecorder::isRecording() const {
+    return recording_.load();
+}
+
+uint64_t ShowRecorder::getTickCount() const {
+    return tickCount_.load();
+}
+
+uint64_t ShowRecorder::getBytesWritten() const {
+    return bytesWritten_.load();
+}
+
+uint64_t ShowRecorder::getDroppedTicks() const {
+    return droppedTicks_.load();
+}
+
+void ShowRecorder::onOutputFrame(std::chrono::steady_clock::time_point tick,
+                                 const std::vector<std::array<uint8_t, 512>>& frames) {
+    if (!recording_.load()) return;
+
+    if (firstTick_) {
+        startTime_ = tick;
+        firstTick_ = false;
+    }
+    if (previous_.size() < frames.size()) previous_.resize(frames.size());
+
+    auto timestampUs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(tick - startTime_).count());
+    bool keyframe = keyframeDue_ || ticksSinceKeyframe_ == 0;
+
+    encoded_.clear();
+    if (!encodeTick(timestampUs, keyframe, frames, previous_, encoded_)) {
+        ticksSinceKeyframe_ = (ticksSinceKeyframe_ + 1) % keyframeInterval_;
+        return;
+    }
+
+    {
+        std::lock_guard lock(pendingMutex_);
+        if (pending_.size() + encoded_.size() > pendingLimit_) {
+            // The writer is stalled; a delta against a dropped tick would be
+            // wrong, so playback resumes from a keyframe
+            droppedTicks_.fetch_add(1, std::memory_order_relaxed);
+            keyframeDue_ = true;
+            return;
+        }
+        pending_.insert(pending_.end(), encoded_.begin(), encoded_.end());
+    }
+    pendingCv_.notify_one();
+
+    keyframeDue_ = false;
+    ticksSinceKeyframe_ = keyframe ? 1 % keyframeInterval_ : (ticksSinceKeyframe_ + 1) % keyframeInterval_;
+    for (size_t u = 0; u < frames.size(); ++u) previous_[u] = frames[u];
+    tickCount_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool ShowRecorder::encodeTick(uint64_t timestampUs, bool keyframe,
+                              const std::vector<std::array<uint8_t, 512>>& frames,
+                              const std::vector<std::array<uint8_t, 512>>& previous,
+                              std::vector<uint8_t>& out) {
+    size_t tickStart = out.size();
+    out.resize(tickStart + sizeof(TickHeader));
+    uint16_t universeCount = 0;
+
+    for (size_t u = 0; u < frames.size(); ++u) {
+        const auto& cur = frames[u];
+        const auto* prev = u < previous.size() ? previous[u].data() : nullptr;
+
+        if (keyframe || !prev) {
+            appendPod(out, UniverseHeader{static_cast<uint16_t>(u), 1});
+            appendPod(out, RunHeader{0, 512});
+            out.insert(out.end(), cur.begin(), cur.end());
+            ++universeCount;
+            continue;
+        }
+
+        if (std::memcmp(cur.data(), prev, 512) == 0) continue;
+
+        size_t universeStart = out.size();
+        out.resize(universeStart + sizeof(UniverseHeader));
+        uint16_t runCount = 0;
+
+        size_t i = 0;
+        while (i < 512) {
+            if (cur[i] == prev[i]) { ++i; continue; }
+
+            size_t start = i;
+            size_t last = i;
+            for (size_t j = i + 1; j < 512 && j - last <= RUN_MERGE_GAP; ++j) {
+                if (cur[j] != prev[j]) last = j;
+            }
+
+            size_t length = last - start + 1;
+            appendPod(out, RunHeader{static_cast<uint16_t>(start), static_cast<uint16_t>(length)});
+            out.insert(out.end(), cur.begin() + start, cur.begin() + last + 1);
+            if (length & 1) out.push_back(0);
+            ++runCount;
+            i = last + 1;
+        }
+
+        UniverseHeader uh{static_cast<uint16_t>(u), runCount};
+        std::memcpy(out.data() + universeStart, &uh, sizeof(uh));
+        ++universeCount;
+    }
+
+    if (universeCount == 0) {
+        out.resize(tickStart);
+        return false;
+    }
+
+    out.resize(tickStart + paddedTickSize(out.size() - tickStart), 0);
+
+    TickHeader th{};
+    th.magic = TICK_MAGIC;
+    th.size = static_cast<uint32_t>(out.size() - tickStart);
+    th.timestampUs = timestampUs;
+    th.universeCount = universeCount;
+    th.flags = keyframe ? FLAG_KEYFRAME : 0;
+    std::memcpy(out.data() + tickStart, &th, sizeof(th));
+    return true;
+}
+
+void ShowRecorder::writerLoop() {
+    std::vector<uint8_t> batch;
+    batch.reserve(pendingLimit_);
+
+    while (true) {
+        {
+            std::unique_lock lock(pendingMutex_);
+            pendingCv_.wait(lock, [this] { return !pending_.empty() || !recording_.load(); });
+            batch.swap(pending_);
+        }
+
+        size_t off = 0;
+        while (off + sizeof(TickHeader) <= batch.size()) {
+            auto* tick = reinterpret_cast<const TickHeader*>(batch.data() + off);
+            if (!writer_.append(batch.data() + off, tick->size)) {
+                spdlog::error("Recorder: write failed, dropping {} bytes", batch.size() - off);
+                break;
+            }
+            off += tick->size;
+        }
+        bytesWritten_.store(writer_.bytesWritten(), std::memory_order_relaxed);
+        batch.clear();
+
+        if (!recording_.load()) {
+            std::lock_guard lock(pendingMutex_);
+            if (pending_.empty()) break;
+        }
+    }
+}
+
+} // namespace photon
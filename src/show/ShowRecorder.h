@@ -0,0 +1,76 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "engine/FrameObserver.h"
+#include "show/FrameLog.h"
+
+namespace photon {
+
+// Records the output of every OutputScheduler tick to a FrameLog. Delta
+// encoding happens on the output thread (a compare and a few memcpys per
+// universe); file writes happen on a separate writer thread so the output
+// thread never touches the page cache. The hand-off buffer is allocated up
+// front for MAX_PENDING_TICKS full ticks: while the writer is stalled further
+// ticks are dropped and counted, and the first one that fits is a keyframe.
+class ShowRecorder : public FrameObserver {
+public:
+    static constexpr uint32_t DEFAULT_KEYFRAME_INTERVAL = 88; // ~2 s at 44 Hz
+    static constexpr uint32_t MAX_PENDING_TICKS = 88;
+
+    ShowRecorder() = default;
+    ~ShowRecorder() override;
+
+    bool start(const std::string& path, uint16_t universeCount,
+               uint32_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
+    void stop();
+    bool isRecording() const;
+
+    uint64_t getTickCount() const;
+    uint64_t getBytesWritten() const;
+    uint64_t getDroppedTicks() const;
+
+    // FrameObserver interface
+    void onOutputFrame(std::chrono::steady_clock::time_point tick,
+                       const std::vector<std::array<uint8_t, 512>>& frames) override;
+
+    // Appends the tick record for `frames` (relative to `previous`) to `out`.
+    // Returns false without writing anything if nothing changed.
+    static bool encodeTick(uint64_t timestampUs, bool keyframe,
+                           const std::vector<std::array<uint8_t, 512>>& frames,
+                           const std::vector<std::array<uint8_t, 512>>& previous,
+                           std::vector<uint8_t>& out);
+
+private:
+    void writerLoop();
+
+    FrameLogWriter writer_;
+    std::atomic<bool> recording_{false};
+    std::atomic<uint64_t> tickCount_{0};
+    std::atomic<uint64_t> bytesWritten_{0};
+    std::atomic<uint64_t> droppedTicks_{0};
+
+    // Output thread state
+    std::vector<std::array<uint8_t, 512>> previous_;
+    std::vector<uint8_t> encoded_;
+    std::chrono::steady_clock::time_point startTime_{};
+    uint32_t keyframeInterval_{DEFAULT_KEYFRAME_INTERVAL};
+    uint32_t ticksSinceKeyframe_{0};
+    bool firstTick_{true};
+    bool keyframeDue_{true};
+
+    // Hand-off to the writer thread
+    std::mutex pendingMutex_;
+    std::condition_variable pendingCv_;
+    std::vector<uint8_t> pending_;
+    size_t pendingLimit_{0};
+    std::thread writerThread_;
+};
+
+} // namespace photon
@@ -0,0 +1,333 @@
+#include "show/ShowSnapshot.h"
+#include "engine/PlaneCodec.h"
+#include "metrics/Metrics.h"
+#include "metrics/Trace.h"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace photon {
+
+using namespace showsnap;
+
+namespace {
+
+metrics::Counter snapshotSaves{"photon_snapshot_saves_total",
+    "Show snapshots written to disk"};
+metrics::Histogram snapshotSaveSeconds{"photon_snapshot_save_seconds",
+    "Time to capture, encode and durably write one show snapshot",
+    {0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0}};
+
+std::array<uint32_t, 256> makeCrcTable() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        table[i] = c;
+    }
+    return table;
+}
+
+template <typename T>
+void appendPod(std::vector<uint8_t>& out, const T& value) {
+    auto* p = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+} // namespace
+
+uint32_t showsnap::crc32(const uint8_t* data, size_t size) {
+    static const auto table = makeCrcTable();
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) c = table[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+ShowSnapshot::ShowSnapshot(MergeBuffer& mergeBuffer)
+    : mergeBuffer_(mergeBuffer) {}
+
+ShowSnapshot::~ShowSnapshot() {
+    stop();
+}
+
+bool ShowSnapshot::start(const std::string& path, std::chrono::milliseconds interval) {
+    if (running_.load()) return false;
+    path_ = path;
+    interval_ = interval;
+    running_.store(true);
+    thread_ = std::thread([this] { run(); });
+    if (interval.count() > 0) {
+        spdlog::info("Saving show snapshots to {} every {:.1f} s", path, interval.count() / 1000.0);
+    } else {
+        spdlog::info("Saving show snapshots to {} on request and at shutdown", path);
+    }
+    return true;
+}
+
+void ShowSnapshot::stop() {
+    {
+        std::lock_guard lock(wakeMutex_);
+        if (!running_.exchange(false)) return;
+    }
+    wakeCv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+    save(false);
+}
+
+bool ShowSnapshot::isRunning() const {
+    return running_.load();
+}
+
+bool ShowSnapshot::saveNow() {
+    return save(true);
+}
+
+ShowSnapshot::Stats ShowSnapshot::getStats() const {
+    std::lock_guard lock(saveMutex_);
+    return stats_;
+}
+
+void ShowSnapshot::run() {
+    trace::setThreadName("snapshot");
+    while (running_.load()) {
+        {
+            std::unique_lock lock(wakeMutex_);
+            auto stopping = [this] { return !running_.load(); };
+            if (interval_.count() > 0) wakeCv_.wait_for(lock, interval_, stopping);
+            else wakeCv_.wait(lock, stopping);
+        }
+        if (!running_.load()) break;
+        save(false);
+    }
+}
+
+bool ShowSnapshot::save(bool force) {
+    PHOTON_TRACE_SCOPE("snapshot.save");
+    std::lock_guard lock(saveMutex_);
+    if (path_.empty()) {
+        spdlog::warn("Snapshot: no snapshot file configured");
+        return false;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    capturedVersion_ = mergeBuffer_.capturePlanes(planes_, capturedVersion_);
+    if (!force && saved_ && capturedVersion_ == stats_.mergeVersion) return true;
+
+    auto savedAtUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    encode(planes_, capturedVersion_, savedAtUs, encoded_);
+    if (!writeFile(encoded_)) return false;
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    saved_ = true;
+    ++stats_.saves;
+    stats_.bytes = encoded_.size();
+    stats_.mergeVersion = capturedVersion_;
+    stats_.lastSaveSeconds = seconds;
+    snapshotSaves.inc();
+    snapshotSaveSeconds.observe(seconds);
+    spdlog::debug("Snapshot: wrote {} bytes in {:.1f} ms", encoded_.size(), seconds * 1000.0);
+    return true;
+}
+
+void ShowSnapshot::encode(const std::vector<Universe::Planes>& planes, uint64_t mergeVersion,
+                          uint64_t savedAtUs, std::vector<uint8_t>& out) {
+    out.clear();
+    out.resize(sizeof(SnapshotHeader));
+
+    uint16_t records = 0;
+    for (size_t u = 0; u < planes.size(); ++u) {
+        UniverseRecord record{static_cast<uint16_t>(u), planecodec::planeMask(planes[u]), 0};
+        if (record.planeMask == 0) continue;
+
+        appendPod(out, record);
+        size_t at = out.size();
+        out.resize(at + planecodec::encodedSize(record.planeMask));
+        planecodec::encode(planes[u], record.planeMask, out.data() + at);
+        ++records;
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.headerSize = sizeof(SnapshotHeader);
+    header.universeCount = static_cast<uint16_t>(planes.size());
+    header.recordCount = records;
+    header.priorityCount = static_cast<uint8_t>(Universe::NUM_PRIORITIES);
+    header.mergeVersion = mergeVersion;
+    header.savedAtUs = savedAtUs;
+    header.payloadSize = out.size() - sizeof(SnapshotHeader);
+    header.checksum = crc32(out.data() + sizeof(SnapshotHeader), header.payloadSize);
+    std::memcpy(out.data(), &header, sizeof(header));
+}
+
+bool ShowSnapshot::decode(const uint8_t* data, size_t size, std::vector<Universe::Planes>& planes,
+                          std::string& error) {
+    SnapshotHeader header{};
+    if (size < sizeof(header)) {
+        error = "file is too short";
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.headerSize < sizeof(header) || header.headerSize > size) {
+        error = "not a show snapshot";
+        return false;
+    }
+    if (header.payloadSize != size - header.headerSize) {
+        error = "truncated";
+        return false;
+    }
+    const uint8_t* p = data + header.headerSize;
+    const uint8_t* end = p + header.payloadSize;
+    if (crc32(p, header.payloadSize) != header.checksum) {
+        error = "checksum mismatch";
+        return false;
+    }
+
+    planes.assign(header.universeCount, Universe::Planes{});
+    for (uint16_t r = 0; r < header.recordCount; ++r) {
+        UniverseRecord record{};
+        if (static_cast<size_t>(end - p) < sizeof(record)) {
+            error = "truncated";
+            return false;
+        }
+        std::memcpy(&record, p, sizeof(record));
+        p += sizeof(record);
+        if (record.universe >= header.universeCount) {
+            error = "universe out of range";
+            return false;
+        }
+        p = planecodec::decode(p, end, record.planeMask, planes[record.universe]);
+        if (!p) {
+            error = "truncated";
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef _WIN32
+
+bool ShowSnapshot::writeFile(const std::vector<uint8_t>&) {
+    spdlog::error("Show snapshots are not supported on this platform ({})", path_);
+    return false;
+}
+
+bool ShowSnapshot::restore(const std::string& path, MergeBuffer&) {
+    spdlog::error("Show snapshots are not supported on this platform ({})", path);
+    return false;
+}
+
+#else
+
+bool ShowSnapshot::writeFile(const std::vector<uint8_t>& data) {
+    std::string tmpPath = path_ + ".tmp";
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        spdlog::error("Snapshot: cannot create {}: {}", tmpPath, std::strerror(errno));
+        return false;
+    }
+
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            spdlog::error("Snapshot: write to {} failed: {}", tmpPath, std::strerror(errno));
+            ::close(fd);
+            ::unlink(tmpPath.c_str());
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    if (::fsync(fd) != 0) {
+        spdlog::error("Snapshot: fsync of {} failed: {}", tmpPath, std::strerror(errno));
+        ::close(fd);
+        ::unlink(tmpPath.c_str());
+        return false;
+    }
+    ::close(fd);
+
+    if (::rename(tmpPath.c_str(), path_.c_str()) != 0) {
+        spdlog::error("Snapshot: cannot replace {}: {}", path_, std::strerror(errno));
+        ::unlink(tmpPath.c_str());
+        return false;
+    }
+
+    // Make the rename itself durable
+    auto dir = std::filesystem::path(path_).parent_path();
+    int dirFd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+    return true;
+}
+
+bool ShowSnapshot::restore(const std::string& path, MergeBuffer& mergeBuffer) {
+    auto started = std::chrono::steady_clock::now();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        if (errno == ENOENT) spdlog::info("Snapshot: {} does not exist yet, starting dark", path);
+        else spdlog::error("Snapshot: cannot open {}: {}", path, std::strerror(errno));
+        return false;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        spdlog::error("Snapshot: {} is empty", path);
+        ::close(fd);
+        return false;
+    }
+
+    auto size = static_cast<size_t>(st.st_size);
+    void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        spdlog::error("Snapshot: mmap of {} failed: {}", path, std::strerror(errno));
+        return false;
+    }
+    // Advice values are not flags; each needs its own call
+    ::madvise(p, size, MADV_SEQUENTIAL);
+    ::madvise(p, size, MADV_WILLNEED);
+
+    std::vector<Universe::Planes> planes;
+    std::string error;
+    bool ok = decode(static_cast<const uint8_t*>(p), size, planes, error);
+    uint64_t savedAtUs = 0;
+    if (ok) savedAtUs = reinterpret_cast<const SnapshotHeader*>(p)->savedAtUs;
+    ::munmap(p, size);
+    if (!ok) {
+        spdlog::error("Snapshot: cannot restore {}: {}", path, error);
+        return false;
+    }
+
+    auto engineCount = mergeBuffer.getUniverseCount();
+    if (planes.size() != engineCount) {
+        spdlog::warn("Snapshot: {} has {} universes, engine has {}", path, planes.size(), engineCount);
+    }
+    mergeBuffer.restorePlanes(planes.data(), std::min<size_t>(planes.size(), engineCount));
+
+    auto nowUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    double age = savedAtUs ? (nowUs - static_cast<int64_t>(savedAtUs)) / 1e6 : 0.0;
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    spdlog::info("Restored {} universes from {} (saved {:.0f} s ago) in {:.1f} ms",
+                 std::min<size_t>(planes.size(), engineCount), path, age, ms);
+    return true;
+}
+
+#endif
+
+} // namespace photon
@@ -0,0 +1,116 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "engine/MergeBuffer.h"
+#include "engine/Universe.h"
+
+namespace photon {
+
+// On-disk layout of a show snapshot (host byte order):
+//
+//   SnapshotHeader
+//   UniverseRecord*   one per universe with at least one active priority,
+//                     followed by its planes (see engine/PlaneCodec.h)
+//
+// The checksum covers everything after the header, so a torn or truncated
+// file is rejected instead of restoring half a look.
+namespace showsnap {
+
+inline constexpr char MAGIC[8] = {'P', 'H', 'O', 'T', 'S', 'N', 'A', 'P'};
+inline constexpr uint32_t VERSION = 1;
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint16_t universeCount;  // universes in the engine when saved
+    uint16_t recordCount;    // universe records that follow
+    uint8_t priorityCount;
+    uint8_t reserved[3];
+    uint64_t mergeVersion;
+    uint64_t savedAtUs;      // system clock, microseconds since the epoch
+    uint64_t payloadSize;
+    uint32_t checksum;       // CRC-32 of the payload
+    uint32_t padding;
+};
+
+struct UniverseRecord {
+    uint16_t universe;
+    uint8_t planeMask;
+    uint8_t reserved;
+};
+
+uint32_t crc32(const uint8_t* data, size_t size);
+
+} // namespace showsnap
+
+// Periodically saves every universe's priority planes so a restarted engine
+// comes back with the look it had. Captures copy only universes written since
+// the previous capture under MergeBuffer's shared lock; encoding and file I/O
+// happen afterwards on the snapshot thread. Files are written to a temporary
+// name, fsynced and renamed over the previous snapshot.
+class ShowSnapshot {
+public:
+    explicit ShowSnapshot(MergeBuffer& mergeBuffer);
+    ~ShowSnapshot();
+
+    // Saves to `path` every `interval` while anything has changed; a zero
+    // interval only saves on saveNow() and stop().
+    bool start(const std::string& path, std::chrono::milliseconds interval);
+    // Writes a final snapshot and stops the snapshot thread.
+    void stop();
+    bool isRunning() const;
+
+    // Captures and writes a snapshot on the calling thread.
+    bool saveNow();
+
+    // Loads `path` into `mergeBuffer` with one write. Universes beyond the
+    // engine's count are dropped; missing ones are cleared.
+    static bool restore(const std::string& path, MergeBuffer& mergeBuffer);
+
+    static void encode(const std::vector<Universe::Planes>& planes, uint64_t mergeVersion,
+                       uint64_t savedAtUs, std::vector<uint8_t>& out);
+    // Validates and decodes a snapshot image; `planes` gets one entry per
+    // universe the snapshot was taken with.
+    static bool decode(const uint8_t* data, size_t size, std::vector<Universe::Planes>& planes,
+                       std::string& error);
+
+    struct Stats {
+        uint64_t saves{0};
+        uint64_t bytes{0};           // size of the last snapshot written
+        uint64_t mergeVersion{0};    // MergeBuffer version of the last snapshot
+        double lastSaveSeconds{0.0}; // capture + encode + write
+    };
+    Stats getStats() const;
+
+private:
+    void run();
+    bool save(bool force);
+    bool writeFile(const std::vector<uint8_t>& data);
+
+    MergeBuffer& mergeBuffer_;
+    std::string path_;
+    std::chrono::milliseconds interval_{0};
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCv_;
+
+    // Held for a whole save; owns the capture state below
+    mutable std::mutex saveMutex_;
+    std::vector<Universe::Planes> planes_;
+    std::vector<uint8_t> encoded_;
+    uint64_t capturedVersion_{0};
+    bool saved_{false};
+    Stats stats_;
+};
+
+} // namespace photon
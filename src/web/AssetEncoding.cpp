@@ -0,0 +1,156 @@
+#include "web/AssetEncoding.h"
+#include <cctype>
+#include <cstdio>
+
+#ifdef PHOTON_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef PHOTON_HAVE_BROTLI
+#include <brotli/encode.h>
+#endif
+
+namespace photon::assets {
+
+#if defined(PHOTON_HAVE_ZLIB) || defined(PHOTON_HAVE_BROTLI)
+namespace {
+
+// Keep a compressed variant only if it saves at least this fraction
+constexpr double MIN_SAVING = 0.1;
+
+bool worthKeeping(size_t original, size_t compressed) {
+    return static_cast<double>(compressed) <= static_cast<double>(original) * (1.0 - MIN_SAVING);
+}
+
+} // namespace
+#endif
+
+const char* contentTypeFor(std::string_view ext) {
+    if (ext == ".html") return "text/html; charset=utf-8";
+    if (ext == ".js" || ext == ".mjs") return "application/javascript";
+    if (ext == ".css") return "text/css";
+    if (ext == ".json" || ext == ".map") return "application/json";
+    if (ext == ".svg") return "image/svg+xml";
+    if (ext == ".png") return "image/png";
+    if (ext == ".jpg" || ext == ".jpeg") return "image/jpeg";
+    if (ext == ".ico") return "image/x-icon";
+    if (ext == ".woff2") return "font/woff2";
+    if (ext == ".woff") return "font/woff";
+    if (ext == ".txt") return "text/plain; charset=utf-8";
+    if (ext == ".wasm") return "application/wasm";
+    return "application/octet-stream";
+}
+
+bool isCompressible(std::string_view contentType) {
+    return contentType.starts_with("text/") ||
+           contentType == "application/javascript" ||
+           contentType == "application/json" ||
+           contentType == "application/wasm" ||
+           contentType == "image/svg+xml";
+}
+
+bool isImmutablePath(std::string_view path) {
+    if (path.find("/_next/static/") != std::string_view::npos) return true;
+
+    // name.<hash>.ext or name-<hash>.ext with at least 8 hex/base36 characters
+    auto slash = path.rfind('/');
+    auto name = slash == std::string_view::npos ? path : path.substr(slash + 1);
+    auto lastDot = name.rfind('.');
+    if (lastDot == std::string_view::npos) return false;
+    auto stem = name.substr(0, lastDot);
+    auto sep = stem.find_last_of(".-");
+    if (sep == std::string_view::npos) return false;
+    auto hash = stem.substr(sep + 1);
+    if (hash.size() < 8) return false;
+    bool hasDigit = false;
+    for (char c : hash) {
+        if (!std::isalnum(static_cast<unsigned char>(c))) return false;
+        hasDigit |= std::isdigit(static_cast<unsigned char>(c)) != 0;
+    }
+    return hasDigit;
+}
+
+std::string contentETag(const std::string& body) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : body) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    char buf[24];
+    std::snprintf(buf, sizeof(buf), "\"%016llx\"", static_cast<unsigned long long>(hash));
+    return buf;
+}
+
+bool acceptsEncoding(std::string_view header, std::string_view coding) {
+    size_t pos = 0;
+    while (pos < header.size()) {
+        size_t comma = header.find(',', pos);
+        auto item = header.substr(pos, comma == std::string_view::npos ? std::string_view::npos : comma - pos);
+        pos = comma == std::string_view::npos ? header.size() : comma + 1;
+
+        while (!item.empty() && item.front() == ' ') item.remove_prefix(1);
+        auto semi = item.find(';');
+        auto name = item.substr(0, semi);
+        while (!name.empty() && name.back() == ' ') name.remove_suffix(1);
+        if (name != coding && name != "*") continue;
+
+        // "br;q=0" explicitly refuses the coding
+        if (semi != std::string_view::npos) {
+            auto params = item.substr(semi + 1);
+            auto q = params.find("q=");
+            if (q != std::string_view::npos) {
+                auto value = params.substr(q + 2);
+                if (value.starts_with("0") && value.find_first_of("123456789") == std::string_view::npos) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+bool gzipCompress(const std::string& in, std::string& out, int level) {
+#ifdef PHOTON_HAVE_ZLIB
+    z_stream zs{};
+    // 15 window bits + 16 selects the gzip wrapper
+    if (deflateInit2(&zs, level, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    out.resize(deflateBound(&zs, static_cast<uLong>(in.size())));
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    zs.avail_in = static_cast<uInt>(in.size());
+    zs.next_out = reinterpret_cast<Bytef*>(out.data());
+    zs.avail_out = static_cast<uInt>(out.size());
+    int ret = deflate(&zs, Z_FINISH);
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+    return ret == Z_STREAM_END && worthKeeping(in.size(), out.size());
+#else
+    (void)in;
+    (void)out;
+    (void)level;
+    return false;
+#endif
+}
+
+bool brotliCompress(const std::string& in, std::string& out, int quality) {
+#ifdef PHOTON_HAVE_BROTLI
+    size_t size = BrotliEncoderMaxCompressedSize(in.size());
+    if (size == 0) return false;
+    out.resize(size);
+    if (!BrotliEncoderCompress(quality, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT,
+                               in.size(), reinterpret_cast<const uint8_t*>(in.data()),
+                               &size, reinterpret_cast<uint8_t*>(out.data()))) {
+        return false;
+    }
+    out.resize(size);
+    return worthKeeping(in.size(), out.size());
+#else
+    (void)in;
+    (void)out;
+    (void)quality;
+    return false;
+#endif
+}
+
+} // namespace photon::assets
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace photon::assets {
+
+// Content-Type for a file extension (".js", ".css", ...).
+const char* contentTypeFor(std::string_view extension);
+
+// Whether a type benefits from compression (text, JSON, SVG, wasm).
+bool isCompressible(std::string_view contentType);
+
+// Next.js/Vite style hashed filenames (/_next/static/..., app.3f9a1c2e.js) can
+// be cached forever; everything else must be revalidated.
+bool isImmutablePath(std::string_view urlPath);
+
+// Strong ETag from a 64-bit FNV-1a content hash, quoted.
+std::string contentETag(const std::string& body);
+
+// Whether an Accept-Encoding header value allows `coding` ("br", "gzip").
+bool acceptsEncoding(std::string_view acceptEncoding, std::string_view coding);
+
+// Both return false when the codec is unavailable in this build or when the
+// result is not meaningfully smaller than the input.
+bool gzipCompress(const std::string& in, std::string& out, int level = 9);
+bool brotliCompress(const std::string& in, std::string& out, int quality = 9);
+
+} // namespace photon::assets
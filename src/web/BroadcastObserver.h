@@ -1,6 +1,5 @@
 #pragma once
 #include <cstdint>
-#include <string>
 
 namespace photon {
 
@@ -8,7 +7,8 @@ class BroadcastObserver {
 public:
     virtual ~BroadcastObserver() = default;
 
-    virtual void onDmxState(uint16_t universe, const std::string& jsonPayload) = 0;
+    // `channels` is the universe's 512 output values, valid for the call
+    virtual void onDmxState(uint16_t universe, const uint8_t* channels) = 0;
     virtual void onUniverseCount(uint16_t count) = 0;
 };
 
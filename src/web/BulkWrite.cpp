@@ -0,0 +1,62 @@
+#include "web/BulkWrite.h"
+
+namespace photon::bulk {
+
+namespace {
+
+uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+void writeU16(std::string& out, uint16_t v) {
+    out.push_back(static_cast<char>(v & 0xFF));
+    out.push_back(static_cast<char>(v >> 8));
+}
+
+} // namespace
+
+bool decode(std::string_view body, ChannelRun* runs, size_t& count, const char*& error) {
+    count = 0;
+    auto* p = reinterpret_cast<const uint8_t*>(body.data());
+    size_t remaining = body.size();
+    if (remaining == 0) {
+        error = "empty body";
+        return false;
+    }
+
+    while (remaining > 0) {
+        if (remaining < RECORD_HEADER_SIZE) {
+            error = "truncated record header";
+            return false;
+        }
+        if (count == MAX_RUNS) {
+            error = "too many runs";
+            return false;
+        }
+        ChannelRun run{readU16(p), readU16(p + 2), readU16(p + 4), p + RECORD_HEADER_SIZE};
+        p += RECORD_HEADER_SIZE;
+        remaining -= RECORD_HEADER_SIZE;
+
+        if (run.count == 0 || run.start + run.count > 512) {
+            error = "run outside channels 0-511";
+            return false;
+        }
+        if (remaining < run.count) {
+            error = "truncated run";
+            return false;
+        }
+        p += run.count;
+        remaining -= run.count;
+        runs[count++] = run;
+    }
+    return true;
+}
+
+void appendRun(std::string& out, uint16_t universe, uint16_t start, const uint8_t* values, uint16_t count) {
+    writeU16(out, universe);
+    writeU16(out, start);
+    writeU16(out, count);
+    out.append(reinterpret_cast<const char*>(values), count);
+}
+
+} // namespace photon::bulk
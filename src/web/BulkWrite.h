@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "engine/InputCoalescer.h"
+
+namespace photon::bulk {
+
+// Body of PUT /api/universes/bulk (Content-Type: application/octet-stream):
+// any number of records, back to back, integers little-endian:
+//   u16 universe | u16 start channel | u16 count | count value bytes
+// A full universe is start 0, count 512; sparse updates send several short
+// runs. All runs of one request are applied in the same output frame.
+
+constexpr size_t RECORD_HEADER_SIZE = 6;
+constexpr size_t MAX_RUNS = 1024;
+
+// Decodes into `runs` (capacity MAX_RUNS), whose values point into `body`.
+// On failure returns false with `error` naming the problem.
+bool decode(std::string_view body, ChannelRun* runs, size_t& count, const char*& error);
+
+// Appends one record (for clients and tests).
+void appendRun(std::string& out, uint16_t universe, uint16_t start, const uint8_t* values, uint16_t count);
+
+} // namespace photon::bulk
@@ -0,0 +1,125 @@
+#include "web/ClientQueue.h"
+#include "metrics/Metrics.h"
+#include <algorithm>
+
+namespace photon {
+
+namespace {
+
+uint64_t microsSince(ClientQueue::Clock::time_point then, ClientQueue::Clock::time_point now) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(now - then).count());
+}
+
+// Totals across every client, including ones that have since disconnected
+metrics::Counter wsMessagesSent{"photon_ws_messages_sent_total",
+    "WebSocket messages handed to client connections"};
+metrics::Counter wsBytesSent{"photon_ws_sent_bytes_total",
+    "WebSocket payload bytes handed to client connections"};
+metrics::Counter wsSuperseded{"photon_ws_frames_superseded_total",
+    "Queued WebSocket frames replaced by a newer frame before sending"};
+metrics::Counter wsDropped{"photon_ws_messages_dropped_total",
+    "WebSocket messages discarded because a client queue was full"};
+metrics::Histogram wsQueueLag{"photon_ws_queue_lag_seconds",
+    "Enqueue to hand-off time of the oldest message in each drained batch",
+    {0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5}};
+
+} // namespace
+
+ClientQueue::ClientQueue(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {}
+
+void ClientQueue::pushFrame(uint16_t universe, Payload payload, bool binary) {
+    std::lock_guard lock(mutex_);
+    if (universe >= slot_.size()) slot_.resize(universe + 1, -1);
+
+    if (int32_t idx = slot_[universe]; idx >= 0) {
+        ++stats_.superseded;
+        wsSuperseded.inc();
+        auto& existing = pending_[idx];
+        if (existing.binary == binary) {
+            // Keep the original position and timestamp, so lag reflects how
+            // long this universe has been stale on the client
+            existing.payload = std::move(payload);
+            return;
+        }
+        // Format switch: the frame must go out after the hello ack
+        pending_.erase(pending_.begin() + idx);
+        reindex();
+    }
+    push(Message{std::move(payload), binary, universe, Clock::now()});
+}
+
+void ClientQueue::pushControl(std::string payload, bool binary) {
+    std::lock_guard lock(mutex_);
+    push(Message{std::make_shared<const std::string>(std::move(payload)), binary, -1, Clock::now()});
+}
+
+void ClientQueue::push(Message message) {
+    if (pending_.size() >= capacity_) dropOldest();
+    if (message.universe >= 0) slot_[message.universe] = static_cast<int32_t>(pending_.size());
+    pending_.push_back(std::move(message));
+    stats_.maxDepth = std::max(stats_.maxDepth, pending_.size());
+}
+
+void ClientQueue::dropOldest() {
+    // Prefer losing a frame (the client catches up on that universe's next
+    // change) over a control message it cannot recover
+    auto it = std::find_if(pending_.begin(), pending_.end(),
+                           [](const Message& m) { return m.universe >= 0; });
+    if (it == pending_.end()) it = pending_.begin();
+    pending_.erase(it);
+    ++stats_.dropped;
+    wsDropped.inc();
+    reindex();
+}
+
+void ClientQueue::reindex() {
+    std::fill(slot_.begin(), slot_.end(), -1);
+    for (size_t i = 0; i < pending_.size(); ++i) {
+        if (pending_[i].universe >= 0) slot_[pending_[i].universe] = static_cast<int32_t>(i);
+    }
+}
+
+void ClientQueue::drain(std::vector<Message>& out) {
+    out.clear();
+    std::lock_guard lock(mutex_);
+    // Swapping hands the caller's (cleared) buffer back for the next batch
+    out.swap(pending_);
+
+    auto now = Clock::now();
+    uint64_t batchLag = 0;
+    uint64_t batchBytes = 0;
+    for (const auto& m : out) {
+        if (m.universe >= 0) slot_[m.universe] = -1;
+        batchLag = std::max(batchLag, microsSince(m.enqueued, now));
+        batchBytes += m.payload->size();
+    }
+    stats_.sentBytes += batchBytes;
+    stats_.sent += out.size();
+    if (!out.empty()) {
+        stats_.lastLagUs = batchLag;
+        stats_.maxLagUs = std::max(stats_.maxLagUs, batchLag);
+        wsMessagesSent.inc(out.size());
+        wsBytesSent.inc(batchBytes);
+        wsQueueLag.observe(static_cast<double>(batchLag) / 1e6);
+    }
+}
+
+size_t ClientQueue::depth() const {
+    std::lock_guard lock(mutex_);
+    return pending_.size();
+}
+
+ClientQueue::Stats ClientQueue::getStats() const {
+    std::lock_guard lock(mutex_);
+    Stats stats = stats_;
+    stats.depth = pending_.size();
+    if (!pending_.empty()) {
+        auto oldest = std::min_element(pending_.begin(), pending_.end(),
+            [](const Message& a, const Message& b) { return a.enqueued < b.enqueued; });
+        stats.pendingAgeUs = microsSince(oldest->enqueued, Clock::now());
+    }
+    return stats;
+}
+
+} // namespace photon
@@ -0,0 +1,66 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace photon {
+
+// Outbound messages for one WebSocket client, waiting for the broadcast
+// thread to hand them to the connection. DMX frames are keyed by universe: a
+// newer frame replaces an unsent older one, so a universe is never queued
+// twice. Control messages are
+// never coalesced. The queue is bounded; past capacity the oldest frame is
+// dropped.
+class ClientQueue {
+public:
+    using Clock = std::chrono::steady_clock;
+    // Shared between every client that receives the same frame
+    using Payload = std::shared_ptr<const std::string>;
+
+    struct Message {
+        Payload payload;
+        bool binary{false};
+        int32_t universe{-1}; // -1 for control messages
+        Clock::time_point enqueued;
+    };
+
+    struct Stats {
+        size_t depth{0};
+        size_t maxDepth{0};
+        uint64_t sent{0};
+        uint64_t sentBytes{0};
+        uint64_t superseded{0};  // frames replaced by a newer one before sending
+        uint64_t dropped{0};     // messages discarded because the queue was full
+        uint64_t lastLagUs{0};   // enqueue → hand-off of the last drained batch
+        uint64_t maxLagUs{0};
+        uint64_t pendingAgeUs{0}; // age of the oldest message still waiting
+    };
+
+    explicit ClientQueue(size_t capacity = 1024);
+
+    void pushFrame(uint16_t universe, Payload payload, bool binary);
+    void pushControl(std::string payload, bool binary = false);
+
+    // Moves everything pending into `out` in send order
+    void drain(std::vector<Message>& out);
+
+    // Messages waiting for the next drain
+    size_t depth() const;
+    Stats getStats() const;
+
+private:
+    void push(Message message);
+    void dropOldest();
+    void reindex();
+
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    std::vector<Message> pending_;
+    std::vector<int32_t> slot_; // universe → index into pending_, or -1
+    Stats stats_;
+};
+
+} // namespace photon
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace photon {
+
+// One frontend file compiled into the binary by tools/photon_embed. All
+// pointers refer to static read-only data; absent variants are nullptr/0.
+struct EmbeddedAsset {
+    const char* path;          // URL path, e.g. "/index.html"
+    const char* contentType;
+    const char* etag;
+    bool immutable;
+    const uint8_t* body;
+    size_t bodySize;
+    const uint8_t* gzip;
+    size_t gzipSize;
+    const uint8_t* brotli;
+    size_t brotliSize;
+};
+
+// Defined by the generated EmbeddedFrontend.cpp, or by EmbeddedAssetsNone.cpp
+// in builds without an embedded frontend.
+std::span<const EmbeddedAsset> embeddedAssets();
+
+} // namespace photon
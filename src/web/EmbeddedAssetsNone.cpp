@@ -0,0 +1,9 @@
+#include "web/EmbeddedAssets.h"
+
+namespace photon {
+
+std::span<const EmbeddedAsset> embeddedAssets() {
+    return {};
+}
+
+} // namespace photon
@@ -0,0 +1,33 @@
+#include "web/RateController.h"
+#include <algorithm>
+
+namespace photon {
+
+RateController::RateController(Options options)
+    : options_(options),
+      rateHz_(std::clamp(options.initialHz, options.minHz, std::max(options.minHz, options.maxHz))) {}
+
+bool RateController::due(Clock::time_point now) {
+    if (now < next_) return false;
+    auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rateHz_));
+    // Schedule from the previous slot to keep the cadence, but restart from
+    // now after a stall rather than bursting to catch up
+    next_ = next_ + interval < now ? now + interval : next_ + interval;
+    return true;
+}
+
+void RateController::sample(Clock::time_point now, bool congested) {
+    double elapsed = lastSample_ == Clock::time_point{}
+        ? 0.0 : std::chrono::duration<double>(now - lastSample_).count();
+    lastSample_ = now;
+
+    if (congested) {
+        if (now - lastDecrease_ < options_.holdoff) return;
+        lastDecrease_ = now;
+        rateHz_ = std::max(options_.minHz, rateHz_ / 2.0);
+    } else {
+        rateHz_ = std::min(options_.maxHz, rateHz_ + options_.increaseHzPerSec * elapsed);
+    }
+}
+
+} // namespace photon
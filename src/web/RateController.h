@@ -0,0 +1,39 @@
+#pragma once
+#include <chrono>
+
+namespace photon {
+
+// Broadcast rate for one WebSocket client. The rate climbs additively while
+// the client keeps up and is halved when it shows backpressure, at most once
+// per hold-off so a single slow round trip is not punished repeatedly.
+class RateController {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        double minHz{2.0};
+        double maxHz{60.0};
+        double initialHz{15.0};
+        double increaseHzPerSec{5.0};
+        std::chrono::milliseconds holdoff{500};
+    };
+
+    explicit RateController(Options options);
+
+    // True when the consumer is due for an update at `now`; consumes the slot.
+    bool due(Clock::time_point now);
+
+    // One congestion sample, taken at each send opportunity.
+    void sample(Clock::time_point now, bool congested);
+
+    double rateHz() const { return rateHz_; }
+
+private:
+    Options options_;
+    double rateHz_;
+    Clock::time_point next_{};
+    Clock::time_point lastSample_{};
+    Clock::time_point lastDecrease_{};
+};
+
+} // namespace photon
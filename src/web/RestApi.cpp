@@ -1,5 +1,13 @@
 #include "web/RestApi.h"
+#include "engine/CommandParser.h"
+#include "engine/ThreadPlacement.h"
+#include "metrics/Metrics.h"
+#include "metrics/Trace.h"
 #include "protocol/ArtNetSender.h"
+#include "replication/ReplicationReceiver.h"
+#include "show/ShowSnapshot.h"
+#include "web/BulkWrite.h"
+#include <array>
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 
@@ -7,20 +15,22 @@ namespace photon {
 
 using json = nlohmann::json;
 
-RestApi::RestApi(MergeBuffer& mergeBuffer, ActionQueue<Action>& actionQueue,
-                 DeviceManager& deviceManager, const Config& config)
-    : mergeBuffer_(mergeBuffer), actionQueue_(actionQueue),
-      deviceManager_(deviceManager), config_(config) {}
+RestApi::RestApi(MergeBuffer& mergeBuffer, InputCoalescer& input,
+                 DeviceManager& deviceManager, WsBroadcaster& wsBroadcaster,
+                 const Config& config)
+    : mergeBuffer_(mergeBuffer), input_(input),
+      deviceManager_(deviceManager), wsBroadcaster_(wsBroadcaster),
+      config_(config), universeCache_(mergeBuffer) {}
 
 void RestApi::registerRoutes(crow::SimpleApp& app) {
     CROW_ROUTE(app, "/api/config").methods("GET"_method)
     ([this] { return getConfig(); });
 
     CROW_ROUTE(app, "/api/universes").methods("GET"_method)
-    ([this] { return getUniverses(); });
+    ([this](const crow::request& req) { return getUniverses(req); });
 
     CROW_ROUTE(app, "/api/universes/<int>").methods("GET"_method)
-    ([this](int id) { return getUniverse(id); });
+    ([this](const crow::request& req, int id) { return getUniverse(req, id); });
 
     CROW_ROUTE(app, "/api/universes/<int>/channels/<int>").methods("PUT"_method)
     ([this](const crow::request& req, int universe, int channel) {
@@ -32,6 +42,9 @@ void RestApi::registerRoutes(crow::SimpleApp& app) {
         return setChannels(req, universe);
     });
 
+    CROW_ROUTE(app, "/api/universes/bulk").methods("PUT"_method)
+    ([this](const crow::request& req) { return setBulk(req); });
+
     CROW_ROUTE(app, "/api/blackout").methods("POST"_method)
     ([this] { return postBlackout(); });
 
@@ -43,6 +56,30 @@ void RestApi::registerRoutes(crow::SimpleApp& app) {
 
     CROW_ROUTE(app, "/api/devices/<string>").methods("DELETE"_method)
     ([this](const std::string& id) { return removeDevice(id); });
+
+    CROW_ROUTE(app, "/api/clients").methods("GET"_method)
+    ([this] { return getClients(); });
+
+    CROW_ROUTE(app, "/api/metrics").methods("GET"_method)
+    ([this] { return getMetrics(); });
+
+    CROW_ROUTE(app, "/api/trace/start").methods("POST"_method)
+    ([this] { return startTrace(); });
+
+    CROW_ROUTE(app, "/api/trace/stop").methods("POST"_method)
+    ([this] { return stopTrace(); });
+
+    CROW_ROUTE(app, "/api/trace").methods("GET"_method)
+    ([this] { return getTrace(); });
+
+    CROW_ROUTE(app, "/api/threads").methods("GET"_method)
+    ([this] { return getThreads(); });
+
+    CROW_ROUTE(app, "/api/snapshot").methods("POST"_method)
+    ([this] { return saveSnapshot(); });
+
+    CROW_ROUTE(app, "/api/standby/handback").methods("POST"_method)
+    ([this] { return standbyHandback(); });
 }
 
 crow::response RestApi::getConfig() {
@@ -51,40 +88,76 @@ crow::response RestApi::getConfig() {
     j["webPort"] = config_.webPort;
     j["artnetTargetIp"] = config_.artnetTargetIp;
     j["artnetPort"] = config_.artnetPort;
+    j["udpBackend"] = config_.udpBackend;
     j["outputHz"] = config_.outputHz;
     j["wsBroadcastHz"] = config_.wsBroadcastHz;
+    j["wsMinHz"] = config_.wsMinHz;
+    j["wsMaxHz"] = config_.wsMaxHz;
     crow::response res(j.dump());
     res.set_header("Content-Type", "application/json");
     return res;
 }
 
-crow::response RestApi::getUniverses() {
-    json arr = json::array();
-    for (uint16_t u = 0; u < mergeBuffer_.getUniverseCount(); ++u) {
-        json uni;
-        uni["id"] = u;
-        auto output = mergeBuffer_.getOutput(u);
-        uni["channels"] = json::array();
-        for (auto v : output) uni["channels"].push_back(v);
-        arr.push_back(uni);
+namespace {
+
+std::string makeETag(uint64_t version) {
+    return "\"" + std::to_string(version) + "\"";
+}
+
+// Weak comparison is enough here: the tag is the merge buffer version
+bool matchesETag(const crow::request& req, const std::string& etag) {
+    const auto& inm = req.get_header_value("If-None-Match");
+    if (inm.empty()) return false;
+    if (inm == "*") return true;
+    return inm.find(etag) != std::string::npos;
+}
+
+crow::response versionedResponse(const crow::request& req, uint64_t version, std::string body) {
+    auto etag = makeETag(version);
+    crow::response res;
+    if (matchesETag(req, etag)) {
+        res.code = 304;
+    } else {
+        res.body = std::move(body);
+        res.set_header("Content-Type", "application/json");
     }
-    crow::response res(arr.dump());
-    res.set_header("Content-Type", "application/json");
+    res.set_header("ETag", etag);
+    res.set_header("Cache-Control", "no-cache");
+    res.set_header("X-Photon-Version", std::to_string(version));
     return res;
 }
 
-crow::response RestApi::getUniverse(int id) {
+} // namespace
+
+crow::response RestApi::getUniverses(const crow::request& req) {
+    uint64_t version = 0;
+
+    // ?since=V returns only universes written after version V
+    if (const char* since = req.url_params.get("since")) {
+        uint64_t sinceVersion = 0;
+        try {
+            sinceVersion = std::stoull(since);
+        } catch (const std::exception&) {
+            return crow::response(400, R"({"error":"invalid since"})");
+        }
+        auto body = universeCache_.universesSince(sinceVersion, version);
+        crow::response res(body);
+        res.set_header("Content-Type", "application/json");
+        res.set_header("X-Photon-Version", std::to_string(version));
+        return res;
+    }
+
+    auto body = universeCache_.universes(version);
+    return versionedResponse(req, version, *body);
+}
+
+crow::response RestApi::getUniverse(const crow::request& req, int id) {
     if (id < 0 || id >= mergeBuffer_.getUniverseCount()) {
         return crow::response(404, "Universe not found");
     }
-    json j;
-    j["id"] = id;
-    auto output = mergeBuffer_.getOutput(static_cast<uint16_t>(id));
-    j["channels"] = json::array();
-    for (auto v : output) j["channels"].push_back(v);
-    crow::response res(j.dump());
-    res.set_header("Content-Type", "application/json");
-    return res;
+    uint64_t version = 0;
+    auto body = universeCache_.universe(static_cast<uint16_t>(id), version);
+    return versionedResponse(req, version, *body);
 }
 
 crow::response RestApi::setChannel(const crow::request& req, int universe, int channel) {
@@ -93,10 +166,21 @@ crow::response RestApi::setChannel(const crow::request& req, int universe, int c
     if (channel < 0 || channel >= 512)
         return crow::response(400, "Channel out of range (0-511)");
 
+    uint8_t value = 0;
+    if (command::parseChannelValue(req.body, value)) {
+        input_.push(action::SetChannel{
+            static_cast<uint16_t>(universe),
+            static_cast<uint16_t>(channel),
+            value
+        });
+        return crow::response(200, R"({"ok":true})");
+    }
+
+    // Slow path, also the source of the error message
     try {
         auto body = json::parse(req.body);
-        uint8_t value = body.at("value").get<uint8_t>();
-        actionQueue_.push(action::SetChannel{
+        value = body.at("value").get<uint8_t>();
+        input_.push(action::SetChannel{
             static_cast<uint16_t>(universe),
             static_cast<uint16_t>(channel),
             value
@@ -111,13 +195,17 @@ crow::response RestApi::setChannels(const crow::request& req, int universe) {
     if (universe < 0 || universe >= mergeBuffer_.getUniverseCount())
         return crow::response(404, "Universe not found");
 
+    if (command::parseChannelMap(req.body, static_cast<uint16_t>(universe), input_)) {
+        return crow::response(200, R"({"ok":true})");
+    }
+
     try {
         auto body = json::parse(req.body);
         auto& channels = body.at("channels");
         for (auto& [key, val] : channels.items()) {
             uint16_t ch = static_cast<uint16_t>(std::stoi(key));
             uint8_t v = val.get<uint8_t>();
-            actionQueue_.push(action::SetChannel{
+            input_.push(action::SetChannel{
                 static_cast<uint16_t>(universe), ch, v
             });
         }
@@ -127,8 +215,31 @@ crow::response RestApi::setChannels(const crow::request& req, int universe) {
     }
 }
 
+crow::response RestApi::setBulk(const crow::request& req) {
+    if (req.get_header_value("Content-Type").find("application/octet-stream") == std::string::npos) {
+        return crow::response(415, R"({"error":"expected application/octet-stream"})");
+    }
+
+    // Runs view the request body directly; nothing is copied per channel
+    std::array<ChannelRun, bulk::MAX_RUNS> runs;
+    size_t count = 0;
+    const char* error = nullptr;
+    if (!bulk::decode(req.body, runs.data(), count, error)) {
+        return crow::response(400, std::string(R"({"error":")") + error + "\"}");
+    }
+    // All or nothing: reject the request before any of it is queued
+    for (size_t i = 0; i < count; ++i) {
+        if (runs[i].universe >= mergeBuffer_.getUniverseCount()) {
+            return crow::response(404, R"({"error":"universe not found"})");
+        }
+    }
+
+    input_.pushRuns(runs.data(), count);
+    return crow::response(200, R"({"ok":true,"runs":)" + std::to_string(count) + "}");
+}
+
 crow::response RestApi::postBlackout() {
-    actionQueue_.push(action::Blackout{});
+    input_.push(action::Blackout{});
     spdlog::info("Blackout triggered via REST");
     return crow::response(200, R"({"ok":true})");
 }
@@ -142,6 +253,15 @@ crow::response RestApi::getDevices() {
         dev["description"] = d.device->getDescription();
         dev["universe"] = d.universe;
         dev["open"] = d.device->isOpen();
+        auto stats = d.device->getStats();
+        dev["transport"] = stats.transport;
+        dev["stats"] = {
+            {"packets", stats.packets},
+            {"bytes", stats.bytes},
+            {"errors", stats.errors},
+            {"lastSubmitUs", stats.lastSubmitUs},
+            {"maxSubmitUs", stats.maxSubmitUs},
+        };
         arr.push_back(dev);
     }
     crow::response res(arr.dump());
@@ -158,7 +278,8 @@ crow::response RestApi::addDevice(const crow::request& req) {
         if (type == "artnet") {
             std::string ip = body.value("ip", "255.255.255.255");
             uint16_t port = body.value("port", 6454);
-            auto device = std::make_shared<ArtNetSender>(ip, port);
+            auto backend = parseUdpBackend(body.value("backend", config_.udpBackend));
+            auto device = std::make_shared<ArtNetSender>(ip, port, backend);
             std::string id = deviceManager_.addDevice(device, universe);
             json j;
             j["id"] = id;
@@ -179,4 +300,116 @@ crow::response RestApi::removeDevice(const std::string& id) {
     return crow::response(200, R"({"ok":true})");
 }
 
+crow::response RestApi::getClients() {
+    json arr = json::array();
+    for (const auto& c : wsBroadcaster_.getClientStats()) {
+        json client;
+        client["remoteIp"] = c.remoteIp;
+        client["protocol"] = c.binary ? "binary" : "json";
+        client["universes"] = c.universes;
+        client["rateHz"] = c.rateHz;
+        client["rttMs"] = c.rttMs;
+        client["inFlightBytes"] = c.inFlightBytes;
+        client["queue"] = {
+            {"depth", c.queue.depth},
+            {"maxDepth", c.queue.maxDepth},
+            {"sent", c.queue.sent},
+            {"sentBytes", c.queue.sentBytes},
+            {"superseded", c.queue.superseded},
+            {"dropped", c.queue.dropped},
+            {"lastLagUs", c.queue.lastLagUs},
+            {"maxLagUs", c.queue.maxLagUs},
+            {"pendingAgeUs", c.queue.pendingAgeUs},
+        };
+        arr.push_back(client);
+    }
+    crow::response res(arr.dump());
+    res.set_header("Content-Type", "application/json");
+    return res;
+}
+
+crow::response RestApi::getMetrics() {
+    crow::response res(metrics::registry().render());
+    res.set_header("Content-Type", "text/plain; version=0.0.4; charset=utf-8");
+    return res;
+}
+
+crow::response RestApi::startTrace() {
+    trace::start();
+    spdlog::info("Trace capture started");
+    return crow::response(200, R"({"ok":true,"capturing":true})");
+}
+
+crow::response RestApi::stopTrace() {
+    trace::stop();
+    spdlog::info("Trace capture stopped");
+    return crow::response(200, R"({"ok":true,"capturing":false})");
+}
+
+crow::response RestApi::getTrace() {
+    crow::response res(trace::exportChromeJson());
+    res.set_header("Content-Type", "application/json");
+    res.set_header("Content-Disposition", "attachment; filename=\"photon-trace.json\"");
+    return res;
+}
+
+crow::response RestApi::getThreads() {
+    json threads = json::array();
+    for (const auto& t : placement::report()) {
+        json requested = {
+            {"cpus", t.requested.cpus},
+            {"policy", placement::schedName(t.requested.sched)},
+            {"priority", t.requested.priority},
+        };
+        json thread = {
+            {"role", t.role},
+            {"name", t.name},
+            {"tid", t.tid},
+            {"requested", requested},
+            {"cpus", t.cpus},
+            {"policy", t.sched},
+            {"priority", t.priority},
+        };
+        if (!t.error.empty()) thread["error"] = t.error;
+        threads.push_back(thread);
+    }
+    json j;
+    j["memoryLocked"] = placement::memoryLocked();
+    j["threads"] = threads;
+    crow::response res(j.dump());
+    res.set_header("Content-Type", "application/json");
+    return res;
+}
+
+crow::response RestApi::saveSnapshot() {
+    if (!snapshot_) {
+        return crow::response(409, R"({"error":"Snapshots are not enabled; start with --snapshot FILE"})");
+    }
+    if (!snapshot_->saveNow()) {
+        return crow::response(500, R"({"error":"Snapshot could not be written"})");
+    }
+    auto stats = snapshot_->getStats();
+    json j = {
+        {"ok", true},
+        {"bytes", stats.bytes},
+        {"version", stats.mergeVersion},
+        {"seconds", stats.lastSaveSeconds},
+    };
+    crow::response res(j.dump());
+    res.set_header("Content-Type", "application/json");
+    return res;
+}
+
+crow::response RestApi::standbyHandback() {
+    if (!standby_) {
+        return crow::response(409, R"({"error":"Not running as a hot standby; start with --standby PORT"})");
+    }
+    if (!standby_->handBack()) {
+        return crow::response(409, R"({"error":"The standby is not driving output"})");
+    }
+    crow::response res(R"({"ok":true})");
+    res.set_header("Content-Type", "application/json");
+    return res;
+}
+
 } // namespace photon
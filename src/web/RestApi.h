@@ -1,34 +1,55 @@
 #pragma once
 #include <crow.h>
 #include "application/Config.h"
-#include "engine/ActionQueue.h"
+#include "engine/InputCoalescer.h"
 #include "engine/MergeBuffer.h"
 #include "protocol/DeviceManager.h"
+#include "web/UniverseCache.h"
+#include "web/WsBroadcaster.h"
 
 namespace photon {
 
+class ReplicationReceiver;
+class ShowSnapshot;
+
 class RestApi {
 public:
-    RestApi(MergeBuffer& mergeBuffer, ActionQueue<Action>& actionQueue,
-            DeviceManager& deviceManager, const Config& config);
+    RestApi(MergeBuffer& mergeBuffer, InputCoalescer& input,
+            DeviceManager& deviceManager, WsBroadcaster& wsBroadcaster,
+            const Config& config);
 
     void registerRoutes(crow::SimpleApp& app);
+    void setSnapshot(ShowSnapshot* snapshot) { snapshot_ = snapshot; }
+    void setStandby(ReplicationReceiver* standby) { standby_ = standby; }
 
 private:
     crow::response getConfig();
-    crow::response getUniverses();
-    crow::response getUniverse(int id);
+    crow::response getUniverses(const crow::request& req);
+    crow::response getUniverse(const crow::request& req, int id);
     crow::response setChannel(const crow::request& req, int universe, int channel);
     crow::response setChannels(const crow::request& req, int universe);
+    crow::response setBulk(const crow::request& req);
     crow::response postBlackout();
     crow::response getDevices();
     crow::response addDevice(const crow::request& req);
     crow::response removeDevice(const std::string& id);
+    crow::response getClients();
+    crow::response getMetrics();
+    crow::response startTrace();
+    crow::response stopTrace();
+    crow::response getTrace();
+    crow::response getThreads();
+    crow::response saveSnapshot();
+    crow::response standbyHandback();
 
     MergeBuffer& mergeBuffer_;
-    ActionQueue<Action>& actionQueue_;
+    InputCoalescer& input_;
     DeviceManager& deviceManager_;
+    WsBroadcaster& wsBroadcaster_;
     const Config& config_;
+    UniverseCache universeCache_;
+    ShowSnapshot* snapshot_{nullptr};
+    ReplicationReceiver* standby_{nullptr};
 };
 
 } // namespace photon
@@ -0,0 +1,185 @@
+#include "web/StaticAssetCache.h"
+#include "web/AssetEncoding.h"
+#include "web/EmbeddedAssets.h"
+#include <spdlog/spdlog.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace photon {
+
+namespace fs = std::filesystem;
+
+StaticAssetCache::~StaticAssetCache() {
+    stopWatching();
+}
+
+StaticAssetCache::AssetPtr StaticAssetCache::makeAsset(const std::string& urlPath, std::string body) {
+    auto asset = std::make_shared<StaticAsset>();
+    auto ext = fs::path(urlPath).extension().string();
+    asset->contentType = assets::contentTypeFor(ext);
+    asset->etag = assets::contentETag(body);
+    asset->immutable = assets::isImmutablePath(urlPath);
+    if (assets::isCompressible(asset->contentType)) {
+        if (!assets::gzipCompress(body, asset->ownedGzip)) asset->ownedGzip.clear();
+        if (!assets::brotliCompress(body, asset->ownedBrotli)) asset->ownedBrotli.clear();
+    }
+    asset->ownedBody = std::move(body);
+    asset->body = asset->ownedBody;
+    asset->gzip = asset->ownedGzip;
+    asset->brotli = asset->ownedBrotli;
+    return asset;
+}
+
+bool StaticAssetCache::loadEmbedded() {
+    auto embedded = embeddedAssets();
+    if (embedded.empty()) return false;
+
+    auto assets = std::make_shared<AssetMap>();
+    size_t totalBytes = 0;
+    for (const auto& e : embedded) {
+        auto asset = std::make_shared<StaticAsset>();
+        asset->body = {reinterpret_cast<const char*>(e.body), e.bodySize};
+        asset->gzip = {reinterpret_cast<const char*>(e.gzip), e.gzipSize};
+        asset->brotli = {reinterpret_cast<const char*>(e.brotli), e.brotliSize};
+        asset->contentType = e.contentType;
+        asset->etag = e.etag;
+        asset->immutable = e.immutable;
+        totalBytes += e.bodySize;
+        assets->emplace(e.path, std::move(asset));
+    }
+    spdlog::info("Serving {} embedded frontend assets ({} KB)", assets->size(), totalBytes / 1024);
+
+    std::lock_guard lock(mutex_);
+    assets_ = std::move(assets);
+    rootDir_.clear();
+    totalBytes_ = totalBytes;
+    return true;
+}
+
+bool StaticAssetCache::load(const std::string& rootDir) {
+    std::error_code ec;
+    if (!fs::is_directory(rootDir, ec)) return false;
+
+    auto start = std::chrono::steady_clock::now();
+    auto assets = std::make_shared<AssetMap>();
+    size_t totalBytes = 0;
+    size_t compressedBytes = 0;
+
+    for (auto it = fs::recursive_directory_iterator(rootDir, ec);
+         !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (!it->is_regular_file(ec)) continue;
+
+        std::ifstream file(it->path(), std::ios::binary);
+        if (!file) continue;
+        std::string body((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        auto urlPath = "/" + fs::relative(it->path(), rootDir, ec).generic_string();
+        auto asset = makeAsset(urlPath, std::move(body));
+        totalBytes += asset->body.size();
+        compressedBytes += asset->gzip.size() + asset->brotli.size();
+        assets->emplace(std::move(urlPath), std::move(asset));
+    }
+
+    auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    spdlog::info("Loaded {} frontend assets ({} KB, {} KB precompressed) in {:.0f} ms",
+                 assets->size(), totalBytes / 1024, compressedBytes / 1024, ms);
+
+    std::lock_guard lock(mutex_);
+    assets_ = std::move(assets);
+    rootDir_ = rootDir;
+    totalBytes_ = totalBytes;
+    return true;
+}
+
+StaticAssetCache::AssetPtr StaticAssetCache::find(std::string_view urlPath) const {
+    std::shared_ptr<const AssetMap> assets;
+    {
+        std::lock_guard lock(mutex_);
+        assets = assets_;
+    }
+    if (!assets) return nullptr;
+
+    std::string key(urlPath == "/" ? std::string_view("/index.html") : urlPath);
+    if (auto it = assets->find(key); it != assets->end()) return it->second;
+
+    // SPA fallback: serve index.html for unmatched routes
+    if (auto it = assets->find("/index.html"); it != assets->end()) return it->second;
+    return nullptr;
+}
+
+size_t StaticAssetCache::getAssetCount() const {
+    std::lock_guard lock(mutex_);
+    return assets_ ? assets_->size() : 0;
+}
+
+size_t StaticAssetCache::getTotalBytes() const {
+    std::lock_guard lock(mutex_);
+    return totalBytes_;
+}
+
+void StaticAssetCache::startWatching(std::chrono::milliseconds interval) {
+    if (watching_.exchange(true)) return;
+    watchThread_ = std::thread([this, interval] { watchLoop(interval); });
+    spdlog::info("Watching frontend directory for changes");
+}
+
+void StaticAssetCache::stopWatching() {
+    if (!watching_.exchange(false)) return;
+    watchCv_.notify_all();
+    if (watchThread_.joinable()) watchThread_.join();
+}
+
+void StaticAssetCache::watchLoop(std::chrono::milliseconds interval) {
+    uint64_t signature = scanSignature();
+    std::unique_lock lock(watchMutex_);
+    while (watching_.load()) {
+        watchCv_.wait_for(lock, interval, [this] { return !watching_.load(); });
+        if (!watching_.load()) break;
+
+        uint64_t current = scanSignature();
+        if (current == signature) continue;
+        signature = current;
+
+        std::string root;
+        {
+            std::lock_guard assetsLock(mutex_);
+            root = rootDir_;
+        }
+        spdlog::info("Frontend changed, reloading assets");
+        load(root);
+    }
+}
+
+uint64_t StaticAssetCache::scanSignature() const {
+    std::string root;
+    {
+        std::lock_guard lock(mutex_);
+        root = rootDir_;
+    }
+
+    // FNV-1a over every file's path, size and mtime
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    auto mix = [&hash](const void* data, size_t size) {
+        auto* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= p[i];
+            hash *= 0x100000001b3ULL;
+        }
+    };
+
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(root, ec);
+         !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (!it->is_regular_file(ec)) continue;
+        auto path = it->path().generic_string();
+        auto size = it->file_size(ec);
+        auto mtime = it->last_write_time(ec).time_since_epoch().count();
+        mix(path.data(), path.size());
+        mix(&size, sizeof(size));
+        mix(&mtime, sizeof(mtime));
+    }
+    return hash;
+}
+
+} // namespace photon
@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace photon {
+
+struct StaticAsset {
+    std::string_view body;
+    std::string_view gzip;     // empty if not worth compressing
+    std::string_view brotli;
+    std::string_view contentType;
+    std::string etag;
+    bool immutable{false};
+
+    // Backing storage for assets read from disk; embedded assets view the
+    // binary's read-only data directly and leave these empty
+    std::string ownedBody;
+    std::string ownedGzip;
+    std::string ownedBrotli;
+};
+
+// Frontend files held in memory with precompressed variants, so the
+// catch-all route never touches the disk. load() swaps in a complete new set;
+// readers keep the asset they looked up alive across a concurrent reload.
+class StaticAssetCache {
+public:
+    using AssetPtr = std::shared_ptr<const StaticAsset>;
+
+    StaticAssetCache() = default;
+    ~StaticAssetCache();
+
+    bool load(const std::string& rootDir);
+    // Serves the frontend compiled into the binary (see web/EmbeddedAssets.h);
+    // false if this build has none.
+    bool loadEmbedded();
+
+    // Resolves "/" to /index.html and falls back to /index.html for unknown
+    // paths (SPA routing); nullptr if neither exists.
+    AssetPtr find(std::string_view urlPath) const;
+
+    size_t getAssetCount() const;
+    size_t getTotalBytes() const;
+
+    // Development mode: poll the directory and reload when any file changes.
+    void startWatching(std::chrono::milliseconds interval = std::chrono::milliseconds(1000));
+    void stopWatching();
+
+    static AssetPtr makeAsset(const std::string& urlPath, std::string body);
+
+private:
+    using AssetMap = std::unordered_map<std::string, AssetPtr>;
+
+    void watchLoop(std::chrono::milliseconds interval);
+    uint64_t scanSignature() const;
+
+    mutable std::mutex mutex_;
+    std::shared_ptr<const AssetMap> assets_;
+    std::string rootDir_;
+    size_t totalBytes_{0};
+
+    std::thread watchThread_;
+    std::atomic<bool> watching_{false};
+    std::mutex watchMutex_;
+    std::condition_variable watchCv_;
+};
+
+} // namespace photon
@@ -0,0 +1,74 @@
+#include "web/UniverseCache.h"
+#include <nlohmann/json.hpp>
+
+namespace photon {
+
+using json = nlohmann::json;
+
+UniverseCache::UniverseCache(const MergeBuffer& mergeBuffer)
+    : mergeBuffer_(mergeBuffer), entries_(mergeBuffer.getUniverseCount()) {}
+
+const UniverseCache::Entry& UniverseCache::refresh(uint16_t id) {
+    auto& entry = entries_[id];
+    if (entry.json && entry.version == mergeBuffer_.getUniverseVersion(id)) return entry;
+
+    std::array<uint8_t, 512> output;
+    uint64_t version = mergeBuffer_.getOutput(id, output);
+
+    json j;
+    j["id"] = id;
+    j["version"] = version;
+    j["channels"] = output;
+    entry.version = version;
+    entry.json = std::make_shared<const std::string>(j.dump());
+    return entry;
+}
+
+UniverseCache::Body UniverseCache::universe(uint16_t id, uint64_t& version) {
+    std::lock_guard lock(mutex_);
+    if (id >= entries_.size()) return nullptr;
+    const auto& entry = refresh(id);
+    version = entry.version;
+    return entry.json;
+}
+
+UniverseCache::Body UniverseCache::universes(uint64_t& version) {
+    std::lock_guard lock(mutex_);
+    uint64_t current = mergeBuffer_.getVersion();
+    if (all_.json && all_.version == current) {
+        version = current;
+        return all_.json;
+    }
+
+    std::string body = "[";
+    for (uint16_t u = 0; u < entries_.size(); ++u) {
+        if (u) body += ',';
+        body += *refresh(u).json;
+    }
+    body += ']';
+
+    // Universes written while assembling are already included, so labelling
+    // the body with the pre-read version only causes one redundant refetch
+    all_.version = current;
+    all_.json = std::make_shared<const std::string>(std::move(body));
+    version = current;
+    return all_.json;
+}
+
+std::string UniverseCache::universesSince(uint64_t since, uint64_t& version) {
+    std::lock_guard lock(mutex_);
+    version = mergeBuffer_.getVersion();
+
+    std::string body = "[";
+    bool first = true;
+    for (uint16_t u = 0; u < entries_.size(); ++u) {
+        if (mergeBuffer_.getUniverseVersion(u) <= since) continue;
+        if (!first) body += ',';
+        body += *refresh(u).json;
+        first = false;
+    }
+    body += ']';
+    return body;
+}
+
+} // namespace photon
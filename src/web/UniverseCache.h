@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "engine/MergeBuffer.h"
+
+namespace photon {
+
+// Serialised REST views of the merge buffer. Each universe's JSON object
+// ({"channels":[...],"id":N,"version":V}) is rebuilt only when its MergeBuffer
+// version moves, and the full /api/universes array only when any universe
+// changed, so polling dashboards cost a version check instead of a re-merge.
+class UniverseCache {
+public:
+    using Body = std::shared_ptr<const std::string>;
+
+    explicit UniverseCache(const MergeBuffer& mergeBuffer);
+
+    // `version` receives the version the returned body reflects.
+    Body universe(uint16_t id, uint64_t& version);
+    Body universes(uint64_t& version);
+    // Array of only the universes written after `since`.
+    std::string universesSince(uint64_t since, uint64_t& version);
+
+private:
+    struct Entry {
+        uint64_t version{0};
+        Body json;
+    };
+
+    // Expects mutex_ to be held
+    const Entry& refresh(uint16_t id);
+
+    const MergeBuffer& mergeBuffer_;
+    std::mutex mutex_;
+    std::vector<Entry> entries_;
+    Entry all_;
+};
+
+} // namespace photon
@@ -1,20 +1,22 @@
 #include "web/WebServer.h"
+#include "engine/CommandParser.h"
+#include "metrics/Trace.h"
+#include "pixel/PixelMapper.h"
+#include "web/AssetEncoding.h"
+#include "web/WsProtocol.h"
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
-#include <filesystem>
-#include <fstream>
 
 namespace photon {
 
 using json = nlohmann::json;
-namespace fs = std::filesystem;
 
-WebServer::WebServer(MergeBuffer& mergeBuffer, ActionQueue<Action>& actionQueue,
+WebServer::WebServer(MergeBuffer& mergeBuffer, InputCoalescer& input,
                      DeviceManager& deviceManager, WsBroadcaster& wsBroadcaster,
                      const Config& config)
-    : restApi_(mergeBuffer, actionQueue, deviceManager, config),
+    : restApi_(mergeBuffer, input, deviceManager, wsBroadcaster, config),
       wsBroadcaster_(wsBroadcaster), config_(config),
-      mergeBuffer_(mergeBuffer), actionQueue_(actionQueue) {}
+      mergeBuffer_(mergeBuffer), input_(input) {}
 
 void WebServer::start() {
     restApi_.registerRoutes(app_);
@@ -37,13 +39,49 @@ void WebServer::setupWebSocket() {
         .onclose([this](crow::websocket::connection& conn, const std::string&, uint16_t) {
             wsBroadcaster_.removeConnection(&conn);
         })
-        .onmessage([this](crow::websocket::connection&, const std::string& data, bool) {
+        .onmessage([this](crow::websocket::connection& conn, const std::string& data, bool isBinary) {
+            PHOTON_TRACE_SCOPE("ws.message");
+            if (isBinary) {
+                handleBinaryMessage(conn, data);
+                return;
+            }
+            // Fader traffic takes the allocation-free path; anything it does
+            // not recognise goes through the DOM below
+            switch (command::parse(data, input_)) {
+                case command::Type::None:
+                    break;
+                case command::Type::Blackout:
+                    spdlog::info("Blackout triggered via WebSocket");
+                    return;
+                default:
+                    return;
+            }
             try {
                 auto msg = json::parse(data);
                 std::string type = msg.at("type").get<std::string>();
 
-                if (type == "set_channel") {
-                    actionQueue_.push(action::SetChannel{
+                if (type == "hello") {
+                    if (msg.value("protocol", "") == "binary") wsBroadcaster_.enableBinary(&conn);
+                } else if (type == "pong") {
+                    wsBroadcaster_.onPong(&conn, msg.value("id", 0u));
+                } else if (type == "subscribe" || type == "unsubscribe") {
+                    // {"type":"subscribe","universes":[0,3]} or "universes":"all"
+                    const auto& universes = msg.at("universes");
+                    if (universes.is_string() && universes.get<std::string>() == "all") {
+                        if (type == "subscribe") {
+                            wsBroadcaster_.subscribeAll(&conn);
+                        } else {
+                            std::vector<uint16_t> all(mergeBuffer_.getUniverseCount());
+                            for (uint16_t u = 0; u < all.size(); ++u) all[u] = u;
+                            wsBroadcaster_.unsubscribe(&conn, all);
+                        }
+                    } else if (type == "subscribe") {
+                        wsBroadcaster_.subscribe(&conn, universes.get<std::vector<uint16_t>>());
+                    } else {
+                        wsBroadcaster_.unsubscribe(&conn, universes.get<std::vector<uint16_t>>());
+                    }
+                } else if (type == "set_channel") {
+                    input_.push(action::SetChannel{
                         msg.at("universe").get<uint16_t>(),
                         msg.at("channel").get<uint16_t>(),
                         msg.at("value").get<uint8_t>()
@@ -51,14 +89,14 @@ void WebServer::setupWebSocket() {
                 } else if (type == "set_channels") {
                     uint16_t universe = msg.at("universe").get<uint16_t>();
                     for (auto& pair : msg.at("channels")) {
-                        actionQueue_.push(action::SetChannel{
+                        input_.push(action::SetChannel{
                             universe,
                             pair[0].get<uint16_t>(),
                             pair[1].get<uint8_t>()
                         });
                     }
                 } else if (type == "blackout") {
-                    actionQueue_.push(action::Blackout{});
+                    input_.push(action::Blackout{});
                     spdlog::info("Blackout triggered via WebSocket");
                 }
             } catch (const std::exception& e) {
@@ -67,57 +105,85 @@ void WebServer::setupWebSocket() {
         });
 }
 
-void WebServer::setupStaticFiles() {
-    if (config_.frontendDir.empty()) return;
+void WebServer::handleBinaryMessage(crow::websocket::connection& conn, const std::string& data) {
+    wsproto::Header header{};
+    if (wsproto::readHeader(reinterpret_cast<const uint8_t*>(data.data()), data.size(), header) &&
+        header.type == wsproto::MessageType::CommandBatch) {
+        thread_local std::vector<ChannelRun> runs(wsproto::MAX_BATCH_RUNS);
+        size_t count = 0;
+        bool blackout = false;
+        if (!wsproto::decodeCommandBatch(data, header, runs.data(), count, blackout)) {
+            spdlog::warn("Invalid command batch ({} bytes)", data.size());
+            return;
+        }
+        input_.pushRuns(runs.data(), count, blackout);
+        wsBroadcaster_.sendControl(&conn, wsproto::batchAck(header.seq));
+        return;
+    }
+    if (header.type == wsproto::MessageType::PixelFrame) {
+        wsproto::PixelFrame frame;
+        if (!pixelMapper_ || !wsproto::decodePixelFrame(data, header, frame)) {
+            spdlog::warn("Invalid or unexpected pixel frame ({} bytes)", data.size());
+            return;
+        }
+        pixelMapper_->render(frame.pixels, frame.width, frame.height,
+                             frame.rgba ? PixelFormat::RGBA : PixelFormat::RGB);
+        return;
+    }
 
-    fs::path frontendPath(config_.frontendDir);
-    if (!fs::exists(frontendPath)) {
-        spdlog::warn("Frontend directory not found: {}", config_.frontendDir);
+    wsproto::SetChannels msg;
+    if (!wsproto::decodeSetChannels(data, msg)) {
+        spdlog::warn("Invalid binary WebSocket message ({} bytes)", data.size());
         return;
     }
+    ChannelRun run{msg.universe, msg.start, msg.count, msg.values};
+    input_.pushRuns(&run, 1);
+}
 
-    spdlog::info("Serving frontend from: {}", config_.frontendDir);
+void WebServer::setupStaticFiles() {
+    // An explicit --frontend-dir wins over the copy compiled into the binary
+    if (!config_.frontendDir.empty()) {
+        if (!assetCache_.load(config_.frontendDir)) {
+            spdlog::warn("Frontend directory not found: {}", config_.frontendDir);
+            return;
+        }
+        spdlog::info("Serving frontend from: {}", config_.frontendDir);
+        if (config_.frontendWatch) assetCache_.startWatching();
+    } else if (!assetCache_.loadEmbedded()) {
+        return;
+    }
 
     CROW_CATCHALL_ROUTE(app_)
-    ([this](const crow::request& req) -> crow::response {
-        fs::path frontendPath(config_.frontendDir);
-        std::string urlPath = req.url;
-
-        if (urlPath == "/") urlPath = "/index.html";
-
-        fs::path filePath = frontendPath / urlPath.substr(1);
-
-        if (fs::exists(filePath) && fs::is_regular_file(filePath)) {
-            std::ifstream file(filePath, std::ios::binary);
-            std::string content((std::istreambuf_iterator<char>(file)),
-                                std::istreambuf_iterator<char>());
-
-            crow::response res(200, content);
-            std::string ext = filePath.extension().string();
-            if (ext == ".html") res.set_header("Content-Type", "text/html; charset=utf-8");
-            else if (ext == ".js") res.set_header("Content-Type", "application/javascript");
-            else if (ext == ".css") res.set_header("Content-Type", "text/css");
-            else if (ext == ".json") res.set_header("Content-Type", "application/json");
-            else if (ext == ".svg") res.set_header("Content-Type", "image/svg+xml");
-            else if (ext == ".png") res.set_header("Content-Type", "image/png");
-            else if (ext == ".ico") res.set_header("Content-Type", "image/x-icon");
-            else if (ext == ".woff2") res.set_header("Content-Type", "font/woff2");
-            return res;
-        }
+    ([this](const crow::request& req) { return serveAsset(req); });
+}
 
-        // SPA fallback: serve index.html for unmatched routes
-        fs::path indexPath = frontendPath / "index.html";
-        if (fs::exists(indexPath)) {
-            std::ifstream file(indexPath, std::ios::binary);
-            std::string content((std::istreambuf_iterator<char>(file)),
-                                std::istreambuf_iterator<char>());
-            crow::response res(200, content);
-            res.set_header("Content-Type", "text/html; charset=utf-8");
-            return res;
-        }
+crow::response WebServer::serveAsset(const crow::request& req) {
+    auto asset = assetCache_.find(req.url);
+    if (!asset) return crow::response(404);
+
+    crow::response res;
+    res.set_header("ETag", asset->etag);
+    res.set_header("Cache-Control", asset->immutable ? "public, max-age=31536000, immutable" : "no-cache");
+    res.set_header("Vary", "Accept-Encoding");
 
-        return crow::response(404);
-    });
+    const auto& ifNoneMatch = req.get_header_value("If-None-Match");
+    if (!ifNoneMatch.empty() && ifNoneMatch.find(asset->etag) != std::string::npos) {
+        res.code = 304;
+        return res;
+    }
+
+    res.set_header("Content-Type", std::string(asset->contentType));
+    const auto& acceptEncoding = req.get_header_value("Accept-Encoding");
+    if (!asset->brotli.empty() && assets::acceptsEncoding(acceptEncoding, "br")) {
+        res.set_header("Content-Encoding", "br");
+        res.body = std::string(asset->brotli);
+    } else if (!asset->gzip.empty() && assets::acceptsEncoding(acceptEncoding, "gzip")) {
+        res.set_header("Content-Encoding", "gzip");
+        res.body = std::string(asset->gzip);
+    } else {
+        res.body = std::string(asset->body);
+    }
+    return res;
 }
 
 } // namespace photon
@@ -2,33 +2,47 @@
 #include <crow.h>
 #include <string>
 #include "application/Config.h"
-#include "engine/ActionQueue.h"
+#include "engine/InputCoalescer.h"
 #include "engine/MergeBuffer.h"
 #include "protocol/DeviceManager.h"
 #include "web/RestApi.h"
+#include "web/StaticAssetCache.h"
 #include "web/WsBroadcaster.h"
 
 namespace photon {
 
+class PixelMapper;
+
 class WebServer {
 public:
-    WebServer(MergeBuffer& mergeBuffer, ActionQueue<Action>& actionQueue,
+    WebServer(MergeBuffer& mergeBuffer, InputCoalescer& input,
               DeviceManager& deviceManager, WsBroadcaster& wsBroadcaster,
               const Config& config);
 
     void start();
     void stop();
 
+    // Enables POST /api/snapshot; call before start()
+    void setSnapshot(ShowSnapshot* snapshot) { restApi_.setSnapshot(snapshot); }
+    // Enables POST /api/standby/handback; call before start()
+    void setStandby(ReplicationReceiver* standby) { restApi_.setStandby(standby); }
+    // Accepts binary PixelFrame messages; call before start()
+    void setPixelMapper(PixelMapper* mapper) { pixelMapper_ = mapper; }
+
 private:
     void setupWebSocket();
+    void handleBinaryMessage(crow::websocket::connection& conn, const std::string& data);
     void setupStaticFiles();
+    crow::response serveAsset(const crow::request& req);
 
     crow::SimpleApp app_;
     RestApi restApi_;
+    StaticAssetCache assetCache_;
     WsBroadcaster& wsBroadcaster_;
     const Config& config_;
     MergeBuffer& mergeBuffer_;
-    ActionQueue<Action>& actionQueue_;
+    InputCoalescer& input_;
+    PixelMapper* pixelMapper_{nullptr};
 };
 
 } // namespace photon
@@ -1,4 +1,8 @@
 #include "web/WsBroadcaster.h"
+#include "web/WsProtocol.h"
+#include "metrics/Metrics.h"
+#include "metrics/Trace.h"
+#include "engine/ThreadPlacement.h"
 #include <algorithm>
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
@@ -8,28 +12,150 @@ namespace photon {
 
 using json = nlohmann::json;
 
-WsBroadcaster::WsBroadcaster(MergeBuffer& mergeBuffer, double hz)
-    : mergeBuffer_(mergeBuffer), hz_(hz) {}
+namespace {
+
+constexpr auto PING_INTERVAL = std::chrono::seconds(1);
+// Round-trip time above which a client is treated as congested
+constexpr auto RTT_TARGET = std::chrono::milliseconds(150);
+// Send rate above which a client that never answers pings is treated as
+// congested, since nothing tells us how much of it was read
+constexpr double UNACKED_BYTES_PER_SEC = 256 * 1024;
+
+metrics::Gauge wsClients{"photon_ws_clients", "Connected WebSocket clients"};
+
+} // namespace
+
+WsBroadcaster::WsBroadcaster(MergeBuffer& mergeBuffer, RateController::Options rates, Clock& clock)
+    : mergeBuffer_(mergeBuffer), rates_(rates), clock_(clock),
+      subscribers_(mergeBuffer.getUniverseCount()),
+      encoded_(mergeBuffer.getUniverseCount()) {}
 
 WsBroadcaster::~WsBroadcaster() {
     stop();
 }
 
 void WsBroadcaster::addConnection(crow::websocket::connection* conn) {
-    {
-        std::lock_guard lock(connMutex_);
-        connections_.insert(conn);
-    }
+    std::lock_guard lock(connMutex_);
+    auto [it, inserted] = connections_.try_emplace(conn, rates_);
+    if (!inserted) return;
+
+    auto& state = it->second;
+    state.conn = conn;
+    state.subscribed.assign(subscribers_.size(), false);
+    state.stale.assign(subscribers_.size(), false);
+    // Frames coalesce per universe, so the slack only covers control messages
+    state.queue = std::make_shared<ClientQueue>(subscribers_.size() + 64);
+    try {
+        state.remoteIp = conn->get_remote_ip();
+    } catch (...) {}
+    for (uint16_t u = 0; u < subscribers_.size(); ++u) indexAdd(state, u);
+
+    wsClients.set(static_cast<int64_t>(connections_.size()));
     spdlog::info("WebSocket client connected (total: {})", connections_.size());
-    sendFullState(conn);
+    sendFullState(state);
 }
 
 void WsBroadcaster::removeConnection(crow::websocket::connection* conn) {
     std::lock_guard lock(connMutex_);
+    auto* state = findConnection(conn);
+    if (!state) return;
+    for (uint16_t u = 0; u < subscribers_.size(); ++u) {
+        if (state->subscribed[u]) indexRemove(*state, u);
+    }
     connections_.erase(conn);
+    wsClients.set(static_cast<int64_t>(connections_.size()));
     spdlog::info("WebSocket client disconnected (total: {})", connections_.size());
 }
 
+void WsBroadcaster::enableBinary(crow::websocket::connection* conn) {
+    // Held across the resend so no JSON broadcast can interleave with it
+    std::lock_guard lock(connMutex_);
+    auto* state = findConnection(conn);
+    if (!state) return;
+    state->binary = true;
+    state->queue->pushControl(wsproto::helloAck());
+    sendFullState(*state);
+    // Anything marked stale in the old format is covered by the resend
+    state->stale.assign(subscribers_.size(), false);
+    state->hasStale = false;
+}
+
+void WsBroadcaster::subscribe(crow::websocket::connection* conn,
+                              const std::vector<uint16_t>& universes) {
+    std::lock_guard lock(connMutex_);
+    auto* state = findConnection(conn);
+    if (!state) return;
+    if (state->allUniverses) {
+        // First explicit subscription replaces the implicit "everything"
+        for (uint16_t u = 0; u < subscribers_.size(); ++u) indexRemove(*state, u);
+        state->allUniverses = false;
+    }
+    for (auto u : universes) {
+        if (u >= subscribers_.size()) continue;
+        if (!state->subscribed[u]) indexAdd(*state, u);
+        sendUniverse(*state, u);
+    }
+}
+
+void WsBroadcaster::subscribeAll(crow::websocket::connection* conn) {
+    std::lock_guard lock(connMutex_);
+    auto* state = findConnection(conn);
+    if (!state) return;
+    for (uint16_t u = 0; u < subscribers_.size(); ++u) {
+        if (state->subscribed[u]) continue;
+        indexAdd(*state, u);
+        sendUniverse(*state, u);
+    }
+    state->allUniverses = true;
+}
+
+void WsBroadcaster::unsubscribe(crow::websocket::connection* conn,
+                                const std::vector<uint16_t>& universes) {
+    std::lock_guard lock(connMutex_);
+    auto* state = findConnection(conn);
+    if (!state) return;
+    state->allUniverses = false;
+    for (auto u : universes) {
+        if (u < subscribers_.size() && state->subscribed[u]) indexRemove(*state, u);
+    }
+}
+
+WsBroadcaster::ConnectionState* WsBroadcaster::findConnection(crow::websocket::connection* conn) {
+    auto it = connections_.find(conn);
+    return it == connections_.end() ? nullptr : &it->second;
+}
+
+void WsBroadcaster::indexAdd(ConnectionState& state, uint16_t universe) {
+    if (state.subscribed[universe]) return;
+    state.subscribed[universe] = true;
+    subscribers_[universe].push_back(&state);
+}
+
+void WsBroadcaster::indexRemove(ConnectionState& state, uint16_t universe) {
+    if (!state.subscribed[universe]) return;
+    state.subscribed[universe] = false;
+    auto& subs = subscribers_[universe];
+    subs.erase(std::remove(subs.begin(), subs.end(), &state), subs.end());
+}
+
+std::vector<WsBroadcaster::ClientStats> WsBroadcaster::getClientStats() {
+    std::lock_guard lock(connMutex_);
+    std::vector<ClientStats> result;
+    result.reserve(connections_.size());
+    for (const auto& [conn, state] : connections_) {
+        ClientStats stats;
+        stats.remoteIp = state.remoteIp;
+        stats.binary = state.binary;
+        stats.universes = static_cast<size_t>(std::count(state.subscribed.begin(), state.subscribed.end(), true));
+        stats.queue = state.queue->getStats();
+        stats.rateHz = state.rate.rateHz();
+        stats.rttMs = state.rttMs;
+        stats.inFlightBytes = state.inFlightBytes;
+        result.push_back(std::move(stats));
+    }
+    return result;
+}
+
 void WsBroadcaster::addObserver(BroadcastObserver* observer) {
     std::lock_guard lock(observerMutex_);
     observers_.push_back(observer);
@@ -48,18 +174,20 @@ void WsBroadcaster::removeObserver(BroadcastObserver* observer) {
 void WsBroadcaster::start() {
     if (running_.exchange(true)) return;
     thread_ = std::thread([this] { broadcastLoop(); });
-    spdlog::info("WebSocket broadcaster started at {:.0f} Hz", hz_);
+    spdlog::info("WebSocket broadcaster started at {:.0f}-{:.0f} Hz per client", rates_.minHz, rates_.maxHz);
 }
 
 void WsBroadcaster::stop() {
     running_.store(false);
+    clock_.wake();
     if (thread_.joinable()) thread_.join();
 }
 
 void WsBroadcaster::broadcastLoop() {
-    using clock = std::chrono::steady_clock;
-    auto interval = std::chrono::microseconds(static_cast<long>(1'000'000.0 / hz_));
-    auto nextTick = clock::now();
+    trace::setThreadName("ws-broadcast");
+    placement::apply(placement::Role::Broadcast, "ws-broadcast");
+    auto interval = std::chrono::microseconds(static_cast<long>(1'000'000.0 / rates_.maxHz));
+    auto nextTick = clock_.now();
 
     // Notify observers of universe count on start
     {
@@ -71,66 +199,211 @@ void WsBroadcaster::broadcastLoop() {
         }
     }
 
+    const uint16_t universeCount = mergeBuffer_.getUniverseCount();
+    std::vector<uint16_t> changed, wanted;
+    std::vector<bool> wantJson(universeCount, false), wantBinary(universeCount, false);
+    std::array<uint8_t, 512> channels;
+
     while (running_.load()) {
         nextTick += interval;
 
-        {
-            std::lock_guard lock(connMutex_);
-            for (uint16_t u = 0; u < mergeBuffer_.getUniverseCount(); ++u) {
-                if (!mergeBuffer_.isUniverseDirty(u)) continue;
-                mergeBuffer_.clearUniverseDirty(u);
-
-                auto output = mergeBuffer_.getOutput(u);
-
-                json msg;
-                msg["type"] = "dmx_state";
-                msg["universe"] = u;
-                msg["channels"] = json::array();
-                for (uint16_t ch = 0; ch < 512; ++ch) {
-                    msg["channels"].push_back(output[ch]);
-                }
-                std::string payload = msg.dump();
-
-                for (auto* conn : connections_) {
-                    try {
-                        conn->send_text(payload);
-                    } catch (...) {}
-                }
+        changed.clear();
+        for (uint16_t u = 0; u < universeCount; ++u) {
+            if (!mergeBuffer_.isUniverseDirty(u)) continue;
+            mergeBuffer_.clearUniverseDirty(u);
+            changed.push_back(u);
+        }
 
-                // Notify observers with the already-serialised payload (zero-copy)
-                {
-                    std::lock_guard obsLock(observerMutex_);
+        // Observers see every change; they only store it and pace their
+        // own output (see RelayClient)
+        {
+            std::lock_guard obsLock(observerMutex_);
+            if (!observers_.empty()) {
+                for (auto u : changed) {
+                    mergeBuffer_.getOutput(u, channels);
                     for (auto* obs : observers_) {
                         try {
-                            obs->onDmxState(u, payload);
+                            obs->onDmxState(u, channels.data());
                         } catch (...) {}
                     }
                 }
             }
         }
 
-        std::this_thread::sleep_until(nextTick);
+        auto now = clock_.now();
+
+        // Mark what changed as stale for its subscribers and find the
+        // clients due for an update, along with the formats they need
+        wanted.clear();
+        {
+            std::lock_guard lock(connMutex_);
+            for (auto u : changed) {
+                for (auto* state : subscribers_[u]) {
+                    state->stale[u] = true;
+                    state->hasStale = true;
+                }
+            }
+            for (auto& [conn, state] : connections_) {
+                state.due = state.hasStale && state.rate.due(now);
+                if (!state.due) continue;
+                auto& want = state.binary ? wantBinary : wantJson;
+                for (uint16_t u = 0; u < universeCount; ++u) {
+                    if (!state.stale[u] || want[u]) continue;
+                    if (!wantJson[u] && !wantBinary[u]) wanted.push_back(u);
+                    want[u] = true;
+                }
+            }
+        }
+
+        // Serialise outside connMutex_, and only what a due client will send
+        // this tick; each MergeBuffer version is encoded once per format
+        if (!wanted.empty()) {
+            PHOTON_TRACE_SCOPE("ws.serialize");
+            uint32_t seq = seq_.fetch_add(1) + 1;
+            for (auto u : wanted) {
+                auto& entry = encoded_[u];
+                bool needJson = wantJson[u], needBinary = wantBinary[u];
+                wantJson[u] = wantBinary[u] = false;
+                if (mergeBuffer_.getUniverseVersion(u) == entry.version &&
+                    (!needJson || entry.json) && (!needBinary || entry.binary)) continue;
+
+                PHOTON_TRACE_SCOPE_ARG("ws.encode", "universe", u);
+                uint64_t version = mergeBuffer_.getOutput(u, channels);
+                if (version != entry.version) entry = EncodedUniverse{version, nullptr, nullptr};
+                if (needBinary && !entry.binary) {
+                    entry.binary = std::make_shared<const std::string>(wsproto::encodeDmxState(u, seq, channels.data()));
+                }
+                if (needJson && !entry.json) {
+                    entry.json = std::make_shared<const std::string>(wsproto::encodeDmxStateJson(u, channels.data()));
+                }
+            }
+        }
+
+        // Queue what is due, then hand each connection everything queued
+        // since its last batch was acknowledged, including control messages
+        // from other threads
+        {
+            PHOTON_TRACE_SCOPE("ws.enqueue");
+            std::lock_guard lock(connMutex_);
+            for (auto& [conn, state] : connections_) {
+                if (state.due) serviceConnection(state, now);
+                flush(state, now);
+            }
+        }
+
+        clock_.sleepUntil(nextTick, running_);
     }
 }
 
-void WsBroadcaster::sendFullState(crow::websocket::connection* conn) {
-    try {
-        json universeMsg;
-        universeMsg["type"] = "universes";
-        universeMsg["count"] = mergeBuffer_.getUniverseCount();
-        conn->send_text(universeMsg.dump());
-
-        for (uint16_t u = 0; u < mergeBuffer_.getUniverseCount(); ++u) {
-            auto output = mergeBuffer_.getOutput(u);
-            json msg;
-            msg["type"] = "dmx_state";
-            msg["universe"] = u;
-            msg["channels"] = json::array();
-            for (uint16_t ch = 0; ch < 512; ++ch) {
-                msg["channels"].push_back(output[ch]);
-            }
-            conn->send_text(msg.dump());
+void WsBroadcaster::serviceConnection(ConnectionState& state, Clock::time_point now) {
+    state.due = false;
+
+    // Backpressure: the previous batch is still unacknowledged when the
+    // next one is due, or pongs come back slowly because they queue
+    // behind everything Crow still has to write to the client. Without
+    // pongs the only backlog signal is how many bytes we hand it.
+    bool congested;
+    if (state.pongSeen) {
+        auto rttTarget = std::chrono::duration<double, std::milli>(RTT_TARGET).count();
+        congested = state.pingId != 0 || state.rttMs > rttTarget;
+    } else {
+        congested = state.lastBatchBytes * state.rate.rateHz() > UNACKED_BYTES_PER_SEC;
+    }
+    state.rate.sample(now, congested);
+
+    // A universe subscribed or a format switched since the encode pass has
+    // no payload yet; it stays stale until the client is next due
+    state.hasStale = false;
+    for (uint16_t u = 0; u < state.stale.size(); ++u) {
+        if (!state.stale[u]) continue;
+        const auto& payload = state.binary ? encoded_[u].binary : encoded_[u].json;
+        if (!payload) {
+            state.hasStale = true;
+            continue;
         }
+        state.stale[u] = false;
+        state.queue->pushFrame(u, payload, state.binary);
+    }
+}
+
+void WsBroadcaster::sendControl(crow::websocket::connection* conn, std::string message) {
+    std::lock_guard lock(connMutex_);
+    auto* state = findConnection(conn);
+    if (!state) return;
+    state->queue->pushControl(std::move(message));
+}
+
+void WsBroadcaster::onPong(crow::websocket::connection* conn, uint32_t id) {
+    auto now = clock_.now();
+    std::lock_guard lock(connMutex_);
+    auto* state = findConnection(conn);
+    if (!state || id == 0 || id != state->pingId) return;
+
+    double rtt = std::chrono::duration<double, std::milli>(now - state->pingSent).count();
+    state->rttMs = state->pongSeen ? state->rttMs * 0.75 + rtt * 0.25 : rtt;
+    state->pongSeen = true;
+    state->pingId = 0; // answered, so the batch before it has been read
+    state->inFlightBytes = 0;
+}
+
+void WsBroadcaster::sendUniverse(ConnectionState& state, uint16_t universe) {
+    auto output = mergeBuffer_.getOutput(universe);
+    auto payload = std::make_shared<const std::string>(state.binary
+        ? wsproto::encodeDmxState(universe, seq_.load(), output.data())
+        : wsproto::encodeDmxStateJson(universe, output.data()));
+    state.queue->pushFrame(universe, std::move(payload), state.binary);
+}
+
+void WsBroadcaster::sendFullState(ConnectionState& state) {
+    json universeMsg;
+    universeMsg["type"] = "universes";
+    universeMsg["count"] = mergeBuffer_.getUniverseCount();
+    state.queue->pushControl(universeMsg.dump());
+
+    for (uint16_t u = 0; u < subscribers_.size(); ++u) {
+        if (state.subscribed[u]) sendUniverse(state, u);
+    }
+}
+
+void WsBroadcaster::flush(ConnectionState& state, Clock::time_point now) {
+    if (state.pingId != 0) {
+        // The previous batch is still in flight: leave frames to coalesce in
+        // the queue rather than pile up in Crow's unbounded write buffer. A
+        // client that has never answered a ping can't acknowledge anything,
+        // so its batch counts as read one send interval later.
+        if (state.pongSeen) return;
+        if (now - state.pingSent < std::chrono::duration<double>(1.0 / state.rate.rateHz())) return;
+        state.pingId = 0;
+        state.inFlightBytes = 0;
+    }
+    bool pingDue = now - state.pingSent >= PING_INTERVAL;
+    if (state.queue->depth() == 0 && !pingDue) return;
+
+    // send_text/send_binary only hand the message to the connection's I/O
+    // thread, so this never waits on the client. The connection stays valid
+    // while it is in connections_: Crow calls onclose, which removes it under
+    // connMutex_, before destroying it.
+    PHOTON_TRACE_SCOPE("ws.send");
+    state.queue->drain(sendBatch_);
+    size_t bytes = 0;
+    for (const auto& message : sendBatch_) {
+        bytes += message.payload->size();
+        try {
+            if (message.binary) state.conn->send_binary(*message.payload);
+            else state.conn->send_text(*message.payload);
+        } catch (...) {}
+    }
+    sendBatch_.clear();
+
+    // Every hand-off ends with a ping; the pong both acknowledges the batch
+    // and measures the round trip
+    state.lastPingId = state.lastPingId == UINT32_MAX ? 1 : state.lastPingId + 1;
+    state.pingId = state.lastPingId;
+    state.pingSent = now;
+    state.inFlightBytes = bytes;
+    state.lastBatchBytes = bytes;
+    try {
+        state.conn->send_text(R"({"type":"ping","id":)" + std::to_string(state.pingId) + "}");
     } catch (...) {}
 }
 
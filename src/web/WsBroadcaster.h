@@ -1,23 +1,71 @@
 #pragma once
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <memory>
 #include <mutex>
-#include <set>
+#include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 #include <crow.h>
+#include "engine/Clock.h"
 #include "engine/MergeBuffer.h"
 #include "web/BroadcastObserver.h"
+#include "web/ClientQueue.h"
+#include "web/RateController.h"
 
 namespace photon {
 
+// Pushes DMX state to WebSocket clients and observers. The loop ticks at the
+// maximum rate and every client is served at its own adaptive rate (see
+// web/RateController.h): universes that change between two of its updates are
+// marked stale and sent once, at their latest state, when it is next due. A
+// universe is only serialised when a due client needs it, at most once per
+// MergeBuffer version and format. Frames are queued per connection (see
+// web/ClientQueue.h); the broadcast thread hands a connection's queue to Crow,
+// which writes it on the connection's I/O thread, and follows it with a ping.
+// Nothing more is handed over until the pong comes back, so a slow client's
+// frames coalesce in its bounded queue and it only delays itself. Observers
+// get every change as raw channels and pace themselves.
 class WsBroadcaster {
 public:
-    explicit WsBroadcaster(MergeBuffer& mergeBuffer, double hz = 15.0);
+    struct ClientStats {
+        std::string remoteIp;
+        bool binary{false};
+        size_t universes{0};
+        ClientQueue::Stats queue;
+        double rateHz{0};
+        double rttMs{0}; // 0 until the client answers a ping
+        size_t inFlightBytes{0}; // handed to Crow, not yet acknowledged
+    };
+
+    explicit WsBroadcaster(MergeBuffer& mergeBuffer, RateController::Options rates = {},
+                           Clock& clock = Clock::system());
     ~WsBroadcaster();
 
     void addConnection(crow::websocket::connection* conn);
     void removeConnection(crow::websocket::connection* conn);
 
+    // Switches a connection to binary DMX frames (see web/WsProtocol.h) and
+    // resends the full state in the new format.
+    void enableBinary(crow::websocket::connection* conn);
+
+    // Universe subscriptions. A new connection receives every universe until
+    // its first subscribe/unsubscribe narrows it to an explicit set; newly
+    // subscribed universes are sent immediately.
+    void subscribe(crow::websocket::connection* conn, const std::vector<uint16_t>& universes);
+    void subscribeAll(crow::websocket::connection* conn);
+    void unsubscribe(crow::websocket::connection* conn, const std::vector<uint16_t>& universes);
+
+    // Answer to the {"type":"ping","id":N} sent to every client once a second.
+    void onPong(crow::websocket::connection* conn, uint32_t id);
+
+    // Queues a text control message (e.g. a batch ack) for one connection
+    void sendControl(crow::websocket::connection* conn, std::string message);
+
+    std::vector<ClientStats> getClientStats();
+
     void addObserver(BroadcastObserver* observer);
     void removeObserver(BroadcastObserver* observer);
 
@@ -26,13 +74,62 @@ public:
 
 private:
     void broadcastLoop();
-    void sendFullState(crow::websocket::connection* conn);
+    struct ConnectionState {
+        explicit ConnectionState(const RateController::Options& rates) : rate(rates) {}
+
+        crow::websocket::connection* conn{nullptr};
+        bool binary{false};
+        bool allUniverses{true};
+        std::vector<bool> subscribed;
+        std::string remoteIp;
+        std::shared_ptr<ClientQueue> queue;
+
+        RateController rate;
+        std::vector<bool> stale; // changed since this client's last update
+        bool hasStale{false};
+        bool due{false}; // due for an update this tick
+
+        // Flow control: at most one hand-off to Crow in flight. pingId is
+        // the ping sent after it, 0 once answered.
+        uint32_t pingId{0};
+        uint32_t lastPingId{0};
+        Clock::time_point pingSent{};
+        size_t inFlightBytes{0};
+        size_t lastBatchBytes{0};
+        bool pongSeen{false};
+        double rttMs{0};
+    };
+
+    // All of these expect connMutex_ to be held
+    ConnectionState* findConnection(crow::websocket::connection* conn);
+    void indexAdd(ConnectionState& state, uint16_t universe);
+    void indexRemove(ConnectionState& state, uint16_t universe);
+    void sendUniverse(ConnectionState& state, uint16_t universe);
+    void sendFullState(ConnectionState& state);
+    void flush(ConnectionState& state, Clock::time_point now);
+    // Queues the stale universes of a client that is due this tick
+    void serviceConnection(ConnectionState& state, Clock::time_point now);
+
+    struct EncodedUniverse {
+        uint64_t version{0};
+        ClientQueue::Payload json;
+        ClientQueue::Payload binary;
+    };
 
     MergeBuffer& mergeBuffer_;
-    double hz_;
+    RateController::Options rates_;
+    Clock& clock_;
 
     std::mutex connMutex_;
-    std::set<crow::websocket::connection*> connections_;
+    std::unordered_map<crow::websocket::connection*, ConnectionState> connections_;
+    // Inverted index: universe → subscribed connections
+    std::vector<std::vector<ConnectionState*>> subscribers_;
+    std::atomic<uint32_t> seq_{0};
+
+    // Latest serialised state per universe, owned by the broadcast thread;
+    // stale universes are always sent from here
+    std::vector<EncodedUniverse> encoded_;
+    std::vector<ClientQueue::Message> sendBatch_; // reused by flush()
 
     std::mutex observerMutex_;
     std::vector<BroadcastObserver*> observers_;
@@ -0,0 +1,202 @@
+#include "web/WsProtocol.h"
+#include <charconv>
+#include <cstring>
+
+namespace photon::wsproto {
+
+void writeHeader(uint8_t* out, const Header& header) {
+    out[0] = static_cast<uint8_t>(header.type);
+    out[1] = header.flags;
+    out[2] = static_cast<uint8_t>(header.universe & 0xFF);
+    out[3] = static_cast<uint8_t>(header.universe >> 8);
+    out[4] = static_cast<uint8_t>(header.seq & 0xFF);
+    out[5] = static_cast<uint8_t>((header.seq >> 8) & 0xFF);
+    out[6] = static_cast<uint8_t>((header.seq >> 16) & 0xFF);
+    out[7] = static_cast<uint8_t>(header.seq >> 24);
+}
+
+bool readHeader(const uint8_t* data, size_t size, Header& header) {
+    if (size < HEADER_SIZE) return false;
+    header.type = static_cast<MessageType>(data[0]);
+    header.flags = data[1];
+    header.universe = static_cast<uint16_t>(data[2] | (data[3] << 8));
+    header.seq = static_cast<uint32_t>(data[4]) |
+                 (static_cast<uint32_t>(data[5]) << 8) |
+                 (static_cast<uint32_t>(data[6]) << 16) |
+                 (static_cast<uint32_t>(data[7]) << 24);
+    return true;
+}
+
+std::string encodeDmxState(uint16_t universe, uint32_t seq, const uint8_t* channels) {
+    std::string out(DMX_STATE_SIZE, '\0');
+    auto* p = reinterpret_cast<uint8_t*>(out.data());
+    writeHeader(p, {MessageType::DmxState, 0, universe, seq});
+    std::memcpy(p + HEADER_SIZE, channels, 512);
+    return out;
+}
+
+std::string encodeDmxStateJson(uint16_t universe, const uint8_t* channels) {
+    // Worst case 512 * "255," plus the envelope
+    std::string out;
+    out.resize(64 + 512 * 4);
+    char* p = out.data();
+    char* end = p + out.size();
+
+    constexpr std::string_view prefix = R"({"channels":[)";
+    std::memcpy(p, prefix.data(), prefix.size());
+    p += prefix.size();
+    for (int ch = 0; ch < 512; ++ch) {
+        if (ch) *p++ = ',';
+        p = std::to_chars(p, end, channels[ch]).ptr;
+    }
+    constexpr std::string_view middle = R"(],"type":"dmx_state","universe":)";
+    std::memcpy(p, middle.data(), middle.size());
+    p += middle.size();
+    p = std::to_chars(p, end, universe).ptr;
+    *p++ = '}';
+
+    out.resize(static_cast<size_t>(p - out.data()));
+    return out;
+}
+
+bool decodeSetChannels(const std::string& data, SetChannels& out) {
+    auto* p = reinterpret_cast<const uint8_t*>(data.data());
+    Header header{};
+    if (!readHeader(p, data.size(), header)) return false;
+    if (header.type != MessageType::SetChannels) return false;
+    if (data.size() < HEADER_SIZE + 3) return false;
+
+    uint16_t start = static_cast<uint16_t>(p[HEADER_SIZE] | (p[HEADER_SIZE + 1] << 8));
+    size_t count = data.size() - HEADER_SIZE - 2;
+    if (start >= 512 || count > 512u - start) return false;
+
+    out.universe = header.universe;
+    out.start = start;
+    out.count = static_cast<uint16_t>(count);
+    out.values = p + HEADER_SIZE + 2;
+    return true;
+}
+
+std::string encodeDmxDelta(uint16_t universe, uint32_t seq,
+                           const uint8_t* previous, const uint8_t* current) {
+    std::string out(HEADER_SIZE, '\0');
+    writeHeader(reinterpret_cast<uint8_t*>(out.data()), {MessageType::DmxDelta, 0, universe, seq});
+
+    int ch = 0;
+    while (ch < 512) {
+        if (previous[ch] == current[ch]) { ++ch; continue; }
+        int start = ch;
+        int end = ch + 1; // one past the last changed channel in this run
+        for (int next = end; next < 512; ++next) {
+            if (previous[next] == current[next]) continue;
+            // Carrying a short unchanged gap is cheaper than a new run header
+            if (next - end >= static_cast<int>(DELTA_RUN_HEADER_SIZE)) break;
+            end = next + 1;
+        }
+        uint16_t count = static_cast<uint16_t>(end - start);
+        char runHeader[DELTA_RUN_HEADER_SIZE] = {
+            static_cast<char>(start & 0xFF), static_cast<char>(start >> 8),
+            static_cast<char>(count & 0xFF), static_cast<char>(count >> 8)};
+        out.append(runHeader, DELTA_RUN_HEADER_SIZE);
+        out.append(reinterpret_cast<const char*>(current + start), count);
+        ch = end;
+    }
+    return out;
+}
+
+bool applyDmxDelta(const std::string& data, uint8_t* channels) {
+    auto* p = reinterpret_cast<const uint8_t*>(data.data());
+    Header header{};
+    if (!readHeader(p, data.size(), header) || header.type != MessageType::DmxDelta) return false;
+
+    size_t pos = HEADER_SIZE;
+    while (pos < data.size()) {
+        if (data.size() - pos < DELTA_RUN_HEADER_SIZE) return false;
+        uint16_t start = static_cast<uint16_t>(p[pos] | (p[pos + 1] << 8));
+        uint16_t count = static_cast<uint16_t>(p[pos + 2] | (p[pos + 3] << 8));
+        pos += DELTA_RUN_HEADER_SIZE;
+        if (start >= 512 || count == 0 || count > 512u - start || data.size() - pos < count) return false;
+        std::memcpy(channels + start, p + pos, count);
+        pos += count;
+    }
+    return true;
+}
+
+bool decodeCommandBatch(const std::string& data, Header& header, ChannelRun* runs,
+                        size_t& count, bool& blackout) {
+    count = 0;
+    blackout = false;
+    auto* p = reinterpret_cast<const uint8_t*>(data.data());
+    if (!readHeader(p, data.size(), header) || header.type != MessageType::CommandBatch) return false;
+
+    auto u16 = [p](size_t at) { return static_cast<uint16_t>(p[at] | (p[at + 1] << 8)); };
+    size_t pos = HEADER_SIZE;
+    while (pos < data.size()) {
+        auto op = static_cast<BatchOp>(p[pos++]);
+        size_t remaining = data.size() - pos;
+        if (op == BatchOp::Blackout) {
+            blackout = true;
+            count = 0;
+        } else if (op == BatchOp::Range) {
+            if (remaining < 6) return false;
+            ChannelRun run{u16(pos), u16(pos + 2), u16(pos + 4), p + pos + 6};
+            if (run.count == 0 || run.start >= 512 || run.count > 512u - run.start) return false;
+            if (remaining - 6 < run.count || count == MAX_BATCH_RUNS) return false;
+            runs[count++] = run;
+            pos += 6 + run.count;
+        } else if (op == BatchOp::Sparse) {
+            if (remaining < 4) return false;
+            uint16_t universe = u16(pos);
+            size_t entries = u16(pos + 2);
+            pos += 4;
+            if (entries == 0 || data.size() - pos < entries * 3) return false;
+            if (entries > MAX_BATCH_RUNS - count) return false;
+            for (size_t i = 0; i < entries; ++i, pos += 3) {
+                uint16_t channel = u16(pos);
+                if (channel >= 512) return false;
+                runs[count++] = ChannelRun{universe, channel, 1, p + pos + 2};
+            }
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool decodePixelFrame(const std::string& data, const Header& header, PixelFrame& out) {
+    if (header.type != MessageType::PixelFrame || data.size() < HEADER_SIZE + 4) return false;
+    auto* p = reinterpret_cast<const uint8_t*>(data.data()) + HEADER_SIZE;
+    out.width = static_cast<uint16_t>(p[0] | (p[1] << 8));
+    out.height = static_cast<uint16_t>(p[2] | (p[3] << 8));
+    out.rgba = (header.flags & PIXEL_FLAG_RGBA) != 0;
+    out.pixels = p + 4;
+    size_t expected = size_t{out.width} * out.height * (out.rgba ? 4 : 3);
+    return expected > 0 && data.size() - HEADER_SIZE - 4 == expected;
+}
+
+std::string encodePixelFrame(uint16_t width, uint16_t height, bool rgba, const uint8_t* pixels) {
+    size_t bytes = size_t{width} * height * (rgba ? 4 : 3);
+    std::string out(HEADER_SIZE + 4 + bytes, '\0');
+    auto* p = reinterpret_cast<uint8_t*>(out.data());
+    writeHeader(p, {MessageType::PixelFrame, rgba ? PIXEL_FLAG_RGBA : uint8_t{0}, 0, 0});
+    p[HEADER_SIZE] = static_cast<uint8_t>(width & 0xFF);
+    p[HEADER_SIZE + 1] = static_cast<uint8_t>(width >> 8);
+    p[HEADER_SIZE + 2] = static_cast<uint8_t>(height & 0xFF);
+    p[HEADER_SIZE + 3] = static_cast<uint8_t>(height >> 8);
+    std::memcpy(p + HEADER_SIZE + 4, pixels, bytes);
+    return out;
+}
+
+std::string batchAck(uint32_t seq) {
+    return R"({"seq":)" + std::to_string(seq) + R"(,"type":"ack"})";
+}
+
+std::string batchAck(uint16_t client, uint32_t seq) {
+    return R"({"client":)" + std::to_string(client) + R"(,"seq":)" + std::to_string(seq) + R"(,"type":"ack"})";
+}
+
+std::string helloAck() {
+    return R"({"protocol":"binary","type":"protocol","version":1})";
+}
+
+} // namespace photon::wsproto
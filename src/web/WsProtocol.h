@@ -0,0 +1,123 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "engine/InputCoalescer.h"
+
+namespace photon::wsproto {
+
+// Binary WebSocket frames. A client opts in by sending
+//   {"type":"hello","protocol":"binary"}
+// and the server answers {"type":"protocol","protocol":"binary","version":1}
+// before switching that connection's DMX state to binary frames. Clients that
+// never say hello keep receiving JSON.
+//
+// Every binary frame starts with an 8-byte little-endian header:
+//   u8 type | u8 flags | u16 universe | u32 seq
+//
+//   DmxState    (server→client)  512 channel bytes
+//   SetChannels (client→server)  u16 start channel + 1..512 values
+//   DmxDelta    (relay uplink)   runs of channels changed since the frame
+//                                with seq - 1 for the same universe:
+//                                repeated u16 start | u16 count | values
+//   CommandBatch (client→server) header universe is the origin (the relay's
+//                                id for the sending client, 0 when direct)
+//                                and seq the client's batch number; then ops:
+//       0x01 Range     u16 universe | u16 start | u16 count | values
+//       0x02 Sparse    u16 universe | u16 count | count × (u16 channel, u8 value)
+//       0x03 Blackout
+//     A whole frame is a Range of start 0, count 512. The server answers
+//     {"type":"ack","seq":N} (plus "client" via the relay) for the highest
+//     batch applied, so a client can keep several in flight.
+//   PixelFrame  (client→server)  flags bit 0 set for RGBA, else RGB; then
+//                                u16 width | u16 height | pixels row by row,
+//                                rendered through the pixel map (--pixel-map)
+//
+// On the relay uplink seq counts per universe, and a DmxState is a keyframe
+// that resets it; a client applies a delta only on top of seq - 1.
+
+constexpr uint8_t VERSION = 1;
+constexpr size_t HEADER_SIZE = 8;
+constexpr size_t DMX_STATE_SIZE = HEADER_SIZE + 512;
+
+enum class MessageType : uint8_t {
+    DmxState = 0x01,
+    SetChannels = 0x02,
+    DmxDelta = 0x03,
+    CommandBatch = 0x04,
+    PixelFrame = 0x05,
+};
+
+constexpr uint8_t PIXEL_FLAG_RGBA = 0x01;
+
+constexpr size_t DELTA_RUN_HEADER_SIZE = 4;
+
+enum class BatchOp : uint8_t {
+    Range = 0x01,
+    Sparse = 0x02,
+    Blackout = 0x03,
+};
+
+// Runs a single batch may decode to; every sparse entry is one run
+constexpr size_t MAX_BATCH_RUNS = 1024;
+
+struct Header {
+    MessageType type;
+    uint8_t flags;
+    uint16_t universe;
+    uint32_t seq;
+};
+
+void writeHeader(uint8_t* out, const Header& header);
+bool readHeader(const uint8_t* data, size_t size, Header& header);
+
+// Binary DmxState frame: header + 512 bytes
+std::string encodeDmxState(uint16_t universe, uint32_t seq, const uint8_t* channels);
+
+// JSON dmx_state for clients that did not negotiate binary. Hand-formatted;
+// equivalent to the nlohmann::json dump it replaces.
+std::string encodeDmxStateJson(uint16_t universe, const uint8_t* channels);
+
+struct SetChannels {
+    uint16_t universe{0};
+    uint16_t start{0};
+    uint16_t count{0};
+    const uint8_t* values{nullptr};  // points into the decoded message
+};
+
+// Parses a client SetChannels frame; false if malformed or out of range.
+bool decodeSetChannels(const std::string& data, SetChannels& out);
+
+// Binary DmxDelta frame from `previous` to `current` (512 bytes each). Runs
+// separated by fewer unchanged channels than a run header are merged.
+std::string encodeDmxDelta(uint16_t universe, uint32_t seq,
+                           const uint8_t* previous, const uint8_t* current);
+
+// Applies a DmxDelta frame's runs to `channels`; false if malformed, in which
+// case `channels` may be partly updated.
+bool applyDmxDelta(const std::string& data, uint8_t* channels);
+
+// Decodes a CommandBatch into `runs` (capacity MAX_BATCH_RUNS), whose values
+// point into `data`. Ops apply in order, so writes before a blackout are
+// dropped and `blackout` reports that one must be applied before the runs.
+bool decodeCommandBatch(const std::string& data, Header& header, ChannelRun* runs,
+                        size_t& count, bool& blackout);
+
+struct PixelFrame {
+    uint16_t width{0};
+    uint16_t height{0};
+    bool rgba{false};
+    const uint8_t* pixels{nullptr};  // points into the decoded message
+};
+
+// Parses a PixelFrame after its header; false if the size doesn't match
+bool decodePixelFrame(const std::string& data, const Header& header, PixelFrame& out);
+std::string encodePixelFrame(uint16_t width, uint16_t height, bool rgba, const uint8_t* pixels);
+
+// {"type":"ack","seq":N}, with "client" when acknowledging through the relay
+std::string batchAck(uint32_t seq);
+std::string batchAck(uint16_t client, uint32_t seq);
+
+std::string helloAck();
+
+} // namespace photon::wsproto
@@ -1,6 +1,14 @@
 #include <catch2/catch_test_macros.hpp>
 #include "protocol/ArtNetSender.h"
+#include "protocol/DeviceManager.h"
 #include <cstring>
+#include <set>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
 
 using namespace photon;
 
@@ -46,3 +54,95 @@ TEST_CASE("ArtNetSender send to loopback") {
     sender.send(1, data);
     sender.close();
 }
+
+TEST_CASE("Removing a device keeps a sender shared with other universes open") {
+    DeviceManager devices;
+    auto sender = std::make_shared<ArtNetSender>("127.0.0.1");
+    auto first = devices.addDevice(sender, 0);
+    auto second = devices.addDevice(sender, 1);
+
+    devices.removeDevice(first);
+    REQUIRE(sender->isOpen());
+    REQUIRE(devices.getDevicesForUniverse(0).empty());
+    REQUIRE(devices.getDevicesForUniverse(1).size() == 1);
+
+    devices.removeDevice(second);
+    REQUIRE_FALSE(sender->isOpen());
+}
+
+#ifndef _WIN32
+namespace {
+
+// Bound loopback UDP socket on an ephemeral port
+struct Receiver {
+    int fd{-1};
+    uint16_t port{0};
+
+    Receiver() {
+        fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        socklen_t len = sizeof(addr);
+        ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+        port = ntohs(addr.sin_port);
+        timeval tv{1, 0};
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    }
+    ~Receiver() { ::close(fd); }
+
+    ssize_t recv(uint8_t* buf, size_t len) { return ::recv(fd, buf, len, 0); }
+};
+
+void checkLoopbackDelivery(UdpBackend backend) {
+    Receiver rx;
+    ArtNetSender sender("127.0.0.1", rx.port, backend);
+    REQUIRE(sender.open());
+
+    std::array<uint8_t, 512> data{};
+    data[0] = 255;
+    data[511] = 128;
+    sender.send(3, data);
+    sender.send(258, data);
+    sender.flush();
+
+    // Packets within a tick may leave in any order
+    std::set<uint16_t> universes;
+    for (int i = 0; i < 2; ++i) {
+        uint8_t buf[600];
+        REQUIRE(rx.recv(buf, sizeof(buf)) == 530);
+        REQUIRE(std::memcmp(buf, "Art-Net\0", 8) == 0);
+        REQUIRE(buf[18] == 255);
+        REQUIRE(buf[18 + 511] == 128);
+        universes.insert(static_cast<uint16_t>(buf[14] | (buf[15] << 8)));
+    }
+    REQUIRE(universes == std::set<uint16_t>{3, 258});
+
+    // Completions are reaped on the next flush
+    sender.flush();
+    auto stats = sender.getStats();
+    REQUIRE(stats.packets == 2);
+    REQUIRE(stats.bytes == 2 * 530);
+    REQUIRE(stats.errors == 0);
+    REQUIRE(stats.flushes == 2);
+    sender.close();
+}
+
+} // namespace
+
+TEST_CASE("ArtNetSender socket backend delivers packets") {
+    checkLoopbackDelivery(UdpBackend::Socket);
+}
+
+TEST_CASE("ArtNetSender io_uring backend delivers packets or falls back") {
+    checkLoopbackDelivery(UdpBackend::IoUring);
+}
+
+TEST_CASE("UDP backend names round trip") {
+    REQUIRE(parseUdpBackend("io_uring") == UdpBackend::IoUring);
+    REQUIRE(parseUdpBackend("socket") == UdpBackend::Socket);
+    REQUIRE(parseUdpBackend("bogus") == UdpBackend::Socket);
+    REQUIRE(std::string(udpBackendName(UdpBackend::IoUring)) == "io_uring");
+}
+#endif
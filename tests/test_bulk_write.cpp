@@ -0,0 +1,74 @@
+#include <catch2/catch_test_macros.hpp>
+#include "engine/MergeBuffer.h"
+#include "web/BulkWrite.h"
+#include <array>
+
+using namespace photon;
+
+TEST_CASE("Bulk body decodes full frames and sparse runs in place") {
+    std::array<uint8_t, 512> frame{};
+    for (size_t i = 0; i < frame.size(); ++i) frame[i] = static_cast<uint8_t>(i);
+    const uint8_t sparse[] = {7, 8, 9};
+
+    std::string body;
+    bulk::appendRun(body, 0, 0, frame.data(), 512);
+    bulk::appendRun(body, 3, 100, sparse, 3);
+
+    std::array<ChannelRun, bulk::MAX_RUNS> runs;
+    size_t count = 0;
+    const char* error = nullptr;
+    REQUIRE(bulk::decode(body, runs.data(), count, error));
+    REQUIRE(count == 2);
+    REQUIRE(runs[0].universe == 0);
+    REQUIRE(runs[0].count == 512);
+    REQUIRE(runs[0].values == reinterpret_cast<const uint8_t*>(body.data()) + bulk::RECORD_HEADER_SIZE);
+    REQUIRE(runs[1].universe == 3);
+    REQUIRE(runs[1].start == 100);
+    REQUIRE(runs[1].values[2] == 9);
+}
+
+TEST_CASE("Bulk body rejects malformed records") {
+    std::array<ChannelRun, bulk::MAX_RUNS> runs;
+    size_t count = 0;
+    const char* error = nullptr;
+    const uint8_t values[4] = {1, 2, 3, 4};
+
+    REQUIRE_FALSE(bulk::decode("", runs.data(), count, error));
+
+    std::string body;
+    bulk::appendRun(body, 0, 510, values, 4); // past channel 511
+    REQUIRE_FALSE(bulk::decode(body, runs.data(), count, error));
+
+    body.clear();
+    bulk::appendRun(body, 0, 0, values, 4);
+    body.pop_back();
+    REQUIRE_FALSE(bulk::decode(body, runs.data(), count, error));
+    REQUIRE(std::string(error) == "truncated run");
+}
+
+TEST_CASE("Bulk runs reach the output in one batch") {
+    MergeBuffer mb(4);
+    InputCoalescer input(4);
+
+    std::array<uint8_t, 512> a{}, b{};
+    a.fill(11);
+    b.fill(22);
+    ChannelRun runs[] = {{1, 0, 512, a.data()}, {2, 0, 512, b.data()}};
+    input.pushRuns(runs, 2);
+
+    CoalescedBatch batch;
+    REQUIRE(input.drain(batch));
+    REQUIRE(batch.runs.size() == 2);
+    mb.apply(batch);
+    // One lock, but each written universe still gets its own version stamp
+    REQUIRE(mb.getUniverseVersion(1) > 0);
+    REQUIRE(mb.getUniverseVersion(2) == mb.getVersion());
+    REQUIRE(mb.getUniverseVersion(0) == 0);
+
+    std::vector<std::array<uint8_t, 512>> outputs;
+    REQUIRE(mb.tryGetOutputs(outputs));
+    REQUIRE(outputs.size() == 4);
+    REQUIRE(outputs[1][511] == 11);
+    REQUIRE(outputs[2][0] == 22);
+    REQUIRE(outputs[3][0] == 0);
+}
@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+#include "web/ClientQueue.h"
+
+using namespace photon;
+
+namespace {
+
+ClientQueue::Payload payload(const std::string& s) {
+    return std::make_shared<const std::string>(s);
+}
+
+} // namespace
+
+TEST_CASE("ClientQueue coalesces frames of the same universe") {
+    ClientQueue queue;
+    queue.pushControl("universes");
+    queue.pushFrame(0, payload("u0 old"), false);
+    queue.pushFrame(1, payload("u1"), false);
+    queue.pushFrame(0, payload("u0 new"), false);
+
+    std::vector<ClientQueue::Message> batch;
+    queue.drain(batch);
+    REQUIRE(batch.size() == 3);
+    REQUIRE(*batch[0].payload == "universes");
+    REQUIRE(*batch[1].payload == "u0 new");
+    REQUIRE(*batch[2].payload == "u1");
+
+    auto stats = queue.getStats();
+    REQUIRE(stats.depth == 0);
+    REQUIRE(stats.maxDepth == 3);
+    REQUIRE(stats.sent == 3);
+    REQUIRE(stats.superseded == 1);
+    REQUIRE(stats.dropped == 0);
+}
+
+TEST_CASE("ClientQueue keeps a format switch behind the control message") {
+    ClientQueue queue;
+    queue.pushFrame(2, payload("json"), false);
+    queue.pushControl("hello ack");
+    queue.pushFrame(2, payload("binary"), true);
+
+    std::vector<ClientQueue::Message> batch;
+    queue.drain(batch);
+    REQUIRE(batch.size() == 2);
+    REQUIRE(*batch[0].payload == "hello ack");
+    REQUIRE(*batch[1].payload == "binary");
+    REQUIRE(batch[1].binary);
+}
+
+TEST_CASE("ClientQueue drops the oldest frame when full") {
+    ClientQueue queue(3);
+    queue.pushControl("universes");
+    queue.pushFrame(0, payload("u0"), false);
+    queue.pushFrame(1, payload("u1"), false);
+    queue.pushFrame(2, payload("u2"), false);
+
+    auto stats = queue.getStats();
+    REQUIRE(stats.depth == 3);
+    REQUIRE(stats.dropped == 1);
+
+    // u0 is gone, and a new u0 frame is queued fresh rather than coalesced
+    queue.pushFrame(0, payload("u0 again"), false);
+    std::vector<ClientQueue::Message> batch;
+    queue.drain(batch);
+    REQUIRE(batch.size() == 3);
+    REQUIRE(*batch[0].payload == "universes");
+    REQUIRE(*batch[1].payload == "u2");
+    REQUIRE(*batch[2].payload == "u0 again");
+    REQUIRE(queue.getStats().superseded == 0);
+}
@@ -0,0 +1,110 @@
+#include <catch2/catch_test_macros.hpp>
+#include "engine/Clock.h"
+#include "engine/OutputScheduler.h"
+#include "protocol/DeviceManager.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace photon;
+using namespace std::chrono_literals;
+
+namespace {
+
+class TickRecorder : public FrameObserver {
+public:
+    void onOutputFrame(std::chrono::steady_clock::time_point tick,
+                       const std::vector<std::array<uint8_t, 512>>& frames) override {
+        if (count > 0) {
+            auto gap = tick - last;
+            minGap = count == 1 ? gap : std::min(minGap, gap);
+            maxGap = count == 1 ? gap : std::max(maxGap, gap);
+        }
+        last = tick;
+        lastValue = frames.empty() ? 0 : frames[0][0];
+        ++count;
+    }
+
+    uint64_t count{0};
+    Clock::time_point last{};
+    Clock::duration minGap{};
+    Clock::duration maxGap{};
+    uint8_t lastValue{0};
+};
+
+} // namespace
+
+TEST_CASE("SimulatedClock releases sleepers in deadline order") {
+    SimulatedClock clock;
+    auto start = clock.now();
+    std::atomic<bool> running{true};
+    std::vector<int> order;
+    std::mutex orderMutex;
+
+    auto loop = [&](int id, Clock::duration period) {
+        auto next = clock.now();
+        while (running.load()) {
+            next += period;
+            clock.sleepUntil(next, running);
+            if (!running.load()) break;
+            std::lock_guard lock(orderMutex);
+            order.push_back(id);
+        }
+    };
+    std::thread fast(loop, 1, 10ms);
+    std::thread slow(loop, 2, 25ms);
+    REQUIRE(clock.waitForSleepers(2));
+
+    clock.advance(50ms);
+    REQUIRE(clock.now() == start + 50ms);
+    // 10, 20, 25, 30, 40, 50 (both due at 50 ms, in either order)
+    REQUIRE(order.size() == 7);
+    REQUIRE(std::vector<int>(order.begin(), order.begin() + 5) == std::vector<int>{1, 1, 2, 1, 1});
+
+    // Nothing runs until time moves
+    REQUIRE(clock.waitForSleepers(2));
+    REQUIRE(order.size() == 7);
+
+    running.store(false);
+    clock.wake();
+    fast.join();
+    slow.join();
+}
+
+TEST_CASE("Output scheduler runs ten minutes of show time exactly") {
+    SimulatedClock clock;
+    MergeBuffer buffer(2);
+    DeviceManager devices;
+    TickRecorder recorder;
+    OutputScheduler scheduler(buffer, devices, clock);
+    scheduler.addObserver(&recorder);
+
+    scheduler.start();
+    REQUIRE(clock.waitForSleepers(1));
+    REQUIRE(recorder.count == 1); // the first tick is due immediately
+
+    auto interval = std::chrono::microseconds(static_cast<long>(1'000'000.0 / OutputScheduler::DEFAULT_REFRESH_HZ));
+    clock.advance(10min);
+    REQUIRE(recorder.count == 1 + static_cast<uint64_t>(10min / interval));
+    REQUIRE(recorder.minGap == interval);
+    REQUIRE(recorder.maxGap == interval);
+
+    // Writes show up on the next tick, never earlier
+    buffer.setValue(0, 0, 77, SourcePriority::Programmer);
+    REQUIRE(recorder.lastValue == 0);
+    clock.advance(interval);
+    REQUIRE(recorder.lastValue == 77);
+
+    // A new rate takes effect after the tick already scheduled
+    auto before = recorder.count;
+    scheduler.setRefreshRate(10.0);
+    clock.advance(interval + 1s);
+    REQUIRE(recorder.count == before + 1 + 10);
+    REQUIRE(recorder.maxGap == 100ms);
+
+    scheduler.stop();
+    scheduler.removeObserver(&recorder);
+}
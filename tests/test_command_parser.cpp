@@ -0,0 +1,104 @@
+#include <catch2/catch_test_macros.hpp>
+#include "engine/CommandParser.h"
+
+using namespace photon;
+
+namespace {
+
+std::vector<action::SetChannel> setChannels(InputCoalescer& input) {
+    std::vector<action::SetChannel> result;
+    CoalescedBatch batch;
+    input.drain(batch);
+    for (const auto& run : batch.runs) {
+        for (uint32_t i = run.offset; i < run.offset + run.count; ++i) {
+            result.push_back(action::SetChannel{run.universe, batch.channels[i], batch.values[i], run.source});
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Command parser handles set_channel in any key order") {
+    InputCoalescer input(8);
+    REQUIRE(command::parse(R"({"type":"set_channel","universe":2,"channel":17,"value":255})", input)
+            == command::Type::SetChannel);
+    REQUIRE(command::parse(R"( { "value" : 0 , "channel":3, "universe":1, "type" : "set_channel" } )", input)
+            == command::Type::SetChannel);
+
+    auto actions = setChannels(input);
+    REQUIRE(actions.size() == 2);
+    REQUIRE(actions[0].universe == 2);
+    REQUIRE(actions[0].channel == 17);
+    REQUIRE(actions[0].value == 255);
+    REQUIRE(actions[1].universe == 1);
+    REQUIRE(actions[1].channel == 3);
+    REQUIRE(actions[1].value == 0);
+}
+
+TEST_CASE("Command parser handles set_channels and blackout") {
+    InputCoalescer input(8);
+    REQUIRE(command::parse(R"({"type":"set_channels","channels":[[0,10],[1,20],[511,30]],"universe":3})", input)
+            == command::Type::SetChannels);
+    auto actions = setChannels(input);
+    REQUIRE(actions.size() == 3);
+    REQUIRE(actions[2].universe == 3);
+    REQUIRE(actions[2].channel == 511);
+    REQUIRE(actions[2].value == 30);
+
+    REQUIRE(command::parse(R"({"type":"blackout"})", input) == command::Type::Blackout);
+    CoalescedBatch batch;
+    REQUIRE(input.drain(batch));
+    REQUIRE(batch.blackout);
+    REQUIRE(batch.runs.empty());
+}
+
+TEST_CASE("Command parser leaves everything else to the DOM parser") {
+    InputCoalescer input(8);
+    const char* fallbacks[] = {
+        R"({"type":"subscribe","universes":[0,1]})",
+        R"({"type":"hello","protocol":"binary"})",
+        R"({"type":"set_channel","universe":0,"channel":1,"value":300})",
+        R"({"type":"set_channel","universe":0,"channel":1,"value":1.0})",
+        R"({"type":"set_channel","universe":-1,"channel":1,"value":1})",
+        R"({"type":"set_channel","universe":0,"channel":1})",
+        R"({"type":"set_channel","universe":0,"channel":1,"value":1)",
+        R"({"type":"blackout"} trailing)",
+        R"([1,2,3])",
+        "",
+    };
+    for (const char* msg : fallbacks) {
+        INFO(msg);
+        REQUIRE(command::parse(msg, input) == command::Type::None);
+    }
+    // Nothing is queued for a message that is not handled
+    REQUIRE(input.empty());
+
+    // Unknown members are skipped, including nested values and escapes
+    REQUIRE(command::parse(R"({"type":"blackout","meta":{"src":"fader \"A\"","tags":[1,{"x":null}]},"ok":true})", input)
+            == command::Type::Blackout);
+}
+
+TEST_CASE("Relay envelopes and REST bodies") {
+    InputCoalescer input(8);
+    REQUIRE(command::parseRelayCommand(
+                R"({"data":{"type":"set_channel","universe":0,"channel":9,"value":42},"type":"command"})", input)
+            == command::Type::SetChannel);
+    REQUIRE(command::parseRelayCommand(R"({"type":"auth_ack","instanceId":"abc"})", input) == command::Type::None);
+    REQUIRE(command::parseRelayCommand(R"({"type":"set_channel","universe":0,"channel":9,"value":42})", input)
+            == command::Type::None);
+
+    uint8_t value = 0;
+    REQUIRE(command::parseChannelValue(R"({"value":128})", value));
+    REQUIRE(value == 128);
+    REQUIRE_FALSE(command::parseChannelValue(R"({"value":"128"})", value));
+
+    REQUIRE(command::parseChannelMap(R"({"channels":{"0":255,"12":7}})", 5, input));
+    auto actions = setChannels(input);
+    REQUIRE(actions.size() == 3);
+    REQUIRE(actions[0].channel == 9);
+    REQUIRE(actions[2].universe == 5);
+    REQUIRE(actions[2].channel == 12);
+    REQUIRE(actions[2].value == 7);
+    REQUIRE_FALSE(command::parseChannelMap(R"({"channels":{"x":1}})", 5, input));
+}
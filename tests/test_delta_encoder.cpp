@@ -0,0 +1,82 @@
+#include <catch2/catch_test_macros.hpp>
+#include "relay/DeltaEncoder.h"
+#include "web/WsProtocol.h"
+#include <array>
+#include <cstring>
+
+using namespace photon;
+using namespace std::chrono_literals;
+
+namespace {
+
+wsproto::Header headerOf(const std::string& frame) {
+    wsproto::Header header{};
+    wsproto::readHeader(reinterpret_cast<const uint8_t*>(frame.data()), frame.size(), header);
+    return header;
+}
+
+} // namespace
+
+TEST_CASE("DeltaEncoder starts with a keyframe, then sends deltas") {
+    DeltaEncoder encoder(2s);
+    auto t = DeltaEncoder::Clock::now();
+    std::array<uint8_t, 512> channels{};
+    channels[0] = 10;
+
+    auto first = encoder.encode(3, channels.data(), t);
+    REQUIRE(first.size() == wsproto::DMX_STATE_SIZE);
+    REQUIRE(headerOf(first).type == wsproto::MessageType::DmxState);
+    REQUIRE(headerOf(first).seq == 1);
+
+    // No change, no keyframe due: nothing to send
+    REQUIRE(encoder.encode(3, channels.data(), t + 100ms).empty());
+
+    channels[7] = 99;
+    auto delta = encoder.encode(3, channels.data(), t + 200ms);
+    REQUIRE(headerOf(delta).type == wsproto::MessageType::DmxDelta);
+    REQUIRE(headerOf(delta).seq == 2);
+    REQUIRE(delta.size() == wsproto::HEADER_SIZE + wsproto::DELTA_RUN_HEADER_SIZE + 1);
+
+    // A receiver that applies the stream ends up with the same channels
+    std::array<uint8_t, 512> received{};
+    std::memcpy(received.data(), first.data() + wsproto::HEADER_SIZE, 512);
+    REQUIRE(wsproto::applyDmxDelta(delta, received.data()));
+    REQUIRE(received == channels);
+
+    auto stats = encoder.getStats();
+    REQUIRE(stats.keyframes == 1);
+    REQUIRE(stats.deltas == 1);
+    REQUIRE(stats.bytes == first.size() + delta.size());
+}
+
+TEST_CASE("DeltaEncoder sends periodic keyframes and resyncs after reset") {
+    DeltaEncoder encoder(2s);
+    auto t = DeltaEncoder::Clock::now();
+    std::array<uint8_t, 512> channels{};
+
+    encoder.encode(0, channels.data(), t);
+    channels[1] = 1;
+    REQUIRE(headerOf(encoder.encode(0, channels.data(), t + 1s)).type == wsproto::MessageType::DmxDelta);
+    channels[1] = 2;
+    auto periodic = encoder.encode(0, channels.data(), t + 2s);
+    REQUIRE(headerOf(periodic).type == wsproto::MessageType::DmxState);
+    REQUIRE(headerOf(periodic).seq == 3);
+
+    encoder.reset();
+    channels[1] = 3;
+    REQUIRE(headerOf(encoder.encode(0, channels.data(), t + 2500ms)).type == wsproto::MessageType::DmxState);
+}
+
+TEST_CASE("DeltaEncoder falls back to a keyframe when a delta is no smaller") {
+    DeltaEncoder encoder(10s);
+    auto t = DeltaEncoder::Clock::now();
+    std::array<uint8_t, 512> channels{};
+    encoder.encode(1, channels.data(), t);
+
+    // Every other channel changes: runs merge into one full-universe run,
+    // which is larger than a keyframe
+    for (size_t i = 0; i < 512; i += 2) channels[i] = 255;
+    auto frame = encoder.encode(1, channels.data(), t + 100ms);
+    REQUIRE(headerOf(frame).type == wsproto::MessageType::DmxState);
+    REQUIRE(headerOf(frame).seq == 2);
+}
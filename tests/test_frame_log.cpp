@@ -0,0 +1,148 @@
+#include <catch2/catch_test_macros.hpp>
+#include "engine/Clock.h"
+#include "show/FrameLog.h"
+#include "show/ShowPlayer.h"
+#include "show/ShowRecorder.h"
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+
+using namespace photon;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::string tempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+void recordTicks(const std::string& path, uint16_t universes, int ticks, uint32_t keyframeInterval) {
+    ShowRecorder recorder;
+    REQUIRE(recorder.start(path, universes, keyframeInterval));
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::array<uint8_t, 512>> frames(universes);
+    for (int t = 0; t < ticks; ++t) {
+        frames[0][t % 512] = static_cast<uint8_t>(t + 1);
+        recorder.onOutputFrame(t0 + std::chrono::milliseconds(10 * t), frames);
+    }
+    recorder.stop();
+}
+
+} // namespace
+
+TEST_CASE("ShowRecorder encodes only changed runs") {
+    std::vector<std::array<uint8_t, 512>> prev(2), cur(2);
+    cur[1][10] = 1;
+    cur[1][12] = 2;   // merged into the run starting at 10
+    cur[1][300] = 3;
+
+    std::vector<uint8_t> out;
+    REQUIRE(ShowRecorder::encodeTick(0, false, cur, prev, out));
+
+    auto* tick = reinterpret_cast<const framelog::TickHeader*>(out.data());
+    REQUIRE(tick->universeCount == 1);
+    REQUIRE(tick->size == out.size());
+    REQUIRE(out.size() % 8 == 0);
+    REQUIRE(out.size() < 64);
+
+    std::vector<uint8_t> empty;
+    REQUIRE_FALSE(ShowRecorder::encodeTick(0, false, prev, prev, empty));
+    REQUIRE(empty.empty());
+}
+
+TEST_CASE("FrameLog round trip reconstructs every tick") {
+    auto path = tempPath("photon_test_roundtrip.phr");
+    recordTicks(path, 3, 50, 10);
+
+    FrameLogReader reader;
+    REQUIRE(reader.open(path));
+    REQUIRE(reader.getUniverseCount() == 3);
+    REQUIRE(reader.getKeyframeCount() == 5);
+    REQUIRE(reader.getDurationUs() == 490'000);
+
+    std::vector<std::array<uint8_t, 512>> frames(3);
+    int ticks = 0;
+    for (size_t off = reader.firstTick(); auto* tick = reader.tickAt(off); off = reader.nextTick(off)) {
+        reader.applyTick(tick, frames);
+        ++ticks;
+        REQUIRE(frames[0][(ticks - 1) % 512] == ticks);
+    }
+    REQUIRE(ticks == 50);
+
+    reader.close();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("FrameLog rebuilds an index whose bounds are corrupt") {
+    auto path = tempPath("photon_test_corrupt_index.phr");
+    recordTicks(path, 1, 30, 10);
+    {
+        // A count large enough to wrap indexOffset + count * entry size
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        uint64_t count = UINT64_MAX / 2;
+        file.seekp(offsetof(framelog::FrameLogHeader, indexCount));
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    }
+
+    FrameLogReader reader;
+    REQUIRE(reader.open(path));
+    REQUIRE(reader.getKeyframeCount() == 3);
+    REQUIRE(reader.tickAt(reader.seekKeyframe(250'000))->timestampUs == 200'000);
+
+    reader.close();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("ShowPlayer seek restores state from nearest keyframe") {
+    auto path = tempPath("photon_test_seek.phr");
+    recordTicks(path, 2, 40, 8);
+
+    MergeBuffer mb(2);
+    ShowPlayer player(mb);
+    REQUIRE(player.open(path));
+
+    player.seek(255'000); // tick 25 was recorded at 250 ms
+    auto out = mb.getOutput(0);
+    for (int t = 0; t <= 25; ++t) REQUIRE(out[t] == t + 1);
+    REQUIRE(out[26] == 0);
+    REQUIRE(player.getPositionUs() == 255'000);
+
+    // Lower priority planes are untouched; higher ones still win
+    mb.setValue(0, 0, 200, SourcePriority::Programmer);
+    REQUIRE(mb.getOutput(0)[0] == 200);
+
+    player.close();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("ShowPlayer plays recording into its priority plane") {
+    auto path = tempPath("photon_test_play.phr");
+    recordTicks(path, 1, 5, 88);
+
+    SimulatedClock clock;
+    MergeBuffer mb(1);
+    ShowPlayer player(mb, SourcePriority::CuePlayback, clock);
+    REQUIRE(player.open(path));
+    player.start();
+
+    // Ticks were recorded 10 ms apart; the first plays straight away
+    REQUIRE(clock.waitForSleepers(1));
+    REQUIRE(mb.getOutput(0)[0] == 1);
+    REQUIRE(mb.getOutput(0)[1] == 0);
+    clock.advance(25ms);
+    REQUIRE(player.getPositionUs() == 20'000);
+    REQUIRE(mb.getOutput(0)[2] == 3);
+    REQUIRE(mb.getOutput(0)[3] == 0);
+
+    clock.advance(15ms);
+    REQUIRE(player.getPositionUs() == 40'000);
+    auto out = mb.getOutput(0);
+    for (int t = 0; t < 5; ++t) REQUIRE(out[t] == t + 1);
+    REQUIRE_FALSE(player.isPlaying());
+
+    player.stop();
+    REQUIRE(mb.getOutput(0)[0] == 0);
+    std::filesystem::remove(path);
+}
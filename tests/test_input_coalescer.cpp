@@ -0,0 +1,91 @@
+#include <catch2/catch_test_macros.hpp>
+#include "engine/InputCoalescer.h"
+
+using namespace photon;
+
+TEST_CASE("InputCoalescer keeps the last value per channel") {
+    InputCoalescer input(2);
+    // A fader drag: many writes to the same channel between engine iterations
+    for (int v = 0; v <= 200; ++v) {
+        input.push(action::SetChannel{0, 10, static_cast<uint8_t>(v)});
+    }
+    input.push(action::SetChannel{0, 3, 7});
+    input.push(action::SetChannel{1, 10, 99});
+
+    auto stats = input.getStats();
+    REQUIRE(stats.writes == 203);
+    REQUIRE(stats.coalesced == 200);
+    REQUIRE(stats.pending == 3);
+
+    CoalescedBatch batch;
+    REQUIRE(input.drain(batch));
+    REQUIRE_FALSE(batch.blackout);
+    REQUIRE(batch.runs.size() == 2);
+
+    const auto& first = batch.runs[0];
+    REQUIRE(first.universe == 0);
+    REQUIRE(first.source == SourcePriority::Programmer);
+    REQUIRE(first.count == 2);
+    REQUIRE(batch.channels[first.offset] == 10);
+    REQUIRE(batch.values[first.offset] == 200);
+    REQUIRE(batch.channels[first.offset + 1] == 3);
+    REQUIRE(batch.values[first.offset + 1] == 7);
+
+    const auto& second = batch.runs[1];
+    REQUIRE(second.universe == 1);
+    REQUIRE(second.count == 1);
+    REQUIRE(batch.values[second.offset] == 99);
+
+    REQUIRE(input.empty());
+    REQUIRE_FALSE(input.drain(batch));
+}
+
+TEST_CASE("InputCoalescer keys writes by source") {
+    InputCoalescer input(1);
+    input.push(action::SetChannel{0, 1, 10, SourcePriority::Programmer});
+    input.push(action::SetChannel{0, 1, 20, SourcePriority::Effect});
+
+    CoalescedBatch batch;
+    REQUIRE(input.drain(batch));
+    REQUIRE(batch.runs.size() == 2);
+    REQUIRE(batch.runs[0].source == SourcePriority::Programmer);
+    REQUIRE(batch.values[batch.runs[0].offset] == 10);
+    REQUIRE(batch.runs[1].source == SourcePriority::Effect);
+    REQUIRE(batch.values[batch.runs[1].offset] == 20);
+}
+
+TEST_CASE("InputCoalescer blackout discards earlier writes only") {
+    InputCoalescer input(1);
+    input.push(action::SetChannel{0, 1, 10});
+    input.push(action::Blackout{});
+    input.push(action::SetChannel{0, 2, 20});
+    // Out-of-range writes are ignored
+    input.push(action::SetChannel{4, 2, 20});
+    input.push(action::SetChannel{0, 600, 20});
+
+    CoalescedBatch batch;
+    REQUIRE(input.drain(batch));
+    REQUIRE(batch.blackout);
+    REQUIRE(batch.runs.size() == 1);
+    REQUIRE(batch.runs[0].count == 1);
+    REQUIRE(batch.channels[0] == 2);
+    REQUIRE(batch.values[0] == 20);
+    REQUIRE(input.getStats().writes == 2);
+}
+
+TEST_CASE("InputCoalescer applies a leading blackout with its runs") {
+    InputCoalescer input(2);
+    input.push(action::SetChannel{1, 5, 99});
+
+    const uint8_t values[] = {1, 2, 3};
+    ChannelRun runs[] = {{0, 10, 3, values}, {1, 0, 1, values + 2}};
+    input.pushRuns(runs, 2, true);
+
+    CoalescedBatch batch;
+    REQUIRE(input.drain(batch));
+    REQUIRE(batch.blackout);
+    // The write queued before the blackout is gone; the runs survive it
+    REQUIRE(batch.runs.size() == 2);
+    REQUIRE(batch.channels.size() == 4);
+    REQUIRE(batch.values[3] == 3);
+}
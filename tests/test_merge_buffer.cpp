@@ -62,3 +62,38 @@ TEST_CASE("MergeBuffer out-of-range universe returns zeros") {
     auto output = mb.getOutput(99);
     for (auto v : output) REQUIRE(v == 0);
 }
+
+TEST_CASE("MergeBuffer versions track writes per universe") {
+    MergeBuffer mb(3);
+    REQUIRE(mb.getVersion() == 0);
+
+    mb.setValue(1, 0, 10, SourcePriority::Programmer);
+    uint64_t v1 = mb.getUniverseVersion(1);
+    REQUIRE(v1 == mb.getVersion());
+    REQUIRE(mb.getUniverseVersion(0) == 0);
+
+    mb.setValue(2, 0, 20, SourcePriority::Programmer);
+    REQUIRE(mb.getUniverseVersion(2) > v1);
+    REQUIRE(mb.getUniverseVersion(1) == v1);
+
+    std::array<uint8_t, 512> out;
+    REQUIRE(mb.getOutput(1, out) == v1);
+    REQUIRE(out[0] == 10);
+
+    mb.blackout();
+    for (uint16_t u = 0; u < 3; ++u) REQUIRE(mb.getUniverseVersion(u) == mb.getVersion());
+}
+
+TEST_CASE("MergeBuffer setChannels writes sparse channels with one version bump") {
+    MergeBuffer mb(2);
+    const uint16_t channels[] = {0, 100, 511, 600};
+    const uint8_t values[] = {1, 2, 3, 4};
+    mb.setChannels(1, channels, values, 4, SourcePriority::Programmer);
+
+    REQUIRE(mb.getVersion() == 1);
+    REQUIRE(mb.getUniverseVersion(1) == 1);
+    auto out = mb.getOutput(1);
+    REQUIRE(out[0] == 1);
+    REQUIRE(out[100] == 2);
+    REQUIRE(out[511] == 3);
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+#include "metrics/Metrics.h"
+#include <thread>
+#include <vector>
+
+using namespace photon;
+
+TEST_CASE("Counter and gauge render in Prometheus text format") {
+    metrics::Counter counter{"test_events_total", "Events seen"};
+    metrics::Gauge gauge{"test_depth", "Current depth"};
+    counter.inc();
+    counter.inc(4);
+    gauge.set(7);
+    gauge.add(-2);
+
+    auto text = metrics::registry().render();
+    REQUIRE(text.find("# HELP test_events_total Events seen\n# TYPE test_events_total counter\n"
+                      "test_events_total 5\n") != std::string::npos);
+    REQUIRE(text.find("# TYPE test_depth gauge\ntest_depth 5\n") != std::string::npos);
+}
+
+TEST_CASE("Histogram buckets are cumulative with a +Inf bucket") {
+    metrics::Histogram hist{"test_latency_seconds", "Latency", {0.01, 0.001, 0.1}};
+    REQUIRE(hist.bounds() == std::vector<double>{0.001, 0.01, 0.1});
+
+    hist.observe(0.0005);
+    hist.observe(0.001); // upper bounds are inclusive
+    hist.observe(0.05);
+    hist.observe(5.0);
+    REQUIRE(hist.count() == 4);
+    REQUIRE(hist.bucket(0) == 2);
+    REQUIRE(hist.bucket(3) == 1);
+
+    auto text = metrics::registry().render();
+    REQUIRE(text.find("test_latency_seconds_bucket{le=\"0.001\"} 2\n"
+                      "test_latency_seconds_bucket{le=\"0.01\"} 2\n"
+                      "test_latency_seconds_bucket{le=\"0.1\"} 3\n"
+                      "test_latency_seconds_bucket{le=\"+Inf\"} 4\n") != std::string::npos);
+    REQUIRE(text.find("test_latency_seconds_count 4\n") != std::string::npos);
+}
+
+TEST_CASE("Instruments unregister when destroyed") {
+    {
+        metrics::Counter scoped{"test_scoped_total", "Scoped"};
+        REQUIRE(metrics::registry().render().find("test_scoped_total") != std::string::npos);
+    }
+    REQUIRE(metrics::registry().render().find("test_scoped_total") == std::string::npos);
+}
+
+TEST_CASE("Collectors add labelled samples until removed") {
+    int id = metrics::registry().addCollector([](std::string& out) {
+        metrics::writeHeader(out, "test_device_packets_total", "Packets", "counter");
+        metrics::writeSample(out, "test_device_packets_total",
+                             metrics::label("device", "Art-Net \"main\""), 42);
+    });
+    auto text = metrics::registry().render();
+    REQUIRE(text.find("test_device_packets_total{device=\"Art-Net \\\"main\\\"\"} 42\n") != std::string::npos);
+
+    metrics::registry().removeCollector(id);
+    REQUIRE(metrics::registry().render().find("test_device_packets_total") == std::string::npos);
+}
+
+TEST_CASE("Counters and histograms lose no samples across threads") {
+    metrics::Counter counter{"test_concurrent_total", "Concurrent"};
+    metrics::Histogram hist{"test_concurrent_seconds", "Concurrent", {0.5}};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 20; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 2000; ++i) {
+                counter.inc();
+                hist.observe(t % 2 ? 1.0 : 0.25);
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    REQUIRE(counter.value() == 40000);
+    REQUIRE(hist.count() == 40000);
+    REQUIRE(hist.bucket(0) == 20000);
+    REQUIRE(hist.bucket(1) == 20000);
+    REQUIRE(hist.sum() == 25000.0);
+}
@@ -0,0 +1,181 @@
+#include <catch2/catch_test_macros.hpp>
+#include "engine/Clock.h"
+#include "pixel/PixelMap.h"
+#include "pixel/PixelMapper.h"
+#include "pixel/PixelSource.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace photon;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::string tempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+PixelMap stripMap(uint16_t width, uint16_t height, std::vector<PixelStrip> strips, uint16_t universes = 4) {
+    PixelMap map;
+    REQUIRE(map.compile(width, height, strips, universes));
+    return map;
+}
+
+} // namespace
+
+TEST_CASE("Color orders parse by name") {
+    ColorOrder order{};
+    REQUIRE(pixelmap::parseOrder("grb", order));
+    REQUIRE(order == ColorOrder::GRB);
+    REQUIRE(pixelmap::parseOrder("RGBW", order));
+    REQUIRE(pixelmap::channelsPerPixel(order) == 4);
+    REQUIRE(std::string(pixelmap::orderName(ColorOrder::BGR)) == "BGR");
+    REQUIRE_FALSE(pixelmap::parseOrder("RGBA", order));
+}
+
+TEST_CASE("Strips split at universe boundaries and merge when cabled back to back") {
+    auto map = stripMap(200, 2, {{0, 0, 1, 0, 200, 0, 0, ColorOrder::RGB}});
+    // 170 whole pixels fill universe 0; the rest start universe 1
+    REQUIRE(map.segments().size() == 2);
+    REQUIRE(map.segments()[0].pixels == 170);
+    REQUIRE(map.segments()[1].source == 170);
+    REQUIRE(map.runs().size() == 2);
+    REQUIRE(map.runs()[0].count == 510);
+    REQUIRE(map.runs()[1].universe == 1);
+    REQUIRE(map.runs()[1].channel == 0);
+    REQUIRE(map.universesUsed() == 2);
+    REQUIRE(map.channelCount() == 600);
+
+    // A serpentine: row 1 runs right to left and continues the same universe
+    auto snake = stripMap(3, 2, {{0, 0, 1, 0, 3, 2, 0, ColorOrder::RGB},
+                                 {2, 1, -1, 0, 3, 2, 9, ColorOrder::RGB}});
+    REQUIRE(snake.segments()[1].source == 5);
+    REQUIRE(snake.segments()[1].step == -1);
+    REQUIRE(snake.runs().size() == 1);
+    REQUIRE(snake.runs()[0].count == 18);
+
+    PixelMap bad;
+    REQUIRE_FALSE(bad.compile(3, 2, {{1, 0, 1, 0, 3, 0, 0, ColorOrder::RGB}}, 4));
+    REQUIRE_FALSE(bad.compile(3, 2, {{2, 0, 0, 1, 3, 0, 0, ColorOrder::RGB}}, 4));
+    REQUIRE_FALSE(bad.compile(200, 1, {{0, 0, 1, 0, 200, 3, 0, ColorOrder::RGB}}, 4));
+    REQUIRE_FALSE(bad.parse(R"({"width":2,"height":1,"strips":[{"x":0,"y":0,"count":2,"universe":0,"order":"XYZ"}]})", 4));
+    REQUIRE(bad.parse(R"({"width":2,"height":1,"strips":[{"x":0,"y":0,"count":2,"universe":1,"channel":3,"order":"GRBW"}]})", 4));
+    REQUIRE(bad.runs()[0].channel == 3);
+    REQUIRE(bad.runs()[0].count == 8);
+}
+
+TEST_CASE("Pixel frames render into the merge buffer in fixture order") {
+    MergeBuffer buffer(2);
+    PixelMapper mapper(buffer);
+    mapper.setMap(stripMap(3, 1, {{0, 0, 1, 0, 1, 0, 0, ColorOrder::GRB},
+                                  {1, 0, 1, 0, 1, 0, 3, ColorOrder::RGBW},
+                                  {2, 0, 1, 0, 1, 1, 100, ColorOrder::BGR}}, 2));
+
+    std::vector<uint8_t> rgb = {10, 20, 30, 100, 150, 50, 1, 2, 3};
+    REQUIRE(mapper.render(rgb.data(), 3, 1, PixelFormat::RGB));
+    auto u0 = buffer.getOutput(0);
+    REQUIRE(std::vector<uint8_t>(u0.begin(), u0.begin() + 7) == std::vector<uint8_t>{20, 10, 30, 50, 100, 0, 50});
+    auto u1 = buffer.getOutput(1);
+    REQUIRE(std::vector<uint8_t>(u1.begin() + 100, u1.begin() + 103) == std::vector<uint8_t>{3, 2, 1});
+
+    // Alpha dims the pixel
+    std::vector<uint8_t> rgba = {200, 0, 255, 128, 0, 0, 0, 255, 0, 0, 0, 0};
+    REQUIRE(mapper.render(rgba.data(), 3, 1, PixelFormat::RGBA));
+    u0 = buffer.getOutput(0);
+    REQUIRE(u0[0] == 0);
+    REQUIRE(u0[1] == 100);
+    REQUIRE(u0[2] == 128);
+
+    // Pixels sit on the Effect plane, under the programmer
+    buffer.setValue(0, 1, 7, SourcePriority::Programmer);
+    REQUIRE(buffer.getOutput(0)[1] == 7);
+
+    REQUIRE_FALSE(mapper.render(rgb.data(), 1, 3, PixelFormat::RGB));
+    REQUIRE(mapper.getStats().frames == 2);
+    REQUIRE(mapper.getStats().rejected == 1);
+}
+
+#ifndef _WIN32
+
+TEST_CASE("A pixel file plays at the requested rate and loops") {
+    auto path = tempPath("photon_test_pixels.rgb");
+    {
+        std::ofstream file(path, std::ios::binary);
+        const uint8_t frames[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+        file.write(reinterpret_cast<const char*>(frames), sizeof(frames));
+    }
+
+    SimulatedClock clock;
+    MergeBuffer buffer(1);
+    PixelMapper mapper(buffer);
+    mapper.setMap(stripMap(2, 1, {{0, 0, 1, 0, 2, 0, 0, ColorOrder::RGB}}, 1));
+    PixelSource source(mapper, clock);
+    REQUIRE(source.startStream(path, 10.0));
+
+    // The first frame renders straight away, the next one 100 ms later
+    REQUIRE(clock.waitForSleepers(1));
+    REQUIRE(buffer.getOutput(0)[0] == 1);
+    clock.advance(100ms);
+    REQUIRE(buffer.getOutput(0)[0] == 7);
+    clock.advance(100ms);
+    REQUIRE(buffer.getOutput(0)[0] == 1);
+    REQUIRE(mapper.getStats().frames == 3);
+
+    source.stop();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Shared-memory frames render once per completed sequence") {
+    std::string name = "/photon_test_pixels_" + std::to_string(::getpid());
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+    REQUIRE(fd >= 0);
+    size_t size = pixelshm::HEADER_SIZE + 2 * 1 * 4;
+    REQUIRE(::ftruncate(fd, static_cast<off_t>(size)) == 0);
+    auto* base = static_cast<uint8_t*>(::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    ::close(fd);
+    REQUIRE(base != MAP_FAILED);
+
+    std::memcpy(base, pixelshm::MAGIC, sizeof(pixelshm::MAGIC));
+    const uint32_t header[] = {2, 1, 4, 0};
+    std::memcpy(base + 8, header, sizeof(header));
+    auto* sequence = reinterpret_cast<std::atomic<uint64_t>*>(base + pixelshm::SEQUENCE_OFFSET);
+    const uint8_t first[] = {40, 0, 0, 255, 0, 0, 0, 255};
+    std::memcpy(base + pixelshm::HEADER_SIZE, first, sizeof(first));
+    sequence->store(2);
+
+    SimulatedClock clock;
+    MergeBuffer buffer(1);
+    PixelMapper mapper(buffer);
+    mapper.setMap(stripMap(2, 1, {{0, 0, 1, 0, 2, 0, 0, ColorOrder::RGB}}, 1));
+    PixelSource source(mapper, clock);
+    REQUIRE(source.startSharedMemory(name, 50.0));
+    REQUIRE(clock.waitForSleepers(1));
+    REQUIRE(buffer.getOutput(0)[0] == 40);
+
+    // Half-written frames are skipped; an unchanged sequence isn't re-rendered
+    sequence->store(3);
+    base[pixelshm::HEADER_SIZE] = 41;
+    clock.advance(20ms);
+    REQUIRE(buffer.getOutput(0)[0] == 40);
+    sequence->store(4);
+    clock.advance(20ms);
+    REQUIRE(buffer.getOutput(0)[0] == 41);
+    clock.advance(20ms);
+    REQUIRE(mapper.getStats().frames == 2);
+
+    source.stop();
+    ::munmap(base, size);
+    ::shm_unlink(name.c_str());
+}
+
+#endif
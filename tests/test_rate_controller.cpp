@@ -0,0 +1,38 @@
+#include <catch2/catch_test_macros.hpp>
+#include "web/RateController.h"
+
+using namespace photon;
+using namespace std::chrono_literals;
+
+TEST_CASE("RateController paces updates at its current rate") {
+    RateController rc({2.0, 60.0, 10.0});
+    auto t = RateController::Clock::now();
+    REQUIRE(rc.due(t));
+    REQUIRE_FALSE(rc.due(t + 50ms));
+    REQUIRE(rc.due(t + 100ms));
+    // A long stall yields one update, not a burst of catch-up sends
+    REQUIRE(rc.due(t + 2s));
+    REQUIRE_FALSE(rc.due(t + 2s + 10ms));
+}
+
+TEST_CASE("RateController backs off under congestion and recovers") {
+    RateController rc({2.0, 60.0, 16.0, 5.0, 500ms});
+    auto t = RateController::Clock::now();
+
+    rc.sample(t, true);
+    REQUIRE(rc.rateHz() == 8.0);
+    // Within the hold-off a second congested sample changes nothing
+    rc.sample(t + 100ms, true);
+    REQUIRE(rc.rateHz() == 8.0);
+    rc.sample(t + 600ms, true);
+    REQUIRE(rc.rateHz() == 4.0);
+    rc.sample(t + 1200ms, true);
+    rc.sample(t + 1800ms, true);
+    REQUIRE(rc.rateHz() == 2.0); // floor
+
+    // Additive increase while the consumer keeps up, capped at the maximum
+    rc.sample(t + 2800ms, false);
+    REQUIRE(rc.rateHz() == 7.0);
+    rc.sample(t + 30s, false);
+    REQUIRE(rc.rateHz() == 60.0);
+}
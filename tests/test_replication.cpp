@@ -0,0 +1,139 @@
+#include <catch2/catch_test_macros.hpp>
+#include "replication/ReplicationProtocol.h"
+#include "replication/ReplicationReceiver.h"
+#include "replication/ReplicationSender.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace photon;
+using namespace std::chrono_literals;
+
+namespace {
+
+template <typename Pred>
+bool waitFor(Pred pred, std::chrono::milliseconds timeout = 2000ms) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (pred()) return true;
+        std::this_thread::sleep_for(5ms);
+    }
+    return pred();
+}
+
+const uint8_t* bytes(const std::string& s) {
+    return reinterpret_cast<const uint8_t*>(s.data());
+}
+
+} // namespace
+
+TEST_CASE("Universe packets carry only active planes") {
+    Universe::Planes planes;
+    planes.values[2][7] = 200;
+    planes.active[2][0] = 0x80;
+
+    auto packet = replication::encodeUniverse(9, 3, 17, 5, planes);
+    REQUIRE(packet.size() == sizeof(replication::PacketHeader) + 2 + planecodec::PLANE_SIZE);
+
+    replication::PacketHeader header{};
+    REQUIRE(replication::decodeHeader(bytes(packet), packet.size(), header));
+    REQUIRE(header.type == static_cast<uint8_t>(replication::PacketType::Universe));
+    REQUIRE(header.universe == 5);
+    REQUIRE(header.session == 9);
+    REQUIRE(header.seq == 3);
+    REQUIRE(header.mergeVersion == 17);
+
+    Universe::Planes decoded;
+    REQUIRE(replication::decodeUniverse(bytes(packet), packet.size(), decoded));
+    REQUIRE(decoded.values[2][7] == 200);
+    REQUIRE(decoded.active[2][0] == 0x80);
+    REQUIRE_FALSE(replication::decodeUniverse(bytes(packet), packet.size() - 1, decoded));
+
+    auto bad = packet;
+    bad[0] ^= 0xFF;
+    REQUIRE_FALSE(replication::decodeHeader(bytes(bad), bad.size(), header));
+}
+
+TEST_CASE("A standby mirrors the primary and takes over when it goes quiet") {
+    MergeBuffer primary(2);
+    MergeBuffer standby(2);
+    std::atomic<int> takeovers{0};
+    std::atomic<int> handbacks{0};
+
+    ReplicationReceiver receiver(standby, [&](bool active) { (active ? takeovers : handbacks)++; });
+    REQUIRE(receiver.start(0, 300ms));
+    REQUIRE(receiver.getPort() != 0);
+    auto target = "127.0.0.1:" + std::to_string(receiver.getPort());
+
+    primary.setValue(1, 10, 40, SourcePriority::Background);
+    primary.setValue(1, 10, 90, SourcePriority::Programmer);
+    {
+        ReplicationSender sender(primary);
+        REQUIRE(sender.start(target, 100.0));
+        REQUIRE(waitFor([&] { return standby.getOutput(1)[10] == 90; }));
+
+        primary.setValue(0, 3, 7, SourcePriority::Scene);
+        REQUIRE(waitFor([&] { return standby.getOutput(0)[3] == 7; }));
+        REQUIRE_FALSE(receiver.isActive());
+        REQUIRE(takeovers == 0);
+    }
+
+    // Lower priorities were replicated too
+    standby.clearPriority(1, SourcePriority::Programmer);
+    REQUIRE(standby.getOutput(1)[10] == 40);
+
+    REQUIRE(waitFor([&] { return receiver.isActive(); }));
+    REQUIRE(takeovers == 1);
+
+    // A restarted primary is a new session: it only gets output back, and
+    // overwrites the standby's state, on an explicit handback
+    primary.setValue(0, 3, 8, SourcePriority::Scene);
+    ReplicationSender restarted(primary);
+    REQUIRE(restarted.start(target, 100.0));
+    REQUIRE(waitFor([&] { return receiver.getStats().packets > 20; }));
+    REQUIRE(receiver.isActive());
+    REQUIRE(standby.getOutput(0)[3] == 7);
+    REQUIRE(handbacks == 0);
+
+    REQUIRE(receiver.handBack());
+    REQUIRE(waitFor([&] { return !receiver.isActive() && standby.getOutput(0)[3] == 8; }));
+    REQUIRE(handbacks == 1);
+    REQUIRE_FALSE(receiver.handBack());
+    restarted.stop();
+    receiver.stop();
+}
+
+TEST_CASE("A standby hands output straight back after a network blip") {
+    MergeBuffer standby(1);
+    ReplicationReceiver receiver(standby, nullptr);
+    REQUIRE(receiver.start(0, 200ms));
+
+    int sock = ::socket(AF_INET, SOCK_DGRAM, 0);
+    REQUIRE(sock >= 0);
+    sockaddr_in to{};
+    to.sin_family = AF_INET;
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    to.sin_port = htons(receiver.getPort());
+    auto send = [&](const std::string& packet) {
+        ::sendto(sock, packet.data(), packet.size(), 0, reinterpret_cast<const sockaddr*>(&to), sizeof(to));
+    };
+
+    Universe::Planes planes;
+    planes.values[2][7] = 50;
+    planes.active[2][0] = 0x80;
+    send(replication::encodeUniverse(7, 1, 1, 0, planes));
+    REQUIRE(waitFor([&] { return standby.getOutput(0)[7] == 50; }));
+    REQUIRE(waitFor([&] { return receiver.isActive(); }));
+
+    // Same session resumes: no handback needed
+    planes.values[2][7] = 60;
+    send(replication::encodeUniverse(7, 2, 2, 0, planes));
+    REQUIRE(waitFor([&] { return !receiver.isActive() && standby.getOutput(0)[7] == 60; }));
+
+    ::close(sock);
+    receiver.stop();
+}
@@ -0,0 +1,103 @@
+#include <catch2/catch_test_macros.hpp>
+#include "engine/PlaneCodec.h"
+#include "show/ShowSnapshot.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+using namespace photon;
+
+namespace {
+
+std::string tempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+} // namespace
+
+TEST_CASE("Snapshots round-trip every priority plane") {
+    auto path = tempPath("photon_test_snapshot.phs");
+    std::filesystem::remove(path);
+
+    MergeBuffer source(3);
+    source.setValue(0, 0, 255, SourcePriority::Background);
+    source.setValue(0, 0, 10, SourcePriority::Programmer);
+    source.setValue(2, 511, 77, SourcePriority::Scene);
+    {
+        ShowSnapshot snapshot(source);
+        REQUIRE(snapshot.start(path, std::chrono::milliseconds(0)));
+        REQUIRE(snapshot.saveNow());
+        // Universe 1 has no active priority and is left out of the file
+        REQUIRE(snapshot.getStats().bytes ==
+                sizeof(showsnap::SnapshotHeader) + 2 * sizeof(showsnap::UniverseRecord) +
+                    3 * planecodec::PLANE_SIZE);
+    }
+
+    MergeBuffer restored(3);
+    restored.setValue(1, 5, 99, SourcePriority::Effect);
+    REQUIRE(ShowSnapshot::restore(path, restored));
+    REQUIRE(restored.getOutput(0)[0] == 10);
+    REQUIRE(restored.getOutput(1)[5] == 0);
+    REQUIRE(restored.getOutput(2)[511] == 77);
+
+    // Lower planes come back too, not just the merged output
+    restored.clearPriority(0, SourcePriority::Programmer);
+    REQUIRE(restored.getOutput(0)[0] == 255);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Captures only copy universes written since the last one") {
+    MergeBuffer buffer(2);
+    std::vector<Universe::Planes> planes;
+    buffer.setValue(0, 1, 50, SourcePriority::Scene);
+    auto v1 = buffer.capturePlanes(planes, 0);
+    REQUIRE(planes.size() == 2);
+    REQUIRE(planes[0].values[1][1] == 50);
+
+    buffer.setValue(1, 2, 60, SourcePriority::Scene);
+    planes[0].values[1][1] = 0; // not rewritten unless universe 0 changed
+    auto v2 = buffer.capturePlanes(planes, v1);
+    REQUIRE(v2 > v1);
+    REQUIRE(planes[0].values[1][1] == 0);
+    REQUIRE(planes[1].values[1][2] == 60);
+    REQUIRE(planes[1].active[1][0] == 0x04);
+
+    // Before any write there is nothing new after the first capture
+    MergeBuffer idle(2);
+    std::vector<Universe::Planes> idlePlanes;
+    std::vector<uint16_t> changed;
+    auto v0 = idle.capturePlanes(idlePlanes, 0, &changed);
+    REQUIRE(changed.size() == 2);
+    idle.capturePlanes(idlePlanes, v0, &changed);
+    REQUIRE(changed.empty());
+}
+
+TEST_CASE("Corrupt or truncated snapshots are rejected") {
+    std::vector<Universe::Planes> planes(2);
+    planes[1].values[0][3] = 9;
+    planes[1].active[0][0] = 0x08;
+
+    std::vector<uint8_t> image;
+    ShowSnapshot::encode(planes, 42, 0, image);
+
+    std::vector<Universe::Planes> decoded;
+    std::string error;
+    REQUIRE(ShowSnapshot::decode(image.data(), image.size(), decoded, error));
+    REQUIRE(decoded.size() == 2);
+    REQUIRE(decoded[1].values[0][3] == 9);
+
+    REQUIRE_FALSE(ShowSnapshot::decode(image.data(), image.size() - 1, decoded, error));
+    image.back() ^= 0xFF;
+    REQUIRE_FALSE(ShowSnapshot::decode(image.data(), image.size(), decoded, error));
+    REQUIRE(error == "checksum mismatch");
+
+    auto path = tempPath("photon_test_snapshot_bad.phs");
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(image.data()),
+                                                static_cast<std::streamsize>(image.size()));
+    MergeBuffer buffer(2);
+    buffer.setValue(0, 0, 1, SourcePriority::Scene);
+    REQUIRE_FALSE(ShowSnapshot::restore(path, buffer));
+    REQUIRE(buffer.getOutput(0)[0] == 1);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,89 @@
+#include <catch2/catch_test_macros.hpp>
+#include "web/AssetEncoding.h"
+#include "web/EmbeddedAssets.h"
+#include "web/StaticAssetCache.h"
+#include <filesystem>
+#include <fstream>
+
+using namespace photon;
+namespace fs = std::filesystem;
+
+namespace {
+
+void writeFile(const fs::path& path, const std::string& content) {
+    fs::create_directories(path.parent_path());
+    std::ofstream(path, std::ios::binary) << content;
+}
+
+} // namespace
+
+TEST_CASE("Accept-Encoding negotiation honours q=0") {
+    REQUIRE(assets::acceptsEncoding("gzip, deflate, br", "br"));
+    REQUIRE(assets::acceptsEncoding("gzip;q=0.5", "gzip"));
+    REQUIRE_FALSE(assets::acceptsEncoding("gzip, br;q=0", "br"));
+    REQUIRE_FALSE(assets::acceptsEncoding("", "gzip"));
+    REQUIRE(assets::acceptsEncoding("*", "br"));
+}
+
+TEST_CASE("Hashed asset paths are immutable") {
+    REQUIRE(assets::isImmutablePath("/_next/static/chunks/main.js"));
+    REQUIRE(assets::isImmutablePath("/app.3f9a1c2e.js"));
+    REQUIRE(assets::isImmutablePath("/vendor-8b1f20c9aa.css"));
+    REQUIRE_FALSE(assets::isImmutablePath("/index.html"));
+    REQUIRE_FALSE(assets::isImmutablePath("/favicon.ico"));
+    REQUIRE_FALSE(assets::isImmutablePath("/photon-frontend.js"));
+}
+
+TEST_CASE("StaticAssetCache serves from memory with SPA fallback") {
+    auto root = fs::temp_directory_path() / "photon_test_assets";
+    fs::remove_all(root);
+    std::string script;
+    for (int i = 0; i < 200; ++i) script += "console.log('photon frame " + std::to_string(i % 10) + "');\n";
+    writeFile(root / "index.html", "<html><body>photon</body></html>");
+    writeFile(root / "_next/static/app.js", script);
+
+    StaticAssetCache cache;
+    REQUIRE(cache.load(root.string()));
+    REQUIRE(cache.getAssetCount() == 2);
+
+    auto index = cache.find("/");
+    REQUIRE(index);
+    REQUIRE(index->contentType == "text/html; charset=utf-8");
+    REQUIRE_FALSE(index->immutable);
+    REQUIRE(cache.find("/dashboard/settings") == index);
+
+    auto js = cache.find("/_next/static/app.js");
+    REQUIRE(js);
+    REQUIRE(js->body == script);
+    REQUIRE(js->immutable);
+    REQUIRE(js->etag == assets::contentETag(script));
+    // Variants only exist when the codec was built in, and must be smaller
+    if (!js->gzip.empty()) {
+        REQUIRE(static_cast<uint8_t>(js->gzip[0]) == 0x1f);
+        REQUIRE(js->gzip.size() < script.size());
+    }
+    if (!js->brotli.empty()) REQUIRE(js->brotli.size() < script.size());
+
+    // Files are not read again after load
+    fs::remove_all(root);
+    REQUIRE(cache.find("/_next/static/app.js") == js);
+    REQUIRE_FALSE(cache.load(root.string()));
+}
+
+TEST_CASE("StaticAssetCache serves embedded assets without copying") {
+    auto embedded = embeddedAssets();
+    StaticAssetCache cache;
+    if (embedded.empty()) {
+        REQUIRE_FALSE(cache.loadEmbedded());
+        REQUIRE(cache.find("/") == nullptr);
+        return;
+    }
+
+    REQUIRE(cache.loadEmbedded());
+    REQUIRE(cache.getAssetCount() == embedded.size());
+    const auto& first = embedded.front();
+    auto asset = cache.find(first.path);
+    REQUIRE(asset);
+    REQUIRE(asset->body.data() == reinterpret_cast<const char*>(first.body));
+    REQUIRE(asset->etag == first.etag);
+}
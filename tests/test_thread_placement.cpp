@@ -0,0 +1,73 @@
+#include <catch2/catch_test_macros.hpp>
+#include "engine/ThreadPlacement.h"
+#include <thread>
+
+using namespace photon;
+using placement::Role;
+using placement::Sched;
+using placement::ThreadPolicy;
+
+TEST_CASE("Thread specs parse CPU lists, policy and priority") {
+    Role role{};
+    ThreadPolicy policy;
+    std::string error;
+
+    REQUIRE(placement::parseSpec("output=3:fifo:80", role, policy, error));
+    REQUIRE(role == Role::Output);
+    REQUIRE(policy.cpus == std::vector<int>{3});
+    REQUIRE(policy.sched == Sched::Fifo);
+    REQUIRE(policy.priority == 80);
+
+    REQUIRE(placement::parseSpec("web=0-2,5,1", role, policy, error));
+    REQUIRE(role == Role::Web);
+    REQUIRE(policy.cpus == std::vector<int>{0, 1, 2, 5});
+    REQUIRE(policy.sched == Sched::Other);
+
+    REQUIRE(placement::parseSpec("engine=*:rr", role, policy, error));
+    REQUIRE(role == Role::Engine);
+    REQUIRE(policy.cpus.empty());
+    REQUIRE(policy.sched == Sched::RoundRobin);
+    REQUIRE(policy.priority == 50);
+}
+
+TEST_CASE("Malformed thread specs are rejected") {
+    Role role{};
+    ThreadPolicy policy;
+    std::string error;
+
+    for (const char* spec : {"output", "gpu=1", "output=", "output=a", "output=3-1",
+                             "output=1:idle", "output=1:fifo:0", "output=1:fifo:100",
+                             "output=1:other:10", "output=1:fifo:80:x"}) {
+        INFO(spec);
+        error.clear();
+        REQUIRE_FALSE(placement::parseSpec(spec, role, policy, error));
+        REQUIRE_FALSE(error.empty());
+    }
+    REQUIRE_FALSE(placement::configure({"relay=0", "bogus"}));
+}
+
+TEST_CASE("Applied placements are reported per thread") {
+    REQUIRE(placement::configure({"relay=*"}));
+
+    std::thread worker([] { placement::apply(Role::Relay, "test-relay"); });
+    worker.join();
+    // Re-applying under the same name replaces the entry
+    std::thread again([] { placement::apply(Role::Relay, "test-relay"); });
+    again.join();
+
+    size_t found = 0;
+    for (const auto& t : placement::report()) {
+        if (t.name != "test-relay") continue;
+        ++found;
+        REQUIRE(t.role == "relay");
+        REQUIRE(t.requested.sched == Sched::Other);
+        REQUIRE(t.error.empty());
+        REQUIRE(t.sched == "other");
+#ifdef __linux__
+        REQUIRE_FALSE(t.cpus.empty());
+        REQUIRE(t.tid != 0);
+#endif
+    }
+    REQUIRE(found == 1);
+    REQUIRE(placement::configure({}));
+}
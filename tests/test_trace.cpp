@@ -0,0 +1,96 @@
+#include <catch2/catch_test_macros.hpp>
+#include "metrics/Trace.h"
+#include <nlohmann/json.hpp>
+#include <thread>
+
+using namespace photon;
+using json = nlohmann::json;
+
+namespace {
+
+size_t countEvents(const json& trace, const std::string& name) {
+    size_t n = 0;
+    for (const auto& e : trace["traceEvents"]) {
+        if (e["ph"] == "X" && e["name"] == name) ++n;
+    }
+    return n;
+}
+
+} // namespace
+
+TEST_CASE("Trace scopes record nothing while capture is off") {
+    trace::stop();
+    trace::start();
+    trace::stop();
+    { PHOTON_TRACE_SCOPE("test.idle"); }
+
+    auto trace = json::parse(trace::exportChromeJson());
+    REQUIRE(countEvents(trace, "test.idle") == 0);
+}
+
+TEST_CASE("Trace export is Chrome trace JSON with named threads") {
+    trace::start();
+    REQUIRE(trace::isCapturing());
+    {
+        PHOTON_TRACE_SCOPE("test.outer");
+        PHOTON_TRACE_SCOPE_ARG("test.inner", "universe", 3);
+    }
+    std::thread worker([] {
+        trace::setThreadName("test-worker");
+        PHOTON_TRACE_SCOPE("test.worker");
+    });
+    worker.join();
+    trace::stop();
+
+    auto trace = json::parse(trace::exportChromeJson());
+    REQUIRE(countEvents(trace, "test.outer") == 1);
+    REQUIRE(countEvents(trace, "test.worker") == 1);
+
+    const json* inner = nullptr;
+    uint64_t workerTid = 0;
+    for (const auto& e : trace["traceEvents"]) {
+        if (e["name"] == "test.inner") inner = &e;
+        if (e["ph"] == "M" && e["args"]["name"] == "test-worker") workerTid = e["tid"];
+    }
+    REQUIRE(inner);
+    REQUIRE((*inner)["args"]["universe"] == 3);
+    REQUIRE((*inner)["dur"].get<double>() >= 0.0);
+    REQUIRE(workerTid != 0);
+
+    // Exports survive the worker thread exiting
+    for (const auto& e : trace["traceEvents"]) {
+        if (e["name"] == "test.worker") REQUIRE(e["tid"] == workerTid);
+    }
+}
+
+TEST_CASE("Starting a capture discards the previous one") {
+    trace::start();
+    { PHOTON_TRACE_SCOPE("test.first"); }
+    trace::start();
+    { PHOTON_TRACE_SCOPE("test.second"); }
+    trace::stop();
+
+    auto trace = json::parse(trace::exportChromeJson());
+    REQUIRE(countEvents(trace, "test.first") == 0);
+    REQUIRE(countEvents(trace, "test.second") == 1);
+}
+
+TEST_CASE("A full ring keeps the newest events") {
+    trace::start();
+    for (size_t i = 0; i < trace::EVENTS_PER_THREAD + 10; ++i) {
+        PHOTON_TRACE_SCOPE_ARG("test.ring", "i", i);
+    }
+    trace::stop();
+
+    auto trace = json::parse(trace::exportChromeJson());
+    // One slot is held back in case the writer is mid-update
+    auto kept = countEvents(trace, "test.ring");
+    REQUIRE(kept >= trace::EVENTS_PER_THREAD - 1);
+    REQUIRE(kept <= trace::EVENTS_PER_THREAD);
+
+    int64_t last = -1;
+    for (const auto& e : trace["traceEvents"]) {
+        if (e["name"] == "test.ring") last = e["args"]["i"];
+    }
+    REQUIRE(last == static_cast<int64_t>(trace::EVENTS_PER_THREAD + 9));
+}
@@ -0,0 +1,53 @@
+#include <catch2/catch_test_macros.hpp>
+#include "web/UniverseCache.h"
+#include <nlohmann/json.hpp>
+
+using namespace photon;
+using json = nlohmann::json;
+
+TEST_CASE("UniverseCache reuses bodies until the version moves") {
+    MergeBuffer mb(2);
+    UniverseCache cache(mb);
+
+    uint64_t v0 = 0;
+    auto first = cache.universes(v0);
+    uint64_t again = 0;
+    REQUIRE(cache.universes(again) == first);
+    REQUIRE(again == v0);
+
+    mb.setValue(1, 5, 99, SourcePriority::Programmer);
+    uint64_t v1 = 0;
+    auto second = cache.universes(v1);
+    REQUIRE(second != first);
+    REQUIRE(v1 > v0);
+
+    auto arr = json::parse(*second);
+    REQUIRE(arr.size() == 2);
+    REQUIRE(arr[1]["id"] == 1);
+    REQUIRE(arr[1]["version"] == v1);
+    REQUIRE(arr[1]["channels"][5] == 99);
+    REQUIRE(arr[1]["channels"].size() == 512);
+
+    // Untouched universe keeps its cached object
+    uint64_t u0 = 0;
+    auto a = cache.universe(0, u0);
+    REQUIRE(cache.universe(0, u0) == a);
+    REQUIRE(cache.universe(7, u0) == nullptr);
+}
+
+TEST_CASE("UniverseCache since returns only changed universes") {
+    MergeBuffer mb(3);
+    UniverseCache cache(mb);
+
+    uint64_t base = 0;
+    cache.universes(base);
+
+    mb.setValue(2, 0, 1, SourcePriority::Programmer);
+    uint64_t version = 0;
+    auto changed = json::parse(cache.universesSince(base, version));
+    REQUIRE(changed.size() == 1);
+    REQUIRE(changed[0]["id"] == 2);
+    REQUIRE(version == mb.getVersion());
+
+    REQUIRE(json::parse(cache.universesSince(version, version)).empty());
+}
@@ -0,0 +1,263 @@
+#include <catch2/catch_test_macros.hpp>
+#include "web/WsProtocol.h"
+#include <nlohmann/json.hpp>
+#include <array>
+#include <vector>
+
+using namespace photon;
+
+TEST_CASE("Binary DmxState frame carries header and raw channels") {
+    std::array<uint8_t, 512> channels{};
+    channels[0] = 255;
+    channels[511] = 7;
+
+    auto frame = wsproto::encodeDmxState(300, 0x01020304, channels.data());
+    REQUIRE(frame.size() == wsproto::DMX_STATE_SIZE);
+
+    wsproto::Header header{};
+    auto* p = reinterpret_cast<const uint8_t*>(frame.data());
+    REQUIRE(wsproto::readHeader(p, frame.size(), header));
+    REQUIRE(header.type == wsproto::MessageType::DmxState);
+    REQUIRE(header.universe == 300);
+    REQUIRE(header.seq == 0x01020304);
+    REQUIRE(p[wsproto::HEADER_SIZE] == 255);
+    REQUIRE(p[wsproto::HEADER_SIZE + 511] == 7);
+}
+
+TEST_CASE("JSON dmx_state matches the nlohmann encoding") {
+    std::array<uint8_t, 512> channels{};
+    for (int i = 0; i < 512; ++i) channels[i] = static_cast<uint8_t>(i * 7);
+
+    nlohmann::json expected;
+    expected["type"] = "dmx_state";
+    expected["universe"] = 12;
+    expected["channels"] = nlohmann::json::array();
+    for (auto v : channels) expected["channels"].push_back(v);
+
+    REQUIRE(wsproto::encodeDmxStateJson(12, channels.data()) == expected.dump());
+}
+
+TEST_CASE("SetChannels decoding validates the channel range") {
+    auto makeFrame = [](uint16_t universe, uint16_t start, size_t count) {
+        std::string frame(wsproto::HEADER_SIZE + 2 + count, '\0');
+        auto* p = reinterpret_cast<uint8_t*>(frame.data());
+        wsproto::writeHeader(p, {wsproto::MessageType::SetChannels, 0, universe, 1});
+        p[wsproto::HEADER_SIZE] = static_cast<uint8_t>(start & 0xFF);
+        p[wsproto::HEADER_SIZE + 1] = static_cast<uint8_t>(start >> 8);
+        for (size_t i = 0; i < count; ++i) p[wsproto::HEADER_SIZE + 2 + i] = static_cast<uint8_t>(i + 1);
+        return frame;
+    };
+
+    wsproto::SetChannels msg;
+    REQUIRE(wsproto::decodeSetChannels(makeFrame(2, 500, 12), msg));
+    REQUIRE(msg.universe == 2);
+    REQUIRE(msg.start == 500);
+    REQUIRE(msg.count == 12);
+    REQUIRE(msg.values[11] == 12);
+
+    REQUIRE_FALSE(wsproto::decodeSetChannels(makeFrame(2, 500, 13), msg));
+    REQUIRE_FALSE(wsproto::decodeSetChannels(makeFrame(2, 512, 1), msg));
+    REQUIRE_FALSE(wsproto::decodeSetChannels(makeFrame(2, 0, 0), msg));
+    REQUIRE_FALSE(wsproto::decodeSetChannels(std::string(4, '\0'), msg));
+
+    auto wrongType = makeFrame(2, 0, 4);
+    wrongType[0] = static_cast<char>(wsproto::MessageType::DmxState);
+    REQUIRE_FALSE(wsproto::decodeSetChannels(wrongType, msg));
+}
+
+TEST_CASE("DmxDelta encodes changed runs and merges short gaps") {
+    std::array<uint8_t, 512> previous{};
+    auto current = previous;
+    current[10] = 1;
+    current[13] = 2;  // gap of 2 unchanged: merged into one run
+    current[100] = 3; // far away: its own run
+    current[511] = 4;
+
+    auto frame = wsproto::encodeDmxDelta(5, 42, previous.data(), current.data());
+    wsproto::Header header{};
+    REQUIRE(wsproto::readHeader(reinterpret_cast<const uint8_t*>(frame.data()), frame.size(), header));
+    REQUIRE(header.type == wsproto::MessageType::DmxDelta);
+    REQUIRE(header.universe == 5);
+    REQUIRE(header.seq == 42);
+    // Three runs: [10..13], [100], [511]
+    REQUIRE(frame.size() == wsproto::HEADER_SIZE + 3 * wsproto::DELTA_RUN_HEADER_SIZE + 4 + 1 + 1);
+
+    auto applied = previous;
+    REQUIRE(wsproto::applyDmxDelta(frame, applied.data()));
+    REQUIRE(applied == current);
+
+    auto unchanged = wsproto::encodeDmxDelta(5, 43, current.data(), current.data());
+    REQUIRE(unchanged.size() == wsproto::HEADER_SIZE);
+    REQUIRE(wsproto::applyDmxDelta(unchanged, applied.data()));
+    REQUIRE(applied == current);
+}
+
+TEST_CASE("DmxDelta rejects malformed runs") {
+    std::array<uint8_t, 512> channels{};
+    auto makeFrame = [](uint16_t start, uint16_t count, size_t values) {
+        std::string frame(wsproto::HEADER_SIZE, '\0');
+        wsproto::writeHeader(reinterpret_cast<uint8_t*>(frame.data()),
+                             {wsproto::MessageType::DmxDelta, 0, 0, 1});
+        frame += static_cast<char>(start & 0xFF);
+        frame += static_cast<char>(start >> 8);
+        frame += static_cast<char>(count & 0xFF);
+        frame += static_cast<char>(count >> 8);
+        frame.append(values, '\x01');
+        return frame;
+    };
+
+    REQUIRE(wsproto::applyDmxDelta(makeFrame(508, 4, 4), channels.data()));
+    REQUIRE(channels[511] == 1);
+    REQUIRE_FALSE(wsproto::applyDmxDelta(makeFrame(510, 4, 4), channels.data()));
+    REQUIRE_FALSE(wsproto::applyDmxDelta(makeFrame(0, 4, 3), channels.data()));
+    REQUIRE_FALSE(wsproto::applyDmxDelta(makeFrame(0, 0, 0), channels.data()));
+    REQUIRE_FALSE(wsproto::applyDmxDelta(makeFrame(0, 1, 1).substr(0, wsproto::HEADER_SIZE + 2), channels.data()));
+    REQUIRE_FALSE(wsproto::applyDmxDelta(wsproto::encodeDmxState(0, 1, channels.data()), channels.data()));
+}
+
+namespace {
+
+void appendU16(std::string& out, uint16_t v) {
+    out += static_cast<char>(v & 0xFF);
+    out += static_cast<char>(v >> 8);
+}
+
+std::string batchHeader(uint16_t origin, uint32_t seq) {
+    std::string frame(wsproto::HEADER_SIZE, '\0');
+    wsproto::writeHeader(reinterpret_cast<uint8_t*>(frame.data()),
+                         {wsproto::MessageType::CommandBatch, 0, origin, seq});
+    return frame;
+}
+
+} // namespace
+
+TEST_CASE("CommandBatch decodes ranges and sparse writes into runs") {
+    auto frame = batchHeader(7, 1234);
+    frame += static_cast<char>(wsproto::BatchOp::Range);
+    appendU16(frame, 2);
+    appendU16(frame, 100);
+    appendU16(frame, 3);
+    frame += "\x0a\x0b\x0c";
+    frame += static_cast<char>(wsproto::BatchOp::Sparse);
+    appendU16(frame, 1);
+    appendU16(frame, 2);
+    appendU16(frame, 5);
+    frame += '\x55';
+    appendU16(frame, 511);
+    frame += '\x66';
+
+    std::vector<ChannelRun> runs(wsproto::MAX_BATCH_RUNS);
+    wsproto::Header header{};
+    size_t count = 0;
+    bool blackout = true;
+    REQUIRE(wsproto::decodeCommandBatch(frame, header, runs.data(), count, blackout));
+    REQUIRE(header.universe == 7);
+    REQUIRE(header.seq == 1234);
+    REQUIRE_FALSE(blackout);
+    REQUIRE(count == 3);
+    REQUIRE(runs[0].universe == 2);
+    REQUIRE(runs[0].start == 100);
+    REQUIRE(runs[0].count == 3);
+    REQUIRE(runs[0].values[2] == 0x0c);
+    REQUIRE(runs[1].universe == 1);
+    REQUIRE(runs[1].start == 5);
+    REQUIRE(runs[1].count == 1);
+    REQUIRE(runs[1].values[0] == 0x55);
+    REQUIRE(runs[2].start == 511);
+    REQUIRE(runs[2].values[0] == 0x66);
+
+    REQUIRE(wsproto::batchAck(7, 1234) == R"({"client":7,"seq":1234,"type":"ack"})");
+    REQUIRE(nlohmann::json::parse(wsproto::batchAck(9))["seq"] == 9);
+}
+
+TEST_CASE("CommandBatch blackout drops the writes before it") {
+    auto frame = batchHeader(0, 1);
+    frame += static_cast<char>(wsproto::BatchOp::Range);
+    appendU16(frame, 0);
+    appendU16(frame, 0);
+    appendU16(frame, 1);
+    frame += '\x01';
+    frame += static_cast<char>(wsproto::BatchOp::Blackout);
+    frame += static_cast<char>(wsproto::BatchOp::Range);
+    appendU16(frame, 0);
+    appendU16(frame, 9);
+    appendU16(frame, 1);
+    frame += '\x02';
+
+    std::vector<ChannelRun> runs(wsproto::MAX_BATCH_RUNS);
+    wsproto::Header header{};
+    size_t count = 0;
+    bool blackout = false;
+    REQUIRE(wsproto::decodeCommandBatch(frame, header, runs.data(), count, blackout));
+    REQUIRE(blackout);
+    REQUIRE(count == 1);
+    REQUIRE(runs[0].start == 9);
+}
+
+TEST_CASE("CommandBatch rejects malformed ops") {
+    std::vector<ChannelRun> runs(wsproto::MAX_BATCH_RUNS);
+    wsproto::Header header{};
+    size_t count = 0;
+    bool blackout = false;
+    auto decode = [&](const std::string& frame) {
+        return wsproto::decodeCommandBatch(frame, header, runs.data(), count, blackout);
+    };
+
+    auto range = [](uint16_t start, uint16_t n, size_t values) {
+        auto frame = batchHeader(0, 1);
+        frame += static_cast<char>(wsproto::BatchOp::Range);
+        appendU16(frame, 0);
+        appendU16(frame, start);
+        appendU16(frame, n);
+        frame.append(values, '\x01');
+        return frame;
+    };
+    REQUIRE(decode(range(500, 12, 12)));
+    REQUIRE_FALSE(decode(range(500, 13, 13)));
+    REQUIRE_FALSE(decode(range(0, 4, 3)));
+    REQUIRE_FALSE(decode(range(0, 0, 0)));
+
+    auto sparse = batchHeader(0, 1);
+    sparse += static_cast<char>(wsproto::BatchOp::Sparse);
+    appendU16(sparse, 0);
+    appendU16(sparse, 1);
+    appendU16(sparse, 512);
+    sparse += '\x01';
+    REQUIRE_FALSE(decode(sparse));
+
+    auto tooMany = batchHeader(0, 1);
+    tooMany += static_cast<char>(wsproto::BatchOp::Sparse);
+    appendU16(tooMany, 0);
+    appendU16(tooMany, static_cast<uint16_t>(wsproto::MAX_BATCH_RUNS + 1));
+    for (size_t i = 0; i <= wsproto::MAX_BATCH_RUNS; ++i) {
+        appendU16(tooMany, static_cast<uint16_t>(i % 512));
+        tooMany += '\x01';
+    }
+    REQUIRE_FALSE(decode(tooMany));
+
+    REQUIRE_FALSE(decode(batchHeader(0, 1) + '\x09'));
+    std::array<uint8_t, 512> channels{};
+    REQUIRE_FALSE(decode(wsproto::encodeDmxState(0, 1, channels.data())));
+}
+
+TEST_CASE("PixelFrame carries its size and format") {
+    std::vector<uint8_t> pixels(4 * 2 * 4);
+    for (size_t i = 0; i < pixels.size(); ++i) pixels[i] = static_cast<uint8_t>(i);
+
+    auto frame = wsproto::encodePixelFrame(4, 2, true, pixels.data());
+    wsproto::Header header{};
+    REQUIRE(wsproto::readHeader(reinterpret_cast<const uint8_t*>(frame.data()), frame.size(), header));
+    REQUIRE(header.type == wsproto::MessageType::PixelFrame);
+
+    wsproto::PixelFrame decoded;
+    REQUIRE(wsproto::decodePixelFrame(frame, header, decoded));
+    REQUIRE(decoded.width == 4);
+    REQUIRE(decoded.height == 2);
+    REQUIRE(decoded.rgba);
+    REQUIRE(decoded.pixels[31] == 31);
+
+    // The pixel count must match the declared size exactly
+    REQUIRE_FALSE(wsproto::decodePixelFrame(frame.substr(0, frame.size() - 1), header, decoded));
+    header.flags = 0;
+    REQUIRE_FALSE(wsproto::decodePixelFrame(frame, header, decoded));
+}
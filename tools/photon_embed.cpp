@@ -0,0 +1,138 @@
+// Build-time generator: turns a frontend dist/ directory into a C++
+// translation unit defining photon::embeddedAssets() (see
+// src/web/EmbeddedAssets.h). Every file becomes static byte arrays for the
+// raw body and its gzip/brotli variants, compressed at maximum level since
+// this only runs when the frontend changes.
+//
+//   photon_embed <dist-dir> <output.cpp>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "web/AssetEncoding.h"
+
+namespace fs = std::filesystem;
+using namespace photon;
+
+namespace {
+
+struct Entry {
+    std::string urlPath;
+    std::string body;
+    std::string gzip;
+    std::string brotli;
+};
+
+std::string cStringLiteral(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+void writeArray(std::ostream& out, const std::string& name, const std::string& data) {
+    out << "alignas(16) const uint8_t " << name << "[] = {";
+    for (size_t i = 0; i < data.size(); ++i) {
+        if (i % 24 == 0) out << "\n    ";
+        out << static_cast<unsigned>(static_cast<uint8_t>(data[i])) << ',';
+    }
+    out << "\n};\n";
+}
+
+std::string arrayRef(const std::string& name, const std::string& data) {
+    if (data.empty()) return "nullptr, 0";
+    return name + ", " + std::to_string(data.size());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: photon_embed <dist-dir> <output.cpp>\n";
+        return 2;
+    }
+    fs::path root = argv[1];
+    fs::path output = argv[2];
+
+    std::vector<Entry> entries;
+    std::error_code ec;
+    if (fs::is_directory(root, ec)) {
+        for (auto it = fs::recursive_directory_iterator(root, ec);
+             !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            if (!it->is_regular_file(ec)) continue;
+            std::ifstream file(it->path(), std::ios::binary);
+            Entry e;
+            e.urlPath = "/" + fs::relative(it->path(), root, ec).generic_string();
+            e.body.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            entries.push_back(std::move(e));
+        }
+    } else {
+        std::cerr << "photon_embed: " << root << " not found, embedding no frontend\n";
+    }
+    // Deterministic output regardless of directory iteration order
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.urlPath < b.urlPath; });
+
+    std::ostringstream out;
+    out << "// Generated by photon_embed from " << fs::absolute(root).generic_string()
+        << ". Do not edit.\n"
+        << "#include \"web/EmbeddedAssets.h\"\n\n"
+        << "namespace photon {\n\nnamespace {\n\n";
+
+    size_t rawBytes = 0, servedBytes = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        auto& e = entries[i];
+        auto type = assets::contentTypeFor(fs::path(e.urlPath).extension().string());
+        if (assets::isCompressible(type)) {
+            if (!assets::gzipCompress(e.body, e.gzip, 9)) e.gzip.clear();
+            if (!assets::brotliCompress(e.body, e.brotli, 11)) e.brotli.clear();
+        }
+        auto id = "a" + std::to_string(i);
+        if (!e.body.empty()) writeArray(out, id + "_body", e.body);
+        if (!e.gzip.empty()) writeArray(out, id + "_gz", e.gzip);
+        if (!e.brotli.empty()) writeArray(out, id + "_br", e.brotli);
+
+        rawBytes += e.body.size();
+        servedBytes += !e.brotli.empty() ? e.brotli.size() : !e.gzip.empty() ? e.gzip.size() : e.body.size();
+    }
+
+    if (entries.empty()) {
+        out << "} // namespace\n\n"
+            << "std::span<const EmbeddedAsset> embeddedAssets() {\n    return {};\n}\n\n";
+    } else {
+        out << "const EmbeddedAsset ASSETS[] = {\n";
+        for (size_t i = 0; i < entries.size(); ++i) {
+            const auto& e = entries[i];
+            auto id = "a" + std::to_string(i);
+            out << "    {" << cStringLiteral(e.urlPath) << ", "
+                << cStringLiteral(assets::contentTypeFor(fs::path(e.urlPath).extension().string())) << ", "
+                << cStringLiteral(assets::contentETag(e.body)) << ", "
+                << (assets::isImmutablePath(e.urlPath) ? "true" : "false") << ",\n     "
+                << arrayRef(id + "_body", e.body) << ", "
+                << arrayRef(id + "_gz", e.gzip) << ", "
+                << arrayRef(id + "_br", e.brotli) << "},\n";
+        }
+        out << "};\n\n} // namespace\n\n"
+            << "std::span<const EmbeddedAsset> embeddedAssets() {\n    return ASSETS;\n}\n\n";
+    }
+    out << "} // namespace photon\n";
+
+    fs::create_directories(output.parent_path(), ec);
+    std::ofstream file(output, std::ios::binary);
+    file << out.str();
+    if (!file) {
+        std::cerr << "photon_embed: failed to write " << output << "\n";
+        return 1;
+    }
+
+    std::printf("photon_embed: %zu assets, %zu KB raw, %zu KB served compressed\n",
+                entries.size(), rawBytes / 1024, servedBytes / 1024);
+    return 0;
+}